@@ -36,6 +36,7 @@
 #include "core/function/gpg/GpgAdvancedOperator.h"
 #include "core/function/gpg/GpgContext.h"
 #include "core/function/gpg/GpgKeyGetter.h"
+#include "core/function/gpg/GpgKeyMetadataStore.h"
 #include "core/module/ModuleManager.h"
 #include "core/thread/Task.h"
 #include "core/thread/TaskRunnerGetter.h"
@@ -322,6 +323,9 @@ void InitGpgFrontendCore(CoreInitArgs args) {
             settings.value("gnupg/use_pinentry_as_password_input_dialog", true)
                 .toBool();
 
+        auto context_pool_size =
+            settings.value("gnupg/context_pool_size", 4).toInt();
+
         GF_CORE_LOG_DEBUG("core loaded if use custom key databse path: {}",
                           use_custom_key_database_path);
         GF_CORE_LOG_DEBUG("core loaded custom key databse path: {}",
@@ -384,6 +388,7 @@ void InitGpgFrontendCore(CoreInitArgs args) {
                 args.offline_mode = forbid_all_gnupg_connection;
                 args.auto_import_missing_key = auto_import_missing_key;
                 args.use_pinentry = use_pinentry_as_password_input_dialog;
+                args.context_pool_size = context_pool_size;
 
                 return ConvertToChannelObjectPtr<>(
                     SecureCreateUniqueObject<GpgContext>(
@@ -400,8 +405,13 @@ void InitGpgFrontendCore(CoreInitArgs args) {
           Module::UpsertRTValue("core", "env.state.ctx", 1);
         }
 
+        // with valid stored key metadata the ui shows up at once and the
+        // keys are listed afterwards
+        bool defer_key_listing = false;
         if (args.load_default_gpg_context) {
-          if (!GpgKeyGetter::GetInstance().FlushKeyCache()) {
+          defer_key_listing = GpgKeyMetadataStore::GetInstance().IsValid();
+          if (!defer_key_listing &&
+              !GpgKeyGetter::GetInstance().FlushKeyCache()) {
             CoreSignalStation::GetInstance()->SignalBadGnupgEnv(
                 QCoreApplication::tr("Gpg Key Detabase initiation failed"));
           };
@@ -412,6 +422,16 @@ void InitGpgFrontendCore(CoreInitArgs args) {
         Module::UpsertRTValue("core", "env.state.basic", 1);
         CoreSignalStation::GetInstance()->SignalGoodGnupgEnv();
 
+        if (defer_key_listing) {
+          // the stored rows must not outlive a listing which failed
+          if (!GpgKeyGetter::GetInstance().FlushKeyCache()) {
+            GpgKeyMetadataStore::GetInstance().Remove();
+            CoreSignalStation::GetInstance()->SignalBadGnupgEnv(
+                QCoreApplication::tr("Gpg Key Detabase initiation failed"));
+          }
+          CoreSignalStation::GetInstance()->SignalKeyDatabaseLoaded();
+        }
+
         // if gnupg-info-gathering module activated
         if (args.gather_external_gnupg_info &&
             Module::IsModuleAcivate("com.bktus.gpgfrontend.module."
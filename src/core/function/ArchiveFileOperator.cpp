@@ -32,6 +32,12 @@
 #include <archive_entry.h>
 #include <sys/fcntl.h>
 
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include "core/function/GlobalSettingStation.h"
 #include "core/utils/AsyncUtils.h"
 
 namespace GpgFrontend {
@@ -61,15 +67,23 @@ auto CopyData(struct archive *ar, struct archive *aw) -> int {
 
 struct ArchiveReadClientData {
   GFDataExchanger *ex;
-  std::array<std::byte, 1024> buf;
-  const std::byte *p_buf = buf.data();
+  std::vector<std::byte> buf;    ///< sized by gnupg/archive_read_buffer_size
+  Thread::Task *task = nullptr;  ///< receives the progress, if set
+  qint64 processed = 0;          ///<
 };
 
 auto ArchiveReadCallback(struct archive *, void *client_data,
                          const void **buffer) -> ssize_t {
   auto *rdata = static_cast<ArchiveReadClientData *>(client_data);
-  *buffer = reinterpret_cast<const void *>(rdata->p_buf);
-  return rdata->ex->Read(rdata->buf.data(), rdata->buf.size());
+  *buffer = reinterpret_cast<const void *>(rdata->buf.data());
+  auto ret = rdata->ex->Read(rdata->buf.data(), rdata->buf.size());
+
+  // the size of the archive is unknown while it is streamed
+  if (ret > 0 && rdata->task != nullptr) {
+    rdata->processed += ret;
+    rdata->task->ReportProgress(rdata->processed, 0);
+  }
+  return ret;
 }
 
 auto ArchiveWriteCallback(struct archive *, void *client_data,
@@ -84,208 +98,833 @@ auto ArchiveCloseWriteCallback(struct archive *, void *client_data) -> int {
   return 0;
 }
 
-void ArchiveFileOperator::NewArchive2DataExchanger(
-    const QString &target_directory, std::shared_ptr<GFDataExchanger> exchanger,
-    const OperationCallback &cb) {
-  RunIOOperaAsync(
-      [=](const DataObjectPtr &data_object) -> GFError {
-        auto ret = 0;
-        const auto base_path = QDir(QDir(target_directory).absolutePath());
+void AddArchiveFilter(struct archive *archive,
+                      ArchiveFileOperator::ArchiveFilter filter, int level) {
+  auto r = ARCHIVE_OK;
+  switch (filter) {
+    case ArchiveFileOperator::kArchiveFilter_Zstd:
+      r = archive_write_add_filter_zstd(archive);
+      break;
+    case ArchiveFileOperator::kArchiveFilter_Lz4:
+      r = archive_write_add_filter_lz4(archive);
+      break;
+    default:
+      archive_write_add_filter_none(archive);
+      return;
+  }
 
-        auto *archive = archive_write_new();
-        archive_write_add_filter_none(archive);
-        archive_write_set_format_pax_restricted(archive);
-        archive_write_set_format_option(archive, "pax", "hdrcharset", "BINARY");
+  // libarchive may lack the filter, an uncompressed archive still works
+  if (r < ARCHIVE_WARN) {
+    GF_CORE_LOG_WARN("archive filter {} unavailable, use none, reason: {}",
+                     static_cast<int>(filter), archive_error_string(archive));
+    archive_write_add_filter_none(archive);
+    return;
+  }
+
+  // built without the library, libarchive pipes through the external
+  // program instead, which works as long as it is installed
+  if (r == ARCHIVE_WARN) {
+    GF_CORE_LOG_WARN("archive filter {} runs an external program, reason: {}",
+                     static_cast<int>(filter), archive_error_string(archive));
+  }
+
+  if (level <= 0) return;
+  r = archive_write_set_filter_option(archive, nullptr, "compression-level",
+                                      QString::number(level).toLatin1());
+  if (r < ARCHIVE_WARN) {
+    GF_CORE_LOG_WARN("cannot set archive compression level {}, reason: {}",
+                     level, archive_error_string(archive));
+  }
+}
+
+auto RegisterExchangerCancelHook(Thread::Task *task,
+                                 const std::shared_ptr<GFDataExchanger> &ex)
+    -> int {
+  if (task == nullptr) return -1;
+  return task->AddCancelHook([ex]() { ex->Close(); });
+}
+
+void RemoveExtractedPaths(const std::vector<QString> &paths) {
+  // children were created after their parents, remove them first
+  for (auto it = paths.rbegin(); it != paths.rend(); ++it) {
+    const auto info = QFileInfo(*it);
+    if (info.isDir() && !info.isSymLink()) {
+      // keeps directories which are not empty
+      QDir().rmdir(*it);
+    } else {
+      QFile::remove(*it);
+    }
+  }
+  GF_CORE_LOG_INFO("task cancelled, removed extracted paths: {}",
+                   paths.size());
+}
+
+constexpr qint64 kArchiveReadBlockSize = 1024 * 1024;
+constexpr qint64 kArchivePrefetchFileLimit = 4 * 1024 * 1024;
+constexpr size_t kArchivePendingEntries = 4096;
+
+/**
+ * @brief an entry of a new archive, with the content of the file if it is
+ * small enough to be read ahead
+ *
+ */
+struct ArchivePrefetchEntry {
+  struct archive_entry *entry;  ///<
+  QString source_path;          ///<
+  bool ready = false;           ///< the prefetch worker is done with it
+  bool skip = false;            ///< the file cannot be opened
+  bool prefetched = false;      ///< data holds the whole file
+  qint64 budget = 0;            ///< bytes taken from the memory budget
+  QByteArray data;              ///<
+};
+
+/**
+ * @brief entries shared by the directory walker, the prefetch workers and
+ * the archive writer
+ *
+ * The workers claim the entries and take their share of the memory budget
+ * in the order of the walk, so the entry the writer waits for is never
+ * starved by the ones behind it.
+ */
+class ArchivePrefetchQueue {
+ public:
+  qint64 budget = 0;  ///< bytes of file content held in memory at most
+
+  ~ArchivePrefetchQueue() {
+    for (auto &item : entries_) archive_entry_free(item.entry);
+  }
+
+  /**
+   * @brief called by the walker, blocks while too many entries are pending
+   *
+   * @return false if the queue was aborted and the entry freed
+   */
+  auto Push(struct archive_entry *entry, QString source_path) -> bool {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&]() {
+      return aborted_ || entries_.size() < kArchivePendingEntries;
+    });
+    if (aborted_) {
+      archive_entry_free(entry);
+      return false;
+    }
+    entries_.push_back({entry, std::move(source_path)});
+    cv_.notify_all();
+    return true;
+  }
+
+  void FinishWalk(bool failed) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    walked_ = true;
+    walk_failed_ = failed;
+    cv_.notify_all();
+  }
+
+  /**
+   * @brief called by a worker, returns the next entry to read ahead and its
+   * index, or nullptr if there is nothing left
+   */
+  auto Claim(size_t &index) -> ArchivePrefetchEntry * {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&]() {
+      return aborted_ || walked_ || claimed_ < base_ + entries_.size();
+    });
+    if (aborted_ || claimed_ >= base_ + entries_.size()) return nullptr;
+    index = claimed_++;
+    return &entries_[index - base_];
+  }
+
+  /**
+   * @brief called by a worker, blocks until the entry of the index may hold
+   * size bytes in memory. One entry is always allowed, whatever its size.
+   */
+  auto Acquire(size_t index, qint64 size) -> bool {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&]() {
+      return aborted_ || (budgeted_ == index &&
+                          (used_ == 0 || used_ + size <= budget));
+    });
+    if (aborted_) return false;
+    budgeted_++;
+    used_ += size;
+    cv_.notify_all();
+    return true;
+  }
+
+  void MarkReady(ArchivePrefetchEntry *item) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    item->ready = true;
+    cv_.notify_all();
+  }
+
+  /**
+   * @brief called by the writer, returns the first entry once it is ready,
+   * or nullptr when all entries were written or the queue was aborted
+   */
+  auto WaitFront() -> ArchivePrefetchEntry * {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&]() {
+      return aborted_ || (!entries_.empty() && entries_.front().ready) ||
+             (walked_ && entries_.empty());
+    });
+    if (aborted_ || entries_.empty()) return nullptr;
+    return &entries_.front();
+  }
+
+  void PopFront() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &item = entries_.front();
+    used_ -= item.budget;
+    archive_entry_free(item.entry);
+    entries_.pop_front();
+    base_++;
+    cv_.notify_all();
+  }
+
+  void Abort() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    aborted_ = true;
+    cv_.notify_all();
+  }
+
+  auto IsAborted() -> bool {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return aborted_;
+  }
+
+  auto IsWalkFailed() -> bool {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return walk_failed_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<ArchivePrefetchEntry> entries_;  ///< references stay valid
+  size_t base_ = 0;                           ///< index of the front entry
+  size_t claimed_ = 0;                        ///< next entry to read ahead
+  size_t budgeted_ = 0;                       ///< next entry to take budget
+  qint64 used_ = 0;                           ///<
+  bool walked_ = false;                       ///<
+  bool walk_failed_ = false;                  ///<
+  bool aborted_ = false;                      ///<
+};
+
+void AdviseWillNeed(QFile &file, qint64 length) {
+#if defined(LINUX) || defined(FREEBSD)
+  posix_fadvise(file.handle(), 0, length, POSIX_FADV_SEQUENTIAL);
+  posix_fadvise(file.handle(), 0, length, POSIX_FADV_WILLNEED);
+#else
+  Q_UNUSED(file);
+  Q_UNUSED(length);
+#endif
+}
 
-        archive_write_open(archive, exchanger.get(), nullptr,
-                           ArchiveWriteCallback, ArchiveCloseWriteCallback);
+void WalkArchiveDirectory(ArchivePrefetchQueue &queue,
+                          const QString &target_directory) {
+  const auto base_path = QDir(QDir(target_directory).absolutePath());
 
-        auto *disk = archive_read_disk_new();
-        archive_read_disk_set_standard_lookup(disk);
+  auto *disk = archive_read_disk_new();
+  archive_read_disk_set_standard_lookup(disk);
 
 #ifdef WINDOWS
-        auto target_directory_utf16_wstr = std::wstring(
-            reinterpret_cast<const wchar_t *>((target_directory).utf16()));
-        auto r =
-            archive_read_disk_open_w(disk, target_directory_utf16_wstr.c_str());
+  auto target_directory_utf16_wstr = std::wstring(
+      reinterpret_cast<const wchar_t *>((target_directory).utf16()));
+  auto r = archive_read_disk_open_w(disk, target_directory_utf16_wstr.c_str());
 #else
-        auto r = archive_read_disk_open(disk, target_directory.toUtf8());
+  auto r = archive_read_disk_open(disk, target_directory.toUtf8());
 #endif
 
-        if (r != ARCHIVE_OK) {
-          GF_CORE_LOG_ERROR("archive_read_disk_open() failed: {}, abort...",
-                            archive_error_string(disk));
-          archive_read_free(disk);
-          archive_write_free(archive);
-          return -1;
-        }
+  if (r != ARCHIVE_OK) {
+    GF_CORE_LOG_ERROR("archive_read_disk_open() failed: {}, abort...",
+                      archive_error_string(disk));
+    archive_read_free(disk);
+    queue.FinishWalk(true);
+    return;
+  }
 
-        for (;;) {
-          auto *entry = archive_entry_new();
-          r = archive_read_next_header2(disk, entry);
-          if (r == ARCHIVE_EOF) break;
-          if (r != ARCHIVE_OK) {
-            GF_CORE_LOG_ERROR(
-                "archive_read_next_header2() failed, ret: {}, explain: {}", r,
-                archive_error_string(disk));
-            ret = -1;
-            break;
-          }
+  auto failed = false;
+  for (;;) {
+    auto *entry = archive_entry_new();
+    r = archive_read_next_header2(disk, entry);
+    if (r != ARCHIVE_OK) {
+      archive_entry_free(entry);
+      if (r == ARCHIVE_EOF) break;
+      GF_CORE_LOG_ERROR(
+          "archive_read_next_header2() failed, ret: {}, explain: {}", r,
+          archive_error_string(disk));
+      failed = true;
+      break;
+    }
 
-          archive_read_disk_descend(disk);
+    archive_read_disk_descend(disk);
+
+    // directories cannot be opened as files, they were never archived
+    if (archive_entry_filetype(entry) == AE_IFDIR) {
+      archive_entry_free(entry);
+      continue;
+    }
 
 #ifdef WINDOWS
-          auto source_path =
-              QString::fromUtf16(reinterpret_cast<const char16_t *>(
-                  archive_entry_pathname_w(entry)));
+    auto source_path = QString::fromUtf16(
+        reinterpret_cast<const char16_t *>(archive_entry_pathname_w(entry)));
 #else
-          auto source_path = QString::fromUtf8(archive_entry_pathname(entry));
+    auto source_path = QString::fromUtf8(archive_entry_pathname(entry));
 #endif
 
-          QFile file(source_path);
-#ifdef QT5_BUILD
-          if (file.open(QIODevice::ReadOnly)) {
+    // turn absolute path to relative path
+    auto relativ_path_name = base_path.relativeFilePath(source_path);
+    archive_entry_set_pathname(entry, relativ_path_name.toUtf8());
+
+#ifdef WINDOWS
+    auto source_path_utf16_wstr =
+        std::wstring(reinterpret_cast<const wchar_t *>(source_path.utf16()));
+    archive_entry_copy_sourcepath_w(entry, source_path_utf16_wstr.c_str());
 #else
-          if (file.open(QIODeviceBase::ReadOnly)) {
+    archive_entry_copy_sourcepath(entry, source_path.toUtf8());
 #endif
-            // turn absolute path to relative path
-            auto relativ_path_name = base_path.relativeFilePath(source_path);
-            archive_entry_set_pathname(entry, relativ_path_name.toUtf8());
+
+    if (!queue.Push(entry, source_path)) break;
+  }
+
+  archive_read_free(disk);
+  queue.FinishWalk(failed);
+}
+
+void PrefetchArchiveEntries(ArchivePrefetchQueue &queue) {
+  size_t index = 0;
+  while (auto *item = queue.Claim(index)) {
+    QFile file(item->source_path);
+    const auto opened = file.open(QIODevice::ReadOnly);
+    const auto size = opened ? file.size() : 0;
+    const auto prefetch = opened &&
+                          archive_entry_filetype(item->entry) == AE_IFREG &&
+                          size <= kArchivePrefetchFileLimit;
+
+    if (!queue.Acquire(index, prefetch ? size : 0)) return;
+
+    // large files are left to the writer, the kernel reads them meanwhile
+    if (opened) {
+      AdviseWillNeed(file, prefetch ? 0 : kArchivePrefetchFileLimit);
+    }
+    if (prefetch) item->data = file.readAll();
+
+    item->skip = !opened;
+    item->prefetched = prefetch;
+    item->budget = prefetch ? size : 0;
+    queue.MarkReady(item);
+  }
+}
+
+constexpr qint64 kArchiveWriteBehindFileLimit = 4 * 1024 * 1024;
+
+/**
+ * @brief writes small files of an archive to disk on a pool of threads, so
+ * the reader of the archive does not wait for the file system
+ *
+ * Each path is always written by the same worker, in the order it was
+ * submitted. The data waiting to be written is bounded by the budget.
+ */
+class ArchiveWriteBehind {
+ public:
+  ArchiveWriteBehind(int workers, qint64 budget)
+      : budget_(budget), queues_(workers) {
+    for (int i = 0; i < workers; i++) {
+      threads_.emplace_back(QThread::create([this, i]() { work(i); }));
+      threads_.back()->start();
+    }
+  }
+
+  ~ArchiveWriteBehind() { Stop(true); }
+
+  /**
+   * @brief takes the ownership of the entry, blocks while the budget is
+   * exhausted
+   *
+   * @return false if the pool was aborted and the entry freed
+   */
+  auto Submit(struct archive_entry *entry, QByteArray data) -> bool {
+    const auto worker =
+        qHash(QByteArray(archive_entry_pathname(entry))) % queues_.size();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&]() {
+      return aborted_ || used_ == 0 || used_ + data.size() <= budget_;
+    });
+    if (aborted_) {
+      archive_entry_free(entry);
+      return false;
+    }
+    used_ += data.size();
+    pending_++;
+    queues_[worker].push_back({entry, std::move(data)});
+    cv_.notify_all();
+    return true;
+  }
+
+  /**
+   * @brief blocks until every submitted entry is on disk
+   */
+  void Drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&]() { return aborted_ || pending_ == 0; });
+  }
+
+  /**
+   * @brief drops the entries which are not written yet
+   */
+  void Abort() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    aborted_ = true;
+    cv_.notify_all();
+  }
+
+  /**
+   * @brief whether a worker could not write an entry, the pool is aborted
+   * then
+   */
+  auto IsFailed() -> bool {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return failed_;
+  }
+
+  /**
+   * @brief stops and joins the workers, the pending entries are written
+   * unless discard is set
+   */
+  void Stop(bool discard) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+      if (discard) aborted_ = true;
+      cv_.notify_all();
+    }
+    for (auto &thread : threads_) thread->wait();
+    threads_.clear();
+
+    for (auto &queue : queues_) {
+      for (auto &job : queue) archive_entry_free(job.entry);
+      queue.clear();
+    }
+  }
+
+ private:
+  struct Job {
+    struct archive_entry *entry = nullptr;  ///<
+    QByteArray data;                        ///<
+  };
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  qint64 budget_;                                  ///<
+  qint64 used_ = 0;                                ///<
+  size_t pending_ = 0;                             ///<
+  bool stopped_ = false;                           ///<
+  bool aborted_ = false;                           ///<
+  bool failed_ = false;                            ///<
+  std::vector<std::deque<Job>> queues_;            ///< one per worker
+  std::vector<std::unique_ptr<QThread>> threads_;  ///<
+
+  void work(int id) {
+    auto *ext = archive_write_disk_new();
+    archive_write_disk_set_options(ext, 0);
+
+    auto &queue = queues_[id];
+    for (;;) {
+      Job job;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock,
+                 [&]() { return aborted_ || stopped_ || !queue.empty(); });
+        if (aborted_ || queue.empty()) break;
+        job = std::move(queue.front());
+        queue.pop_front();
+      }
+
+      auto failed = false;
+      auto r = archive_write_header(ext, job.entry);
+      if (r < ARCHIVE_WARN) {
+        GF_CORE_LOG_ERROR("archive_write_header(), ret: {}, reason: {}", r,
+                          archive_error_string(ext));
+        failed = true;
+      } else if (archive_write_data(ext, job.data.constData(),
+                                    job.data.size()) < 0) {
+        GF_CORE_LOG_ERROR("archive_write_data(), reason: {}",
+                          archive_error_string(ext));
+        failed = true;
+      }
+      if (archive_write_finish_entry(ext) < ARCHIVE_WARN) failed = true;
+      archive_entry_free(job.entry);
+
+      // the reader stops at the next entry it submits
+      std::lock_guard<std::mutex> lock(mutex_);
+      used_ -= job.data.size();
+      pending_--;
+      if (failed) failed_ = aborted_ = true;
+      cv_.notify_all();
+    }
+
+    archive_write_free(ext);
+  }
+};
+
+/**
+ * @brief reads the data of the current entry as a whole
+ */
+auto ReadArchiveEntryData(struct archive *archive, qint64 size,
+                          QByteArray &data) -> bool {
+  data = QByteArray(size, Qt::Uninitialized);
+  qint64 offset = 0;
+  while (offset < size) {
+    auto n = archive_read_data(archive, data.data() + offset, size - offset);
+    if (n < 0) {
+      GF_CORE_LOG_ERROR("archive_read_data() failed: {}",
+                        archive_error_string(archive));
+      return false;
+    }
+    if (n == 0) break;
+    offset += n;
+  }
+  data.truncate(offset);
+  return true;
+}
+
+/**
+ * @brief read what is left of the stream, the archive may end before it
+ */
+void DrainExchanger(GFDataExchanger *ex) {
+  std::array<std::byte, 64 * 1024> buffer{};
+  while (ex->Read(buffer.data(), buffer.size()) > 0) {
+  }
+}
+
+/**
+ * @brief extract the archive read from the exchanger into the target path
+ *
+ * @return GFError ARCHIVE_OK, or the libarchive error which stopped it
+ */
+auto ExtractArchive(GFDataExchanger *ex, Thread::Task *task,
+                    const QString &target_path,
+                    std::vector<QString> &created_paths) -> GFError {
+  using ArchiveReadPtr =
+      std::unique_ptr<struct archive, decltype(&archive_read_free)>;
+  using ArchiveWritePtr =
+      std::unique_ptr<struct archive, decltype(&archive_write_free)>;
+
+  auto archive_holder = ArchiveReadPtr(archive_read_new(), archive_read_free);
+  auto ext_holder =
+      ArchiveWritePtr(archive_write_disk_new(), archive_write_free);
+  auto *archive = archive_holder.get();
+  auto *ext = ext_holder.get();
+
+  auto r = archive_read_support_filter_all(archive);
+  if (r != ARCHIVE_OK) {
+    GF_CORE_LOG_ERROR("archive_read_support_filter_all(), ret: {}, reason: {}",
+                      r, archive_error_string(archive));
+    return r;
+  }
+
+  r = archive_read_support_format_all(archive);
+  if (r != ARCHIVE_OK) {
+    GF_CORE_LOG_ERROR("archive_read_support_format_all(), ret: {}, reason: {}",
+                      r, archive_error_string(archive));
+    return r;
+  }
+
+  auto settings = GlobalSettingStation::GetInstance().GetSettings();
+  const auto buffer_size = std::max(
+      4, settings.value("gnupg/archive_read_buffer_size", 256).toInt());
+  const auto workers =
+      std::max(0, settings.value("gnupg/archive_extract_workers", 4).toInt());
+  const auto budget =
+      std::max(1, settings.value("gnupg/archive_extract_budget", 64).toInt()) *
+      qint64{1024 * 1024};
+
+  auto rdata = ArchiveReadClientData{};
+  rdata.ex = ex;
+  rdata.buf.resize(static_cast<size_t>(buffer_size) * 1024);
+  rdata.task = task;
+
+  r = archive_read_open(archive, &rdata, nullptr, ArchiveReadCallback,
+                        nullptr);
+  if (r != ARCHIVE_OK) {
+    GF_CORE_LOG_ERROR("archive_read_open(), ret: {}, reason: {}", r,
+                      archive_error_string(archive));
+    return r;
+  }
+
+  r = archive_write_disk_set_options(ext, 0);
+  if (r != ARCHIVE_OK) {
+    GF_CORE_LOG_ERROR("archive_write_disk_set_options(), ret: {}, reason: {}",
+                      r, archive_error_string(ext));
+    return r;
+  }
+
+  // small files are written by the pool, the others on this thread
+  std::unique_ptr<ArchiveWriteBehind> write_behind;
+  if (workers > 0) {
+    write_behind = std::make_unique<ArchiveWriteBehind>(workers, budget);
+  }
+
+  const auto pool_hook_id =
+      task == nullptr || write_behind == nullptr
+          ? -1
+          : task->AddCancelHook([&write_behind]() { write_behind->Abort(); });
+
+  GFError ret = ARCHIVE_OK;
+  for (;;) {
+    if (task != nullptr && task->IsCancelled()) break;
+
+    struct archive_entry *entry;
+    r = archive_read_next_header(archive, &entry);
+    if (r == ARCHIVE_EOF) break;
+    if (r != ARCHIVE_OK) {
+      GF_CORE_LOG_ERROR("archive_read_next_header(), ret: {}, reason: {}", r,
+                        archive_error_string(archive));
+      ret = r;
+      break;
+    }
+
+    auto path_name = QString::fromUtf8(archive_entry_pathname(entry));
+    auto target_path_name = target_path + "/" + path_name;
+    if (!QFileInfo::exists(target_path_name)) {
+      created_paths.push_back(target_path_name);
+    }
 
 #ifdef WINDOWS
-            auto source_path_utf16_wstr = std::wstring(
-                reinterpret_cast<const wchar_t *>(source_path.utf16()));
-            archive_entry_copy_sourcepath_w(entry,
-                                            source_path_utf16_wstr.c_str());
+    auto target_path_utf16_wstr = std::wstring(
+        reinterpret_cast<const wchar_t *>((target_path_name).utf16()));
+    archive_entry_copy_pathname_w(entry, target_path_utf16_wstr.c_str());
 #else
 
-            archive_entry_copy_sourcepath(entry, source_path.toUtf8());
+    archive_entry_set_pathname(entry, target_path_name.toUtf8());
 #endif
 
-            r = archive_write_header(archive, entry);
-            if (r < ARCHIVE_OK) {
-              GF_CORE_LOG_ERROR(
-                  "archive_write_header() failed, ret: {}, explain: {} ", r,
-                  archive_error_string(archive));
-              continue;
-            }
+    if (write_behind != nullptr && archive_entry_filetype(entry) == AE_IFREG &&
+        archive_entry_hardlink(entry) == nullptr &&
+        archive_entry_size_is_set(entry) != 0 &&
+        archive_entry_size(entry) <= kArchiveWriteBehindFileLimit) {
+      QByteArray data;
+      if (!ReadArchiveEntryData(archive, archive_entry_size(entry), data) ||
+          !write_behind->Submit(archive_entry_clone(entry), std::move(data))) {
+        ret = ARCHIVE_FATAL;
+        break;
+      }
+      continue;
+    }
 
-            if (r == ARCHIVE_FATAL) {
-              GF_CORE_LOG_ERROR(
-                  "archive_write_header() failed, ret: {}, explain: {}, "
-                  "abort ...",
-                  r, archive_error_string(archive));
-              ret = -1;
-              break;
-            }
+    // a hard link needs its target on disk
+    if (write_behind != nullptr && archive_entry_hardlink(entry) != nullptr) {
+      write_behind->Drain();
+    }
 
-            if (r > ARCHIVE_FAILED) {
-              auto buffer = file.read(1024);
-              while (!buffer.isEmpty()) {
-                archive_write_data(archive, buffer.data(), buffer.size());
-                buffer = file.read(1024);
-              }
-            }
-          }
-          archive_write_finish_entry(archive);
-          archive_entry_free(entry);
-        }
+    // a warning, e.g. about the owner, still leaves the file on disk
+    r = archive_write_header(ext, entry);
+    if (r < ARCHIVE_WARN) {
+      GF_CORE_LOG_ERROR("archive_write_header(), ret: {}, reason: {}", r,
+                        archive_error_string(ext));
+      ret = r;
+      break;
+    }
+    r = CopyData(archive, ext);
+    if (r != ARCHIVE_OK) {
+      ret = r;
+      break;
+    }
+  }
 
-        archive_read_free(disk);
-        archive_write_free(archive);
-        return ret;
-      },
-      cb, "archive_write_new");
+  // the pool must be done before the directories get their final
+  // permissions and times
+  if (write_behind != nullptr) {
+    if (task != nullptr) task->RemoveCancelHook(pool_hook_id);
+    write_behind->Stop(task != nullptr && task->IsCancelled());
+    if (ret == ARCHIVE_OK && write_behind->IsFailed()) ret = ARCHIVE_FATAL;
+  }
+
+  r = archive_write_close(ext);
+  if (r != ARCHIVE_OK) {
+    GF_CORE_LOG_ERROR("archive_write_close(), ret: {}, reason: {}", r,
+                      archive_error_string(ext));
+    if (ret == ARCHIVE_OK) ret = r;
+  }
+  return ret;
 }
 
-void ArchiveFileOperator::ExtractArchiveFromDataExchanger(
-    std::shared_ptr<GFDataExchanger> ex, const QString &target_path,
-    const OperationCallback &cb) {
-  GF_CORE_LOG_INFO("target path: {}", target_path);
-  RunIOOperaAsync(
-      [=](const DataObjectPtr &data_object) -> GFError {
-        auto *archive = archive_read_new();
-        auto *ext = archive_write_disk_new();
+auto ArchiveFileOperator::GetArchiveFilter()
+    -> std::tuple<ArchiveFilter, int> {
+  auto settings = GlobalSettingStation::GetInstance().GetSettings();
+  const auto name =
+      settings.value("gnupg/archive_filter", "none").toString().toLower();
+  const auto level = settings.value("gnupg/archive_filter_level", 0).toInt();
 
-        auto r = archive_read_support_filter_all(archive);
-        if (r != ARCHIVE_OK) {
-          GF_CORE_LOG_ERROR(
-              "archive_read_support_filter_all(), ret: {}, reason: {}", r,
-              archive_error_string(archive));
-          return r;
-        }
+  if (name == "zstd") return {kArchiveFilter_Zstd, level};
+  if (name == "lz4") return {kArchiveFilter_Lz4, level};
+  return {kArchiveFilter_None, 0};
+}
 
-        r = archive_read_support_format_all(archive);
-        if (r != ARCHIVE_OK) {
-          GF_CORE_LOG_ERROR(
-              "archive_read_support_format_all(), ret: {}, reason: {}", r,
-              archive_error_string(archive));
-          return r;
-        }
+auto ArchiveFileOperator::NewArchive2DataExchanger(
+    const QString &target_directory, std::shared_ptr<GFDataExchanger> exchanger,
+    const OperationCallback &cb, ArchiveFilter filter, int level)
+    -> Thread::Task::TaskHandler {
+  return RunIOOperaAsync(
+      [=](const DataObjectPtr &data_object) -> GFError {
+        auto ret = 0;
 
-        auto rdata = ArchiveReadClientData{};
-        rdata.ex = ex.get();
+        auto *task = Thread::Task::Current();
+        const auto total = task != nullptr ? GetDirectorySize(target_directory)
+                                           : qint64{0};
+        qint64 processed = 0;
+
+        auto settings = GlobalSettingStation::GetInstance().GetSettings();
+        ArchivePrefetchQueue queue;
+        queue.budget =
+            std::max(1, settings.value("gnupg/archive_prefetch_budget", 64)
+                            .toInt()) *
+            qint64{1024 * 1024};
+        const auto workers = std::max(
+            1, settings.value("gnupg/archive_prefetch_workers", 4).toInt());
+
+        // abort both sides, the reader must not take a truncated archive
+        // for a complete one
+        const auto hook_id = RegisterExchangerCancelHook(task, exchanger);
+        const auto queue_hook_id =
+            task == nullptr ? -1 : task->AddCancelHook([&queue]() {
+              queue.Abort();
+            });
 
-        r = archive_read_open(archive, &rdata, nullptr, ArchiveReadCallback,
-                              nullptr);
+        auto *archive = archive_write_new();
+        AddArchiveFilter(archive, filter, level);
+        archive_write_set_format_pax_restricted(archive);
+        archive_write_set_format_option(archive, "pax", "hdrcharset", "BINARY");
 
+        auto r = archive_write_open(archive, exchanger.get(), nullptr,
+                                    ArchiveWriteCallback,
+                                    ArchiveCloseWriteCallback);
         if (r != ARCHIVE_OK) {
-          GF_CORE_LOG_ERROR("archive_read_open(), ret: {}, reason: {}", r,
+          GF_CORE_LOG_ERROR("archive_write_open(), ret: {}, reason: {}", r,
                             archive_error_string(archive));
-          return r;
+          // e.g. the external program of the filter could not be started
+          exchanger->Close();
+          archive_write_free(archive);
+          if (task != nullptr) {
+            task->RemoveCancelHook(queue_hook_id);
+            task->RemoveCancelHook(hook_id);
+          }
+          return -1;
         }
 
-        r = archive_write_disk_set_options(ext, 0);
-        if (r != ARCHIVE_OK) {
-          GF_CORE_LOG_ERROR(
-              "archive_write_disk_set_options(), ret: {}, reason: {}", r,
-              archive_error_string(archive));
-          return r;
+        // the tree is walked and the files are read ahead on other threads,
+        // this thread only writes the entries in the order of the walk
+        std::vector<std::unique_ptr<QThread>> threads;
+        threads.emplace_back(QThread::create(
+            [&]() { WalkArchiveDirectory(queue, target_directory); }));
+        for (int i = 0; i < workers; i++) {
+          threads.emplace_back(
+              QThread::create([&]() { PrefetchArchiveEntries(queue); }));
         }
+        for (auto &thread : threads) thread->start();
 
         for (;;) {
-          struct archive_entry *entry;
-          r = archive_read_next_header(archive, &entry);
-          if (r == ARCHIVE_EOF) break;
-          if (r != ARCHIVE_OK) {
-            GF_CORE_LOG_ERROR("archive_read_next_header(), ret: {}, reason: {}",
-                              r, archive_error_string(archive));
+          auto *item = queue.WaitFront();
+          if (item == nullptr) break;
+
+          r = item->skip ? ARCHIVE_FAILED
+                         : archive_write_header(archive, item->entry);
+          if (r == ARCHIVE_FATAL) {
+            GF_CORE_LOG_ERROR(
+                "archive_write_header() failed, ret: {}, explain: {}, "
+                "abort ...",
+                r, archive_error_string(archive));
+            ret = -1;
             break;
           }
 
-          auto path_name = QString::fromUtf8(archive_entry_pathname(entry));
-          auto target_path_name = target_path + "/" + path_name;
-
-#ifdef WINDOWS
-          auto target_path_utf16_wstr = std::wstring(
-              reinterpret_cast<const wchar_t *>((target_path_name).utf16()));
-          archive_entry_copy_pathname_w(entry, target_path_utf16_wstr.c_str());
-#else
-
-          archive_entry_set_pathname(entry, target_path_name.toUtf8());
-#endif
+          if (!item->skip && r < ARCHIVE_OK) {
+            GF_CORE_LOG_ERROR(
+                "archive_write_header() failed, ret: {}, explain: {} ", r,
+                archive_error_string(archive));
+          }
 
-          r = archive_write_header(ext, entry);
-          if (r != ARCHIVE_OK) {
-            GF_CORE_LOG_ERROR("archive_write_header(), ret: {}, reason: {}", r,
-                              archive_error_string(archive));
-          } else {
-            r = CopyData(archive, ext);
+          if (r > ARCHIVE_FAILED) {
+            auto write = [&](const QByteArray &buffer) {
+              if (archive_write_data(archive, buffer.constData(),
+                                     buffer.size()) < 0) {
+                return false;
+              }
+              processed += buffer.size();
+              if (task != nullptr) task->ReportProgress(processed, total);
+              return true;
+            };
+
+            if (item->prefetched) {
+              if (!write(item->data)) ret = -1;
+            } else {
+              // large files are streamed, the worker only asked the kernel
+              // to read them ahead
+              QFile file(item->source_path);
+              if (file.open(QIODevice::ReadOnly)) {
+                auto buffer = file.read(kArchiveReadBlockSize);
+                while (!buffer.isEmpty() && !queue.IsAborted()) {
+                  if (!write(buffer)) {
+                    ret = -1;
+                    break;
+                  }
+                  buffer = file.read(kArchiveReadBlockSize);
+                }
+              }
+            }
+            archive_write_finish_entry(archive);
           }
+
+          queue.PopFront();
+          if (ret != 0) break;
         }
 
-        r = archive_read_free(archive);
-        if (r != ARCHIVE_OK) {
-          GF_CORE_LOG_ERROR("archive_read_free(), ret: {}, reason: {}", r,
-                            archive_error_string(archive));
+        if (queue.IsAborted() || queue.IsWalkFailed()) ret = -1;
+
+        // stops the walker and the workers if the writer gave up
+        queue.Abort();
+        for (auto &thread : threads) thread->wait();
+
+        // closing the archive would end the stream like a complete one
+        if (ret != 0) exchanger->Close();
+        archive_write_free(archive);
+        if (task != nullptr) {
+          task->RemoveCancelHook(queue_hook_id);
+          task->RemoveCancelHook(hook_id);
         }
-        r = archive_write_free(ext);
-        if (r != ARCHIVE_OK) {
-          GF_CORE_LOG_ERROR("archive_read_free(), ret: {}, reason: {}", r,
-                            archive_error_string(archive));
+        return ret;
+      },
+      cb, "archive_write_new");
+}
+
+auto ArchiveFileOperator::ExtractArchiveFromDataExchanger(
+    std::shared_ptr<GFDataExchanger> ex, const QString &target_path,
+    const OperationCallback &cb) -> Thread::Task::TaskHandler {
+  GF_CORE_LOG_INFO("target path: {}", target_path);
+  return RunIOOperaAsync(
+      [=](const DataObjectPtr &data_object) -> GFError {
+        auto *task = Thread::Task::Current();
+
+        // fail the writer and any pending read of the archive
+        const auto hook_id = RegisterExchangerCancelHook(task, ex);
+        std::vector<QString> created_paths;
+
+        auto ret = ExtractArchive(ex.get(), task, target_path, created_paths);
+
+        // the writer blocks once the exchanger is full, let it finish after
+        // the end of the archive or fail it after an error
+        if (ret == ARCHIVE_OK) {
+          DrainExchanger(ex.get());
+        } else {
+          ex->Close();
         }
 
-        return 0;
+        if (task != nullptr) {
+          task->RemoveCancelHook(hook_id);
+          if (task->IsCancelled()) RemoveExtractedPaths(created_paths);
+        }
+        return ret;
       },
       cb, "archive_read_new");
 }
@@ -30,6 +30,7 @@
 
 #include "core/GpgFrontendCore.h"
 #include "core/model/GFDataExchanger.h"
+#include "core/thread/Task.h"
 #include "core/typedef/CoreTypedef.h"
 #include "core/utils/IOUtils.h"
 
@@ -37,6 +38,21 @@ namespace GpgFrontend {
 
 class GPGFRONTEND_CORE_EXPORT ArchiveFileOperator {
  public:
+  enum ArchiveFilter {
+    kArchiveFilter_None,
+    kArchiveFilter_Zstd,
+    kArchiveFilter_Lz4,
+  };
+
+  /**
+   * @brief the compression filter for new archives and its level (0 is the
+   * default of the filter), from the settings "gnupg/archive_filter" (none,
+   * zstd or lz4) and "gnupg/archive_filter_level"
+   *
+   * @return std::tuple<ArchiveFilter, int>
+   */
+  static auto GetArchiveFilter() -> std::tuple<ArchiveFilter, int>;
+
   /**
    * @brief
    *
@@ -49,12 +65,14 @@ class GPGFRONTEND_CORE_EXPORT ArchiveFileOperator {
    *
    * @param base_path
    * @param archive_path
-   * @param compress
-   * @param files
+   * @param cb
+   * @param filter compression filter, falls back to none if unavailable
+   * @param level compression level, 0 for the default of the filter
    */
-  static void NewArchive2DataExchanger(const QString &target_directory,
-                                       std::shared_ptr<GFDataExchanger>,
-                                       const OperationCallback &cb);
+  static auto NewArchive2DataExchanger(
+      const QString &target_directory, std::shared_ptr<GFDataExchanger>,
+      const OperationCallback &cb, ArchiveFilter filter = kArchiveFilter_None,
+      int level = 0) -> Thread::Task::TaskHandler;
 
   /**
    * @brief
@@ -62,8 +80,8 @@ class GPGFRONTEND_CORE_EXPORT ArchiveFileOperator {
    * @param archive_path
    * @param base_path
    */
-  static void ExtractArchiveFromDataExchanger(
+  static auto ExtractArchiveFromDataExchanger(
       std::shared_ptr<GFDataExchanger> fd, const QString &target_path,
-      const OperationCallback &cb);
+      const OperationCallback &cb) -> Thread::Task::TaskHandler;
 };
 }  // namespace GpgFrontend
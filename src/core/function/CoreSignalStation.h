@@ -75,6 +75,20 @@ class GPGFRONTEND_CORE_EXPORT CoreSignalStation : public QObject {
    *
    */
   void SignalGoodGnupgEnv();
+
+  /**
+   * @brief the keys have been listed after the ui started with the stored
+   * key metadata, the listing failed if the key cache is still not loaded
+   *
+   */
+  void SignalKeyDatabaseLoaded();
+
+  /**
+   * @brief a gpg operation of this process finished, gpg may have updated
+   * the trustdb while running it. emitted on the thread which ran it.
+   *
+   */
+  void SignalGpgOperationFinished();
 };
 
 }  // namespace GpgFrontend
@@ -28,12 +28,44 @@
 
 #include "SecureMemoryAllocator.h"
 
+#include <array>
+#include <mutex>
+#include <vector>
+
+#include "core/utils/MemoryUtils.h"
+
 #if !defined(MACOS) && defined(DEBUG)
 #include <mimalloc.h>
 #endif
 
 namespace GpgFrontend {
 
+constexpr std::size_t kPoolMinBlockShift = 6;   ///< 64 bytes
+constexpr std::size_t kPoolMaxBlockShift = 20;  ///< 1 MB
+constexpr std::size_t kPoolClasses =
+    kPoolMaxBlockShift - kPoolMinBlockShift + 1;
+constexpr std::size_t kPoolBlocksPerClass = 32;
+constexpr std::size_t kPoolMaxBytes = 8 * 1024 * 1024;
+constexpr std::size_t kLargeBlockAlign = 4096;
+
+struct SecureBufferPoolState {
+  std::mutex lock;
+  std::array<std::vector<void*>, kPoolClasses> free_blocks;
+  std::size_t pooled_bytes = 0;
+};
+
+auto GetSecureBufferPoolState() -> SecureBufferPoolState& {
+  // never destroyed, buffers may still be released by other statics at exit
+  static auto* state = new SecureBufferPoolState();
+  return *state;
+}
+
+auto SecureBufferPoolClass(std::size_t size) -> std::size_t {
+  std::size_t index = 0;
+  while ((std::size_t{1} << (kPoolMinBlockShift + index)) < size) index++;
+  return index;
+}
+
 auto SecureMemoryAllocator::Allocate(std::size_t size) -> void* {
 #if !defined(MACOS) && defined(DEBUG)
   auto* addr = mi_malloc(size);
@@ -60,4 +92,52 @@ void SecureMemoryAllocator::Deallocate(void* p) {
 #endif
 }
 
-}  // namespace GpgFrontend
\ No newline at end of file
+auto SecureBufferPool::Acquire(std::size_t size, std::size_t& capacity)
+    -> void* {
+  if (size > (std::size_t{1} << kPoolMaxBlockShift)) {
+    // large blocks are not pooled, they come and go with the big messages
+    capacity = (size + kLargeBlockAlign - 1) / kLargeBlockAlign *
+               kLargeBlockAlign;
+    return SecureMemoryAllocator::Allocate(capacity);
+  }
+
+  const auto index = SecureBufferPoolClass(size);
+  capacity = std::size_t{1} << (kPoolMinBlockShift + index);
+
+  auto& state = GetSecureBufferPoolState();
+  {
+    std::lock_guard<std::mutex> lock(state.lock);
+    auto& blocks = state.free_blocks[index];
+    if (!blocks.empty()) {
+      auto* block = blocks.back();
+      blocks.pop_back();
+      state.pooled_bytes -= capacity;
+      return block;
+    }
+  }
+  return SecureMemoryAllocator::Allocate(capacity);
+}
+
+void SecureBufferPool::Release(void* ptr, std::size_t capacity) {
+  if (ptr == nullptr) return;
+
+  // nothing may leave this function without being wiped
+  wipememory(ptr, capacity);
+
+  if (capacity <= (std::size_t{1} << kPoolMaxBlockShift)) {
+    const auto index = SecureBufferPoolClass(capacity);
+    auto& state = GetSecureBufferPoolState();
+
+    std::lock_guard<std::mutex> lock(state.lock);
+    auto& blocks = state.free_blocks[index];
+    if (blocks.size() < kPoolBlocksPerClass &&
+        state.pooled_bytes + capacity <= kPoolMaxBytes) {
+      blocks.push_back(ptr);
+      state.pooled_bytes += capacity;
+      return;
+    }
+  }
+  SecureMemoryAllocator::Deallocate(ptr);
+}
+
+}  // namespace GpgFrontend
@@ -44,6 +44,30 @@ class GPGFRONTEND_CORE_EXPORT SecureMemoryAllocator {
   static void Deallocate(void *);
 };
 
+/**
+ * @brief size classed blocks for buffers holding plaintext, a block is
+ * wiped before it goes back to the pool or to the system
+ *
+ */
+class GPGFRONTEND_CORE_EXPORT SecureBufferPool {
+ public:
+  /**
+   * @brief get a block of at least size bytes
+   *
+   * @param size
+   * @param capacity set to the real size of the block
+   * @return void*
+   */
+  static auto Acquire(std::size_t size, std::size_t &capacity) -> void *;
+
+  /**
+   * @brief wipe the block and keep it for reuse if the pool has room
+   *
+   * @param capacity the capacity returned by Acquire
+   */
+  static void Release(void *, std::size_t capacity);
+};
+
 template <typename T>
 struct SecureObjectDeleter {
   void operator()(T *ptr) {
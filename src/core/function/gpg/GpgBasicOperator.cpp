@@ -31,18 +31,158 @@
 #include <gpg-error.h>
 
 #include "core/GpgModel.h"
+#include "core/function/GlobalSettingStation.h"
+#include "core/function/gpg/GpgKeyGetter.h"
 #include "core/model/GpgDecryptResult.h"
 #include "core/model/GpgEncryptResult.h"
 #include "core/model/GpgSignResult.h"
 #include "core/model/GpgVerifyResult.h"
+#include "core/utils/ArmorUtils.h"
 #include "core/utils/AsyncUtils.h"
 #include "core/utils/GpgUtils.h"
 
 namespace GpgFrontend {
 
+namespace {
+
+/**
+ * @brief estimate the output size of an operation to reserve memory for it,
+ * armored output is about a third larger than the binary one
+ *
+ * @param in_buffer
+ * @param ascii
+ * @return GpgDataSizeHint
+ */
+auto OutputSizeHint(const GFBuffer& in_buffer, bool ascii) -> GpgDataSizeHint {
+  // room for the packet headers and the armor lines
+  const auto size = in_buffer.Size() + 1024;
+  return {ascii ? size * 4 / 3 + size / 48 : size};
+}
+
+/**
+ * @brief whether an armored output is written binary by gpg and armored
+ * here, which halves the traffic through the gpgme pipe
+ *
+ * @param ascii
+ * @return true if "gnupg/inprocess_armor" is set
+ */
+auto InProcessArmor(bool ascii) -> bool {
+  if (!ascii) return false;
+  auto settings = GlobalSettingStation::GetInstance().GetSettings();
+  return settings.value("gnupg/inprocess_armor", false).toBool();
+}
+
+/**
+ * @brief read the output of an operation, armored if gpg wrote it binary
+ *
+ * @param data_out
+ * @param armor
+ * @param type
+ * @return GFBuffer
+ */
+auto ReadArmoredOutput(GpgData& data_out, bool armor, const QString& type)
+    -> GFBuffer {
+  auto buffer = data_out.Read2GFBuffer();
+  if (!armor || buffer.Empty()) return buffer;
+  return ArmorBuffer(buffer, type);
+}
+
+/**
+ * @brief input of a decryption, an armored message is decoded here if in
+ * process armor is on, anything else is left to gpg
+ *
+ * @param in_buffer
+ * @return GFBuffer
+ */
+auto DearmorInput(const GFBuffer& in_buffer) -> GFBuffer {
+  if (!InProcessArmor(true)) return in_buffer;
+
+  // only a message which is the whole input, gpg must see a second block
+  // or any text around it as well
+  const QByteArray begin_tag = "-----BEGIN PGP MESSAGE-----";
+  const QByteArray end_tag = "-----END PGP MESSAGE-----";
+  const auto text = QByteArray::fromRawData(
+      in_buffer.Data(), static_cast<qsizetype>(in_buffer.Size()));
+  const auto begin = text.indexOf(begin_tag);
+  const auto end = text.indexOf(end_tag);
+  if (begin < 0 || end < begin || !text.left(begin).trimmed().isEmpty() ||
+      !text.mid(end + end_tag.size()).trimmed().isEmpty()) {
+    return in_buffer;
+  }
+
+  auto [succ, type, data] = DearmorBuffer(in_buffer);
+  return succ && type == "MESSAGE" ? data : in_buffer;
+}
+
+/**
+ * @brief block type of the armor of a signature
+ *
+ * @param mode
+ * @return QString
+ */
+auto SignArmorType(GpgSignMode mode) -> QString {
+  return mode == GPGME_SIG_MODE_DETACH ? "SIGNATURE" : "MESSAGE";
+}
+
+}  // namespace
+
+GpgEncryptSession::GpgEncryptSession(GpgContextHolder holder,
+                                     KeyArgsList keys, bool ascii, bool armor)
+    : holder_(std::move(holder)),
+      keys_(std::move(keys)),
+      ascii_(ascii),
+      armor_(armor) {
+  recipients_.reserve(keys_.size() + 1);
+  for (const auto& key : keys_) {
+    recipients_.emplace_back(static_cast<gpgme_key_t>(key));
+  }
+
+  // Last entry data_in array has to be nullptr
+  recipients_.emplace_back(nullptr);
+}
+
+auto GpgEncryptSession::Encrypt(const GFBuffer& in_buffer)
+    -> std::tuple<GpgError, GFBuffer> {
+  GpgData data_in(in_buffer);
+  GpgData data_out(OutputSizeHint(in_buffer, ascii_ && !armor_));
+
+  auto err = CheckGpgError(gpgme_op_encrypt(holder_.get(), recipients_.data(),
+                                            GPGME_ENCRYPT_ALWAYS_TRUST,
+                                            data_in, data_out));
+  if (err != GPG_ERR_NO_ERROR) return {err, {}};
+  return {err, ReadArmoredOutput(data_out, armor_, "MESSAGE")};
+}
+
+auto GpgEncryptSession::Recipients() const -> const KeyArgsList& {
+  return keys_;
+}
+
 GpgBasicOperator::GpgBasicOperator(int channel)
     : SingletonFunctionObject<GpgBasicOperator>(channel) {}
 
+auto GpgBasicOperator::OpenEncryptSession(const KeyIdArgsListPtr& key_ids,
+                                          bool ascii)
+    -> std::tuple<GpgError, GpgEncryptSessionPtr> {
+  if (key_ids == nullptr || key_ids->empty()) return {GPG_ERR_CANCELED, {}};
+
+  auto keys = GpgKeyGetter::GetInstance(GetChannel()).GetKeys(key_ids);
+  for (const auto& key : *keys) {
+    if (!key.IsGood() || !key.IsHasActualEncryptionCapability()) {
+      GF_CORE_LOG_ERROR("recipient cannot encrypt, key id: {}", key.GetId());
+      return {GPG_ERR_UNUSABLE_PUBKEY, {}};
+    }
+  }
+
+  // the session may outlive the task opening it and must not hold on to a
+  // pooled context for that long
+  const auto armor = InProcessArmor(ascii);
+  auto holder = ctx_.CreateContext(ascii && !armor);
+  if (holder == nullptr) return {GPG_ERR_GENERAL, {}};
+
+  return {GPG_ERR_NO_ERROR, std::make_unique<GpgEncryptSession>(
+                                std::move(holder), *keys, ascii, armor)};
+}
+
 void GpgBasicOperator::Encrypt(const KeyArgsList& keys,
                                const GFBuffer& in_buffer, bool ascii,
                                const GpgOperationCallback& cb) {
@@ -50,20 +190,24 @@ void GpgBasicOperator::Encrypt(const KeyArgsList& keys,
       [=](const DataObjectPtr& data_object) -> GpgError {
         if (keys.empty()) return GPG_ERR_CANCELED;
 
+        const auto armor = InProcessArmor(ascii);
+        auto holder = ctx_.AcquireContext(ascii && !armor);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         std::vector<gpgme_key_t> recipients(keys.begin(), keys.end());
 
         // Last entry data_in array has to be nullptr
         recipients.emplace_back(nullptr);
 
         GpgData data_in(in_buffer);
-        GpgData data_out;
+        GpgData data_out(OutputSizeHint(in_buffer, ascii && !armor));
 
-        auto* ctx = ascii ? ctx_.DefaultContext() : ctx_.BinaryContext();
         auto err = CheckGpgError(gpgme_op_encrypt(ctx, recipients.data(),
                                                   GPGME_ENCRYPT_ALWAYS_TRUST,
                                                   data_in, data_out));
         data_object->Swap({GpgEncryptResult(gpgme_op_encrypt_result(ctx)),
-                           data_out.Read2GFBuffer()});
+                           ReadArmoredOutput(data_out, armor, "MESSAGE")});
 
         return err;
       },
@@ -77,20 +221,24 @@ auto GpgBasicOperator::EncryptSync(const KeyArgsList& keys,
       [=](const DataObjectPtr& data_object) -> GpgError {
         if (keys.empty()) return GPG_ERR_CANCELED;
 
+        const auto armor = InProcessArmor(ascii);
+        auto holder = ctx_.AcquireContext(ascii && !armor);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         std::vector<gpgme_key_t> recipients(keys.begin(), keys.end());
 
         // Last entry data_in array has to be nullptr
         recipients.emplace_back(nullptr);
 
         GpgData data_in(in_buffer);
-        GpgData data_out;
+        GpgData data_out(OutputSizeHint(in_buffer, ascii && !armor));
 
-        auto* ctx = ascii ? ctx_.DefaultContext() : ctx_.BinaryContext();
         auto err = CheckGpgError(gpgme_op_encrypt(ctx, recipients.data(),
                                                   GPGME_ENCRYPT_ALWAYS_TRUST,
                                                   data_in, data_out));
         data_object->Swap({GpgEncryptResult(gpgme_op_encrypt_result(ctx)),
-                           data_out.Read2GFBuffer()});
+                           ReadArmoredOutput(data_out, armor, "MESSAGE")});
 
         return err;
       },
@@ -101,14 +249,18 @@ void GpgBasicOperator::EncryptSymmetric(const GFBuffer& in_buffer, bool ascii,
                                         const GpgOperationCallback& cb) {
   RunGpgOperaAsync(
       [=](const DataObjectPtr& data_object) -> GpgError {
+        const auto armor = InProcessArmor(ascii);
+        auto holder = ctx_.AcquireContext(ascii && !armor);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         GpgData data_in(in_buffer);
-        GpgData data_out;
+        GpgData data_out(OutputSizeHint(in_buffer, ascii && !armor));
 
-        auto* ctx = ascii ? ctx_.DefaultContext() : ctx_.BinaryContext();
         auto err = CheckGpgError(gpgme_op_encrypt(
             ctx, nullptr, GPGME_ENCRYPT_SYMMETRIC, data_in, data_out));
         data_object->Swap({GpgEncryptResult(gpgme_op_encrypt_result(ctx)),
-                           data_out.Read2GFBuffer()});
+                           ReadArmoredOutput(data_out, armor, "MESSAGE")});
 
         return err;
       },
@@ -120,14 +272,18 @@ auto GpgBasicOperator::EncryptSymmetricSync(const GFBuffer& in_buffer,
     -> std::tuple<GpgError, DataObjectPtr> {
   return RunGpgOperaSync(
       [=](const DataObjectPtr& data_object) -> GpgError {
+        const auto armor = InProcessArmor(ascii);
+        auto holder = ctx_.AcquireContext(ascii && !armor);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         GpgData data_in(in_buffer);
-        GpgData data_out;
+        GpgData data_out(OutputSizeHint(in_buffer, ascii && !armor));
 
-        auto* ctx = ascii ? ctx_.DefaultContext() : ctx_.BinaryContext();
         auto err = CheckGpgError(gpgme_op_encrypt(
             ctx, nullptr, GPGME_ENCRYPT_SYMMETRIC, data_in, data_out));
         data_object->Swap({GpgEncryptResult(gpgme_op_encrypt_result(ctx)),
-                           data_out.Read2GFBuffer()});
+                           ReadArmoredOutput(data_out, armor, "MESSAGE")});
 
         return err;
       },
@@ -138,14 +294,16 @@ void GpgBasicOperator::Decrypt(const GFBuffer& in_buffer,
                                const GpgOperationCallback& cb) {
   RunGpgOperaAsync(
       [=](const DataObjectPtr& data_object) -> GpgError {
-        GpgData data_in(in_buffer);
-        GpgData data_out;
+        auto holder = ctx_.AcquireContext(true);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
 
-        auto err = CheckGpgError(
-            gpgme_op_decrypt(ctx_.DefaultContext(), data_in, data_out));
-        data_object->Swap(
-            {GpgDecryptResult(gpgme_op_decrypt_result(ctx_.DefaultContext())),
-             data_out.Read2GFBuffer()});
+        GpgData data_in(DearmorInput(in_buffer));
+        GpgData data_out(GpgDataSizeHint{in_buffer.Size()});
+
+        auto err = CheckGpgError(gpgme_op_decrypt(ctx, data_in, data_out));
+        data_object->Swap({GpgDecryptResult(gpgme_op_decrypt_result(ctx)),
+                           data_out.Read2GFBuffer()});
 
         return err;
       },
@@ -156,14 +314,62 @@ auto GpgBasicOperator::DecryptSync(const GFBuffer& in_buffer)
     -> std::tuple<GpgError, DataObjectPtr> {
   return RunGpgOperaSync(
       [=](const DataObjectPtr& data_object) -> GpgError {
-        GpgData data_in(in_buffer);
-        GpgData data_out;
+        auto holder = ctx_.AcquireContext(true);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
 
-        auto err = CheckGpgError(
-            gpgme_op_decrypt(ctx_.DefaultContext(), data_in, data_out));
-        data_object->Swap(
-            {GpgDecryptResult(gpgme_op_decrypt_result(ctx_.DefaultContext())),
-             data_out.Read2GFBuffer()});
+        GpgData data_in(DearmorInput(in_buffer));
+        GpgData data_out(GpgDataSizeHint{in_buffer.Size()});
+
+        auto err = CheckGpgError(gpgme_op_decrypt(ctx, data_in, data_out));
+        data_object->Swap({GpgDecryptResult(gpgme_op_decrypt_result(ctx)),
+                           data_out.Read2GFBuffer()});
+
+        return err;
+      },
+      "gpgme_op_decrypt", "2.1.0");
+}
+
+void GpgBasicOperator::Decrypt(const GFBuffer& in_buffer,
+                               const GpgDataSink& sink,
+                               const GpgOperationCallback& cb) {
+  RunGpgOperaAsync(
+      [=](const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(true);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
+        GpgData data_in(DearmorInput(in_buffer));
+        GpgData data_out(sink);
+
+        auto err = CheckGpgError(gpgme_op_decrypt(ctx, data_in, data_out));
+        if (!data_out.FlushSink() && err == GPG_ERR_NO_ERROR) {
+          err = GPG_ERR_EIO;
+        }
+        data_object->Swap({GpgDecryptResult(gpgme_op_decrypt_result(ctx))});
+
+        return err;
+      },
+      cb, "gpgme_op_decrypt", "2.1.0");
+}
+
+auto GpgBasicOperator::DecryptSync(const GFBuffer& in_buffer,
+                                   const GpgDataSink& sink)
+    -> std::tuple<GpgError, DataObjectPtr> {
+  return RunGpgOperaSync(
+      [=](const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(true);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
+        GpgData data_in(DearmorInput(in_buffer));
+        GpgData data_out(sink);
+
+        auto err = CheckGpgError(gpgme_op_decrypt(ctx, data_in, data_out));
+        if (!data_out.FlushSink() && err == GPG_ERR_NO_ERROR) {
+          err = GPG_ERR_EIO;
+        }
+        data_object->Swap({GpgDecryptResult(gpgme_op_decrypt_result(ctx))});
 
         return err;
       },
@@ -175,6 +381,10 @@ void GpgBasicOperator::Verify(const GFBuffer& in_buffer,
                               const GpgOperationCallback& cb) {
   RunGpgOperaAsync(
       [=](const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(true);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         GpgError err;
 
         GpgData data_in(in_buffer);
@@ -182,15 +392,13 @@ void GpgBasicOperator::Verify(const GFBuffer& in_buffer,
 
         if (!sig_buffer.Empty()) {
           GpgData sig_data(sig_buffer);
-          err = CheckGpgError(gpgme_op_verify(ctx_.DefaultContext(), sig_data,
-                                              data_in, nullptr));
+          err = CheckGpgError(gpgme_op_verify(ctx, sig_data, data_in, nullptr));
         } else {
-          err = CheckGpgError(gpgme_op_verify(ctx_.DefaultContext(), data_in,
-                                              nullptr, data_out));
+          err = CheckGpgError(gpgme_op_verify(ctx, data_in, nullptr, data_out));
         }
 
         data_object->Swap({
-            GpgVerifyResult(gpgme_op_verify_result(ctx_.DefaultContext())),
+            GpgVerifyResult(gpgme_op_verify_result(ctx)),
         });
 
         return err;
@@ -203,6 +411,10 @@ auto GpgBasicOperator::VerifySync(const GFBuffer& in_buffer,
     -> std::tuple<GpgError, DataObjectPtr> {
   return RunGpgOperaSync(
       [=](const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(true);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         GpgError err;
 
         GpgData data_in(in_buffer);
@@ -210,15 +422,13 @@ auto GpgBasicOperator::VerifySync(const GFBuffer& in_buffer,
 
         if (!sig_buffer.Empty()) {
           GpgData sig_data(sig_buffer);
-          err = CheckGpgError(gpgme_op_verify(ctx_.DefaultContext(), sig_data,
-                                              data_in, nullptr));
+          err = CheckGpgError(gpgme_op_verify(ctx, sig_data, data_in, nullptr));
         } else {
-          err = CheckGpgError(gpgme_op_verify(ctx_.DefaultContext(), data_in,
-                                              nullptr, data_out));
+          err = CheckGpgError(gpgme_op_verify(ctx, data_in, nullptr, data_out));
         }
 
         data_object->Swap({
-            GpgVerifyResult(gpgme_op_verify_result(ctx_.DefaultContext())),
+            GpgVerifyResult(gpgme_op_verify_result(ctx)),
         });
 
         return err;
@@ -233,19 +443,25 @@ void GpgBasicOperator::Sign(const KeyArgsList& signers,
       [=](const DataObjectPtr& data_object) -> GpgError {
         if (signers.empty()) return GPG_ERR_CANCELED;
 
+        const auto armor =
+            InProcessArmor(ascii && mode != GPGME_SIG_MODE_CLEAR);
+        auto holder = ctx_.AcquireContext(ascii && !armor);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         GpgError err;
 
         // Set Singers of this opera
-        SetSigners(signers, ascii);
+        SetSigners(ctx, signers);
 
         GpgData data_in(in_buffer);
-        GpgData data_out;
+        GpgData data_out(OutputSizeHint(in_buffer, ascii && !armor));
 
-        auto* ctx = ascii ? ctx_.DefaultContext() : ctx_.BinaryContext();
         err = CheckGpgError(gpgme_op_sign(ctx, data_in, data_out, mode));
 
-        data_object->Swap({GpgSignResult(gpgme_op_sign_result(ctx)),
-                           data_out.Read2GFBuffer()});
+        data_object->Swap(
+            {GpgSignResult(gpgme_op_sign_result(ctx)),
+             ReadArmoredOutput(data_out, armor, SignArmorType(mode))});
         return err;
       },
       cb, "gpgme_op_sign", "2.1.0");
@@ -259,19 +475,25 @@ auto GpgBasicOperator::SignSync(const KeyArgsList& signers,
       [=](const DataObjectPtr& data_object) -> GpgError {
         if (signers.empty()) return GPG_ERR_CANCELED;
 
+        const auto armor =
+            InProcessArmor(ascii && mode != GPGME_SIG_MODE_CLEAR);
+        auto holder = ctx_.AcquireContext(ascii && !armor);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         GpgError err;
 
         // Set Singers of this opera
-        SetSigners(signers, ascii);
+        SetSigners(ctx, signers);
 
         GpgData data_in(in_buffer);
-        GpgData data_out;
+        GpgData data_out(OutputSizeHint(in_buffer, ascii && !armor));
 
-        auto* ctx = ascii ? ctx_.DefaultContext() : ctx_.BinaryContext();
         err = CheckGpgError(gpgme_op_sign(ctx, data_in, data_out, mode));
 
-        data_object->Swap({GpgSignResult(gpgme_op_sign_result(ctx)),
-                           data_out.Read2GFBuffer()});
+        data_object->Swap(
+            {GpgSignResult(gpgme_op_sign_result(ctx)),
+             ReadArmoredOutput(data_out, armor, SignArmorType(mode))});
         return err;
       },
       "gpgme_op_sign", "2.1.0");
@@ -281,18 +503,20 @@ void GpgBasicOperator::DecryptVerify(const GFBuffer& in_buffer,
                                      const GpgOperationCallback& cb) {
   RunGpgOperaAsync(
       [=](const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(true);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         GpgError err;
 
-        GpgData data_in(in_buffer);
-        GpgData data_out;
+        GpgData data_in(DearmorInput(in_buffer));
+        GpgData data_out(GpgDataSizeHint{in_buffer.Size()});
 
-        err = CheckGpgError(
-            gpgme_op_decrypt_verify(ctx_.DefaultContext(), data_in, data_out));
+        err = CheckGpgError(gpgme_op_decrypt_verify(ctx, data_in, data_out));
 
-        data_object->Swap(
-            {GpgDecryptResult(gpgme_op_decrypt_result(ctx_.DefaultContext())),
-             GpgVerifyResult(gpgme_op_verify_result(ctx_.DefaultContext())),
-             data_out.Read2GFBuffer()});
+        data_object->Swap({GpgDecryptResult(gpgme_op_decrypt_result(ctx)),
+                           GpgVerifyResult(gpgme_op_verify_result(ctx)),
+                           data_out.Read2GFBuffer()});
 
         return err;
       },
@@ -303,18 +527,72 @@ auto GpgBasicOperator::DecryptVerifySync(const GFBuffer& in_buffer)
     -> std::tuple<GpgError, DataObjectPtr> {
   return RunGpgOperaSync(
       [=](const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(true);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         GpgError err;
 
-        GpgData data_in(in_buffer);
-        GpgData data_out;
+        GpgData data_in(DearmorInput(in_buffer));
+        GpgData data_out(GpgDataSizeHint{in_buffer.Size()});
 
-        err = CheckGpgError(
-            gpgme_op_decrypt_verify(ctx_.DefaultContext(), data_in, data_out));
+        err = CheckGpgError(gpgme_op_decrypt_verify(ctx, data_in, data_out));
 
-        data_object->Swap(
-            {GpgDecryptResult(gpgme_op_decrypt_result(ctx_.DefaultContext())),
-             GpgVerifyResult(gpgme_op_verify_result(ctx_.DefaultContext())),
-             data_out.Read2GFBuffer()});
+        data_object->Swap({GpgDecryptResult(gpgme_op_decrypt_result(ctx)),
+                           GpgVerifyResult(gpgme_op_verify_result(ctx)),
+                           data_out.Read2GFBuffer()});
+
+        return err;
+      },
+      "gpgme_op_decrypt_verify", "2.1.0");
+}
+
+void GpgBasicOperator::DecryptVerify(const GFBuffer& in_buffer,
+                                     const GpgDataSink& sink,
+                                     const GpgOperationCallback& cb) {
+  RunGpgOperaAsync(
+      [=](const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(true);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
+        GpgData data_in(DearmorInput(in_buffer));
+        GpgData data_out(sink);
+
+        auto err =
+            CheckGpgError(gpgme_op_decrypt_verify(ctx, data_in, data_out));
+        if (!data_out.FlushSink() && err == GPG_ERR_NO_ERROR) {
+          err = GPG_ERR_EIO;
+        }
+
+        data_object->Swap({GpgDecryptResult(gpgme_op_decrypt_result(ctx)),
+                           GpgVerifyResult(gpgme_op_verify_result(ctx))});
+
+        return err;
+      },
+      cb, "gpgme_op_decrypt_verify", "2.1.0");
+}
+
+auto GpgBasicOperator::DecryptVerifySync(const GFBuffer& in_buffer,
+                                         const GpgDataSink& sink)
+    -> std::tuple<GpgError, DataObjectPtr> {
+  return RunGpgOperaSync(
+      [=](const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(true);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
+        GpgData data_in(DearmorInput(in_buffer));
+        GpgData data_out(sink);
+
+        auto err =
+            CheckGpgError(gpgme_op_decrypt_verify(ctx, data_in, data_out));
+        if (!data_out.FlushSink() && err == GPG_ERR_NO_ERROR) {
+          err = GPG_ERR_EIO;
+        }
+
+        data_object->Swap({GpgDecryptResult(gpgme_op_decrypt_result(ctx)),
+                           GpgVerifyResult(gpgme_op_verify_result(ctx))});
 
         return err;
       },
@@ -329,25 +607,29 @@ void GpgBasicOperator::EncryptSign(const KeyArgsList& keys,
       [=](const DataObjectPtr& data_object) -> GpgError {
         if (keys.empty() || signers.empty()) return GPG_ERR_CANCELED;
 
+        const auto armor = InProcessArmor(ascii);
+        auto holder = ctx_.AcquireContext(ascii && !armor);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         GpgError err;
         std::vector<gpgme_key_t> recipients(keys.begin(), keys.end());
 
         // Last entry data_in array has to be nullptr
         recipients.emplace_back(nullptr);
 
-        SetSigners(signers, ascii);
+        SetSigners(ctx, signers);
 
         GpgData data_in(in_buffer);
-        GpgData data_out;
+        GpgData data_out(OutputSizeHint(in_buffer, ascii && !armor));
 
-        auto* ctx = ascii ? ctx_.DefaultContext() : ctx_.BinaryContext();
         err = CheckGpgError(gpgme_op_encrypt_sign(ctx, recipients.data(),
                                                   GPGME_ENCRYPT_ALWAYS_TRUST,
                                                   data_in, data_out));
 
         data_object->Swap({GpgEncryptResult(gpgme_op_encrypt_result(ctx)),
                            GpgSignResult(gpgme_op_sign_result(ctx)),
-                           data_out.Read2GFBuffer()});
+                           ReadArmoredOutput(data_out, armor, "MESSAGE")});
         return err;
       },
       cb, "gpgme_op_encrypt_sign", "2.1.0");
@@ -361,33 +643,40 @@ auto GpgBasicOperator::EncryptSignSync(const KeyArgsList& keys,
       [=](const DataObjectPtr& data_object) -> GpgError {
         if (keys.empty() || signers.empty()) return GPG_ERR_CANCELED;
 
+        const auto armor = InProcessArmor(ascii);
+        auto holder = ctx_.AcquireContext(ascii && !armor);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         GpgError err;
         std::vector<gpgme_key_t> recipients(keys.begin(), keys.end());
 
         // Last entry data_in array has to be nullptr
         recipients.emplace_back(nullptr);
 
-        SetSigners(signers, ascii);
+        SetSigners(ctx, signers);
 
         GpgData data_in(in_buffer);
-        GpgData data_out;
+        GpgData data_out(OutputSizeHint(in_buffer, ascii && !armor));
 
-        auto* ctx = ascii ? ctx_.DefaultContext() : ctx_.BinaryContext();
         err = CheckGpgError(gpgme_op_encrypt_sign(ctx, recipients.data(),
                                                   GPGME_ENCRYPT_ALWAYS_TRUST,
                                                   data_in, data_out));
 
         data_object->Swap({GpgEncryptResult(gpgme_op_encrypt_result(ctx)),
                            GpgSignResult(gpgme_op_sign_result(ctx)),
-                           data_out.Read2GFBuffer()});
+                           ReadArmoredOutput(data_out, armor, "MESSAGE")});
         return err;
       },
       "gpgme_op_encrypt_sign", "2.1.0");
 }
 
 void GpgBasicOperator::SetSigners(const KeyArgsList& signers, bool ascii) {
-  auto* ctx = ascii ? ctx_.DefaultContext() : ctx_.BinaryContext();
+  SetSigners(ascii ? ctx_.DefaultContext() : ctx_.BinaryContext(), signers);
+}
 
+void GpgBasicOperator::SetSigners(gpgme_ctx_t ctx,
+                                  const KeyArgsList& signers) {
   gpgme_signers_clear(ctx);
 
   for (const GpgKey& key : signers) {
@@ -398,19 +687,8 @@ void GpgBasicOperator::SetSigners(const KeyArgsList& signers, bool ascii) {
       CheckGpgError(error);
     }
   }
-  if (signers.size() != gpgme_signers_count(ctx_.DefaultContext()))
+  if (signers.size() != gpgme_signers_count(ctx))
     GF_CORE_LOG_DEBUG("not all signers added");
 }
 
-auto GpgBasicOperator::GetSigners(bool ascii) -> std::unique_ptr<KeyArgsList> {
-  auto* ctx = ascii ? ctx_.DefaultContext() : ctx_.BinaryContext();
-
-  auto count = gpgme_signers_count(ctx);
-  auto signers = std::make_unique<std::vector<GpgKey>>();
-  for (auto i = 0U; i < count; i++) {
-    auto key = GpgKey(gpgme_signers_enum(ctx, i));
-    signers->push_back(GpgKey(std::move(key)));
-  }
-  return signers;
-}
 }  // namespace GpgFrontend
@@ -32,11 +32,58 @@
 #include "core/function/gpg/GpgContext.h"
 #include "core/function/result_analyse/GpgResultAnalyse.h"
 #include "core/model/GFBuffer.h"
+#include "core/model/GpgData.h"
 #include "core/typedef/CoreTypedef.h"
 #include "core/typedef/GpgTypedef.h"
 
 namespace GpgFrontend {
 
+/**
+ * @brief encrypts many messages to the same recipients. The recipients are
+ * resolved and checked once and a pooled context is held until the session
+ * is destroyed, so a message only costs the gpgme operation itself.
+ *
+ * A session is not thread safe and must not outlive the task it was opened
+ * in.
+ */
+class GPGFRONTEND_CORE_EXPORT GpgEncryptSession {
+ public:
+  /**
+   * @brief Construct a new Gpg Encrypt Session object
+   *
+   * @param holder context used by every message
+   * @param keys checked recipients
+   * @param ascii
+   * @param armor the context writes binary data, armored by the session
+   */
+  GpgEncryptSession(GpgContextHolder holder, KeyArgsList keys, bool ascii,
+                    bool armor = false);
+
+  /**
+   * @brief encrypt one message
+   *
+   * @param in_buffer
+   * @return std::tuple<GpgError, GFBuffer>
+   */
+  auto Encrypt(const GFBuffer& in_buffer) -> std::tuple<GpgError, GFBuffer>;
+
+  /**
+   * @brief
+   *
+   * @return const KeyArgsList&
+   */
+  [[nodiscard]] auto Recipients() const -> const KeyArgsList&;
+
+ private:
+  GpgContextHolder holder_;
+  KeyArgsList keys_;                     ///< owns the recipients
+  std::vector<gpgme_key_t> recipients_;  ///< nullptr terminated
+  bool ascii_;                           ///<
+  bool armor_;                           ///<
+};
+
+using GpgEncryptSessionPtr = std::unique_ptr<GpgEncryptSession>;  ///<
+
 /**
  * @brief Basic operation collection
  *
@@ -66,6 +113,17 @@ class GPGFRONTEND_CORE_EXPORT GpgBasicOperator
   auto EncryptSync(const KeyArgsList&, const GFBuffer&, bool)
       -> std::tuple<GpgError, DataObjectPtr>;
 
+  /**
+   * @brief open a session to encrypt many messages to the same keys
+   *
+   * @param key_ids
+   * @param ascii
+   * @return std::tuple<GpgError, GpgEncryptSessionPtr> GPG_ERR_UNUSABLE_PUBKEY
+   * if a key is missing or cannot encrypt
+   */
+  auto OpenEncryptSession(const KeyIdArgsListPtr& key_ids, bool ascii)
+      -> std::tuple<GpgError, GpgEncryptSessionPtr>;
+
   /**
    * @brief Call the interface provided by GPGME to symmetrical encryption
    *
@@ -134,6 +192,27 @@ class GPGFRONTEND_CORE_EXPORT GpgBasicOperator
   auto DecryptSync(const GFBuffer& in_buffer)
       -> std::tuple<GpgError, DataObjectPtr>;
 
+  /**
+   * @brief decrypt into a sink instead of a buffer, the data object holds
+   * only the GpgDecryptResult
+   *
+   * @param in_buffer
+   * @param sink see MakeGpgDataSink()
+   * @param cb
+   */
+  void Decrypt(const GFBuffer& in_buffer, const GpgDataSink& sink,
+               const GpgOperationCallback& cb);
+
+  /**
+   * @brief
+   *
+   * @param in_buffer
+   * @param sink
+   * @return std::tuple<GpgError, DataObjectPtr>
+   */
+  auto DecryptSync(const GFBuffer& in_buffer, const GpgDataSink& sink)
+      -> std::tuple<GpgError, DataObjectPtr>;
+
   /**
    * @brief  Call the interface provided by gpgme to perform decryption and
    * verification operations at the same time.
@@ -154,6 +233,27 @@ class GPGFRONTEND_CORE_EXPORT GpgBasicOperator
   auto DecryptVerifySync(const GFBuffer& in_buffer)
       -> std::tuple<GpgError, DataObjectPtr>;
 
+  /**
+   * @brief decrypt and verify into a sink instead of a buffer, the data
+   * object holds the GpgDecryptResult and the GpgVerifyResult
+   *
+   * @param in_buffer
+   * @param sink see MakeGpgDataSink()
+   * @param cb
+   */
+  void DecryptVerify(const GFBuffer& in_buffer, const GpgDataSink& sink,
+                     const GpgOperationCallback& cb);
+
+  /**
+   * @brief
+   *
+   * @param in_buffer
+   * @param sink
+   * @return std::tuple<GpgError, DataObjectPtr>
+   */
+  auto DecryptVerifySync(const GFBuffer& in_buffer, const GpgDataSink& sink)
+      -> std::tuple<GpgError, DataObjectPtr>;
+
   /**
    * @brief Call the interface provided by gpgme for verification operation
    *
@@ -222,11 +322,13 @@ class GPGFRONTEND_CORE_EXPORT GpgBasicOperator
   void SetSigners(const KeyArgsList& signers, bool ascii);
 
   /**
-   * @brief Get a global signature private keys that has been set.
+   * @brief Set the private keys for signatures on the given context only,
+   * e.g. one checked out by GpgContext::AcquireContext().
    *
-   * @return Intelligent pointer pointing to the private key list
+   * @param ctx
+   * @param signers
    */
-  auto GetSigners(bool ascii) -> std::unique_ptr<KeyArgsList>;
+  static void SetSigners(gpgme_ctx_t ctx, const KeyArgsList& signers);
 
  private:
   GpgContext& ctx_ = GpgContext::GetInstance(
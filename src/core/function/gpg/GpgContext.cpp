@@ -31,13 +31,17 @@
 #include <gpg-error.h>
 #include <gpgme.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
 #include <mutex>
 
 #include "core/function/CoreSignalStation.h"
 #include "core/function/basic/GpgFunctionObject.h"
 #include "core/model/GpgPassphraseContext.h"
 #include "core/module/ModuleManager.h"
+#include "core/thread/Task.h"
 #include "core/utils/CacheUtils.h"
 #include "core/utils/GpgUtils.h"
 #include "core/utils/MemoryUtils.h"
@@ -48,6 +52,55 @@
 
 namespace GpgFrontend {
 
+namespace {
+
+/**
+ * @brief the pooled contexts of one armor mode, shared with the holders
+ * checked out from it, which may outlive the GpgContext
+ *
+ */
+struct ContextPool {
+  std::mutex lock;
+  std::condition_variable cv;
+  std::vector<gpgme_ctx_t> idle;  ///< contexts ready to be checked out
+  int created = 0;                ///< idle and checked out contexts
+  bool closed = false;            ///< the GpgContext is gone
+
+  void Release(gpgme_ctx_t ctx, bool cancelled) {
+    if (ctx == nullptr) return;
+
+    // a cancelled context keeps its cancel flag, never hand it out again
+    if (!cancelled) {
+      // drop state left by the last operation
+      gpgme_signers_clear(ctx);
+      gpgme_sig_notation_clear(ctx);
+
+      std::lock_guard<std::mutex> guard(lock);
+      if (!closed) {
+        idle.push_back(ctx);
+        cv.notify_one();
+        return;
+      }
+    }
+
+    gpgme_release(ctx);
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      created--;
+    }
+    cv.notify_one();
+  }
+
+  void Close() {
+    std::lock_guard<std::mutex> guard(lock);
+    closed = true;
+    for (auto *ctx : idle) gpgme_release(ctx);
+    idle.clear();
+  }
+};
+
+}  // namespace
+
 class GpgContext::Impl {
  public:
   /**
@@ -57,7 +110,8 @@ class GpgContext::Impl {
   Impl(GpgContext *parent, const GpgContextInitArgs &args)
       : parent_(parent),
         args_(args),
-        good_(default_ctx_initialize(args) && binary_ctx_initialize(args)) {}
+        good_(default_ctx_initialize(args) && binary_ctx_initialize(args)),
+        pool_size_(std::max(1, args.context_pool_size)) {}
 
   ~Impl() {
     if (ctx_ref_ != nullptr) {
@@ -67,6 +121,10 @@ class GpgContext::Impl {
     if (binary_ctx_ref_ != nullptr) {
       gpgme_release(binary_ctx_ref_);
     }
+
+    // the contexts still checked out are released by their holders
+    ctx_pool_->Close();
+    binary_ctx_pool_->Close();
   }
 
   [[nodiscard]] auto BinaryContext() const -> gpgme_ctx_t {
@@ -77,6 +135,64 @@ class GpgContext::Impl {
 
   [[nodiscard]] auto Good() const -> bool { return good_; }
 
+  [[nodiscard]] auto ContextPoolSize() const -> int { return pool_size_; }
+
+  [[nodiscard]] auto GetDatabasePath() const -> QString {
+    if (!args_.db_path.isEmpty()) return args_.db_path;
+
+    auto *engine = gpgme_ctx_get_engine_info(ctx_ref_);
+    for (; engine != nullptr; engine = engine->next) {
+      if (engine->protocol == GPGME_PROTOCOL_OpenPGP &&
+          engine->home_dir != nullptr) {
+        return QString::fromUtf8(engine->home_dir);
+      }
+    }
+
+    // the engine uses the default home directory of gnupg
+    const auto *home_dir = gpgme_get_dirinfo("homedir");
+    return home_dir != nullptr ? QString::fromUtf8(home_dir) : QString{};
+  }
+
+  [[nodiscard]] auto GetContextPool(bool ascii) const
+      -> std::shared_ptr<ContextPool> {
+    return ascii ? ctx_pool_ : binary_ctx_pool_;
+  }
+
+  auto AcquireContext(bool ascii) -> gpgme_ctx_t {
+    auto &pool = ascii ? *ctx_pool_ : *binary_ctx_pool_;
+
+    std::unique_lock<std::mutex> lock(pool.lock);
+    pool.cv.wait(lock, [&]() {
+      return !pool.idle.empty() || pool.created < pool_size_;
+    });
+
+    if (!pool.idle.empty()) {
+      auto *ctx = pool.idle.back();
+      pool.idle.pop_back();
+      return ctx;
+    }
+
+    // reserve the slot, then set up the new context without holding the lock
+    pool.created++;
+    lock.unlock();
+
+    auto *ctx = new_ctx(args_, ascii);
+    if (ctx == nullptr) {
+      GF_CORE_LOG_ERROR("cannot create a new pooled gpgme context");
+      lock.lock();
+      pool.created--;
+      lock.unlock();
+      pool.cv.notify_one();
+    }
+    return ctx;
+  }
+
+  auto CreateContext(bool ascii) -> gpgme_ctx_t {
+    auto *ctx = new_ctx(args_, ascii);
+    if (ctx == nullptr) GF_CORE_LOG_ERROR("cannot create a new gpgme context");
+    return ctx;
+  }
+
   auto SetPassphraseCb(const gpgme_ctx_t &ctx, gpgme_passphrase_cb_t cb)
       -> bool {
     if (gpgme_get_pinentry_mode(ctx) != GPGME_PINENTRY_MODE_LOOPBACK) {
@@ -180,8 +296,12 @@ class GpgContext::Impl {
   gpgme_ctx_t ctx_ref_ = nullptr;         ///<
   gpgme_ctx_t binary_ctx_ref_ = nullptr;  ///<
   bool good_ = true;
-  std::mutex ctx_ref_lock_;
-  std::mutex binary_ctx_ref_lock_;
+
+  int pool_size_;  ///< max contexts per pool
+  std::shared_ptr<ContextPool> ctx_pool_ =
+      std::make_shared<ContextPool>();  ///< armored contexts
+  std::shared_ptr<ContextPool> binary_ctx_pool_ =
+      std::make_shared<ContextPool>();  ///< binary contexts
 
   static auto set_ctx_key_list_mode(const gpgme_ctx_t &ctx) -> bool {
     assert(ctx != nullptr);
@@ -291,6 +411,20 @@ class GpgContext::Impl {
     return true;
   }
 
+  auto new_ctx(const GpgContextInitArgs &args, bool ascii) -> gpgme_ctx_t {
+    gpgme_ctx_t p_ctx;
+    if (CheckGpgError(gpgme_new(&p_ctx)) != GPG_ERR_NO_ERROR) return nullptr;
+    assert(p_ctx != nullptr);
+
+    if (!common_ctx_initialize(p_ctx, args)) {
+      gpgme_release(p_ctx);
+      return nullptr;
+    }
+
+    gpgme_set_armor(p_ctx, ascii ? 1 : 0);
+    return p_ctx;
+  }
+
   auto binary_ctx_initialize(const GpgContextInitArgs &args) -> bool {
     gpgme_ctx_t p_ctx;
     if (auto err = CheckGpgError(gpgme_new(&p_ctx)); err != GPG_ERR_NO_ERROR) {
@@ -344,6 +478,41 @@ auto GpgContext::DefaultContext() -> gpgme_ctx_t {
   return p_->DefaultContext();
 }
 
+auto GpgContext::AcquireContext(bool ascii) -> GpgContextHolder {
+  auto *ctx = p_->AcquireContext(ascii);
+  if (ctx == nullptr) return {nullptr, [](gpgme_ctx_t) {}};
+
+  // let the task running on this thread abort the operation, the holder
+  // may still be around once the task is gone
+  QPointer<Thread::Task> task = Thread::Task::Current();
+  auto cancelled = std::make_shared<std::atomic_bool>(false);
+  auto hook_id = task == nullptr ? -1 : task->AddCancelHook([=]() {
+    *cancelled = true;
+    gpgme_cancel_async(ctx);
+  });
+
+  // the pool is shared, the holder may outlive this object
+  return {ctx, [pool = p_->GetContextPool(ascii), task, hook_id,
+                cancelled](gpgme_ctx_t ctx) {
+            if (task != nullptr) task->RemoveCancelHook(hook_id);
+            pool->Release(ctx, *cancelled);
+          }};
+}
+
+auto GpgContext::CreateContext(bool ascii) -> GpgContextHolder {
+  auto *ctx = p_->CreateContext(ascii);
+  if (ctx == nullptr) return {nullptr, [](gpgme_ctx_t) {}};
+  return {ctx, [](gpgme_ctx_t ctx) { gpgme_release(ctx); }};
+}
+
+auto GpgContext::ContextPoolSize() const -> int {
+  return p_->ContextPoolSize();
+}
+
+auto GpgContext::GetDatabasePath() const -> QString {
+  return p_->GetDatabasePath();
+}
+
 GpgContext::~GpgContext() = default;
 
 }  // namespace GpgFrontend
\ No newline at end of file
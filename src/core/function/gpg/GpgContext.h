@@ -48,8 +48,18 @@ struct GpgContextInitArgs {
   QString custom_gpgconf_path;  ///<
 
   bool use_pinentry = false;  ///<
+
+  int context_pool_size = 4;  ///< max contexts per armor mode in the pool
 };
 
+/**
+ * @brief a gpgme context checked out from the pool of a GpgContext, it goes
+ * back to the pool when the holder is destroyed.
+ *
+ */
+using GpgContextHolder = std::unique_ptr<std::remove_pointer_t<gpgme_ctx_t>,
+                                         std::function<void(gpgme_ctx_t)>>;
+
 /**
  * @brief
  *
@@ -69,6 +79,41 @@ class GPGFRONTEND_CORE_EXPORT GpgContext
 
   auto DefaultContext() -> gpgme_ctx_t;
 
+  /**
+   * @brief check out a context configured like DefaultContext() (ascii) or
+   * BinaryContext() from the pool. Blocks while all pooled contexts of this
+   * kind are in use. Signers and notations are cleared on return.
+   * Cancelling the current task aborts the operation running on it.
+   *
+   * @param ascii
+   * @return GpgContextHolder nullptr if a new context could not be created
+   */
+  auto AcquireContext(bool ascii) -> GpgContextHolder;
+
+  /**
+   * @brief a context of its own configured like AcquireContext() does, for
+   * holders which live longer than a task, e.g. an encryption session. It
+   * is neither pooled nor cancelled with the current task.
+   *
+   * @param ascii
+   * @return GpgContextHolder nullptr if the context could not be created
+   */
+  auto CreateContext(bool ascii) -> GpgContextHolder;
+
+  /**
+   * @brief max number of contexts per armor mode in the pool
+   *
+   * @return int
+   */
+  [[nodiscard]] auto ContextPoolSize() const -> int;
+
+  /**
+   * @brief the directory of the key database the contexts work on
+   *
+   * @return QString
+   */
+  [[nodiscard]] auto GetDatabasePath() const -> QString;
+
  private:
   class Impl;
   SecureUniquePtr<Impl> p_;
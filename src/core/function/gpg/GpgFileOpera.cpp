@@ -28,10 +28,12 @@
 #include "GpgFileOpera.h"
 
 #include "core/function/ArchiveFileOperator.h"
+#include "core/function/GlobalSettingStation.h"
 #include "core/function/gpg/GpgBasicOperator.h"
 #include "core/model/GpgData.h"
 #include "core/model/GpgDecryptResult.h"
 #include "core/model/GpgEncryptResult.h"
+#include "core/model/GpgFileBatchResult.h"
 #include "core/model/GpgKey.h"
 #include "core/model/GpgSignResult.h"
 #include "core/model/GpgVerifyResult.h"
@@ -40,25 +42,197 @@
 
 namespace GpgFrontend {
 
-constexpr ssize_t kDataExchangerSize = 8192;
+constexpr ssize_t kDataExchangerSize = 1024 * 1024;
+
+/**
+ * @brief report the progress of gpgme on data to the task running on the
+ * calling thread, if there is one
+ *
+ * @param data
+ * @param total
+ */
+void TrackProgress(GpgData& data, qint64 total) {
+  auto* task = Thread::Task::Current();
+  if (task == nullptr) return;
+
+  data.SetProgressCb([task, total](qint64 processed) {
+    task->ReportProgress(processed, total);
+  });
+}
+
+/**
+ * @brief cancelling the gpg operation of a directory operation also aborts
+ * the data exchanger and cancels the archive task feeding or draining it
+ *
+ * @param handler
+ * @param archive_handler
+ * @param ex
+ */
+void LinkArchiveTask(Thread::Task::TaskHandler handler,
+                     Thread::Task::TaskHandler archive_handler,
+                     const std::shared_ptr<GFDataExchanger>& ex) {
+  auto* task = handler.GetTask();
+  if (task == nullptr) return;
+
+  // the exchanger is closed here as well, one of the tasks may not have
+  // started yet and would leave the other one blocked on it
+  task->AddCancelHook([archive_handler, ex]() mutable {
+    ex->Close();
+    archive_handler.Cancel();
+  });
+}
+
+/**
+ * @brief report the progress of the archive task on the task of gpg. The
+ * archive task counts the bytes of the files it has archived, what gpg
+ * reads is the archive, which has headers and may be compressed.
+ *
+ * @param handler
+ * @param archive_handler
+ */
+void ForwardArchiveProgress(Thread::Task::TaskHandler handler,
+                            Thread::Task::TaskHandler archive_handler) {
+  auto* task = handler.GetTask();
+  auto* archive_task = archive_handler.GetTask();
+  if (task == nullptr || archive_task == nullptr) return;
+
+  QObject::connect(archive_task, &Thread::Task::SignalTaskProgress, task,
+                   [task](qint64 processed, qint64 total, double) {
+                     task->ReportProgress(processed, total);
+                   },
+                   Qt::DirectConnection);
+}
+
+/**
+ * @brief gpgme flags to encrypt an archive with. gpg's own compression is
+ * skipped for a compressed archive, unless the setting
+ * "gnupg/gpg_compress_compressed_archive" asks for both.
+ *
+ * @param flags
+ * @param filter
+ * @return gpgme_encrypt_flags_t
+ */
+auto ArchiveEncryptFlags(int flags, ArchiveFileOperator::ArchiveFilter filter)
+    -> gpgme_encrypt_flags_t {
+  const auto compress_twice =
+      GlobalSettingStation::GetInstance()
+          .GetSettings()
+          .value("gnupg/gpg_compress_compressed_archive", false)
+          .toBool();
+
+  if (filter != ArchiveFileOperator::kArchiveFilter_None && !compress_twice) {
+    flags |= GPGME_ENCRYPT_NO_COMPRESS;
+  }
+  return static_cast<gpgme_encrypt_flags_t>(flags);
+}
+
+using GpgFileOperaSync = std::function<std::tuple<GpgError, DataObjectPtr>(
+    const QString&, const QString&)>;
+
+auto RunFileBatch(const GpgFilePathPairs& files, int workers,
+                  const GpgFileOperaSync& opera)
+    -> std::tuple<GpgError, GpgFileBatchResult> {
+  GpgFileBatchResult result;
+  result.entries.resize(files.size());
+  result.workers =
+      std::max(1, std::min(workers, static_cast<int>(files.size())));
+
+  QElapsedTimer timer;
+  timer.start();
+
+  std::vector<qint64> sizes;
+  sizes.reserve(files.size());
+  for (const auto& [in_path, out_path] : files) {
+    sizes.push_back(QFileInfo(in_path).size());
+    result.in_bytes += sizes.back();
+  }
+
+  // the progress of the whole batch goes to the task of the calling thread
+  auto* task = Thread::Task::Current();
+  std::atomic<qint64> done_bytes = 0;
+
+  // every worker takes the next pending file until none is left, so there
+  // are never more files in flight than workers
+  std::atomic_size_t next = 0;
+  auto worker = [&]() {
+    for (auto i = next++; i < files.size(); i = next++) {
+      const auto& [in_path, out_path] = files[i];
+      auto& entry = result.entries[i];
+      entry.in_path = in_path;
+      entry.out_path = out_path;
+      std::tie(entry.err, entry.data_object) = opera(in_path, out_path);
+
+      auto done = done_bytes += sizes[i];
+      if (task != nullptr) task->ReportProgress(done, result.in_bytes);
+    }
+  };
+
+  std::vector<std::unique_ptr<QThread>> threads;
+  for (int i = 1; i < result.workers; i++) {
+    threads.emplace_back(QThread::create([&]() {
+      // so that cancelling the batch aborts the files in flight, too
+      if (task != nullptr) {
+        task->RunOnBehalf(worker);
+      } else {
+        worker();
+      }
+    }));
+    threads.back()->start();
+  }
+
+  // the calling thread is a worker as well
+  worker();
+  for (auto& thread : threads) thread->wait();
+
+  GpgError err = GPG_ERR_NO_ERROR;
+  for (const auto& entry : result.entries) {
+    if (CheckGpgError(entry.err) == GPG_ERR_NO_ERROR) {
+      result.succeeded++;
+      continue;
+    }
+    result.failed++;
+    if (err == GPG_ERR_NO_ERROR) err = entry.err;
+  }
+  result.elapsed = timer.elapsed();
+
+  GF_CORE_LOG_DEBUG(
+      "file batch done, files: {}, failed: {}, bytes: {}, workers: {}, "
+      "elapsed: {} ms",
+      files.size(), result.failed, result.in_bytes, result.workers,
+      result.elapsed);
+  return {err, result};
+}
 
 GpgFileOpera::GpgFileOpera(int channel)
-    : SingletonFunctionObject<GpgFileOpera>(channel) {}
+    : SingletonFunctionObject<GpgFileOpera>(channel),
+      map_input_file_(
+          GlobalSettingStation::GetInstance()
+              .GetSettings()
+              .value("gnupg/map_input_file_at_file_operation", false)
+              .toBool()) {}
+
+void GpgFileOpera::SetMapInputFile(bool map) { map_input_file_ = map; }
 
-void GpgFileOpera::EncryptFile(const KeyArgsList& keys, const QString& in_path,
+auto GpgFileOpera::EncryptFile(const KeyArgsList& keys, const QString& in_path,
                                bool ascii, const QString& out_path,
-                               const GpgOperationCallback& cb) {
-  RunGpgOperaAsync(
-      [=](const DataObjectPtr& data_object) -> GpgError {
+                               const GpgOperationCallback& cb)
+    -> Thread::Task::TaskHandler {
+  return RunGpgOperaAsync(
+      [=, map_input = map_input_file_.load()](
+          const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(ascii);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         std::vector<gpgme_key_t> recipients(keys.begin(), keys.end());
 
         // Last entry data_in array has to be nullptr
         recipients.emplace_back(nullptr);
 
-        GpgData data_in(in_path, true);
+        GpgData data_in(in_path, true, map_input);
+        TrackProgress(data_in, QFileInfo(in_path).size());
         GpgData data_out(out_path, false);
 
-        auto* ctx = ascii ? ctx_.DefaultContext() : ctx_.BinaryContext();
         auto err = CheckGpgError(gpgme_op_encrypt(ctx, recipients.data(),
                                                   GPGME_ENCRYPT_ALWAYS_TRUST,
                                                   data_in, data_out));
@@ -74,16 +248,20 @@ auto GpgFileOpera::EncryptFileSync(const KeyArgsList& keys,
                                    const QString& out_path)
     -> std::tuple<GpgError, DataObjectPtr> {
   return RunGpgOperaSync(
-      [=](const DataObjectPtr& data_object) -> GpgError {
+      [=, map_input = map_input_file_.load()](
+          const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(ascii);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         std::vector<gpgme_key_t> recipients(keys.begin(), keys.end());
 
         // Last entry data_in array has to be nullptr
         recipients.emplace_back(nullptr);
 
-        GpgData data_in(in_path, true);
+        GpgData data_in(in_path, true, map_input);
         GpgData data_out(out_path, false);
 
-        auto* ctx = ascii ? ctx_.DefaultContext() : ctx_.BinaryContext();
         auto err = CheckGpgError(gpgme_op_encrypt(ctx, recipients.data(),
                                                   GPGME_ENCRYPT_ALWAYS_TRUST,
                                                   data_in, data_out));
@@ -94,15 +272,22 @@ auto GpgFileOpera::EncryptFileSync(const KeyArgsList& keys,
       "gpgme_op_encrypt", "2.1.0");
 }
 
-void GpgFileOpera::EncryptDirectory(const KeyArgsList& keys,
+auto GpgFileOpera::EncryptDirectory(const KeyArgsList& keys,
                                     const QString& in_path, bool ascii,
                                     const QString& out_path,
-                                    const GpgOperationCallback& cb) {
+                                    const GpgOperationCallback& cb)
+    -> Thread::Task::TaskHandler {
   auto ex = std::make_shared<GFDataExchanger>(kDataExchangerSize);
+  const auto [filter, level] = ArchiveFileOperator::GetArchiveFilter();
+  const auto flags = ArchiveEncryptFlags(GPGME_ENCRYPT_ALWAYS_TRUST, filter);
   auto w_ex = std::weak_ptr<GFDataExchanger>(ex);
 
-  RunGpgOperaAsync(
+  auto handler = RunGpgOperaAsync(
       [=](const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(ascii);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         std::vector<gpgme_key_t> recipients(keys.begin(), keys.end());
 
         // Last entry data_in array has to be nullptr
@@ -113,9 +298,7 @@ void GpgFileOpera::EncryptDirectory(const KeyArgsList& keys,
 
         GF_CORE_LOG_DEBUG("encrypt directory start");
 
-        auto* ctx = ascii ? ctx_.DefaultContext() : ctx_.BinaryContext();
-        auto err = CheckGpgError(gpgme_op_encrypt(ctx, recipients.data(),
-                                                  GPGME_ENCRYPT_ALWAYS_TRUST,
+        auto err = CheckGpgError(gpgme_op_encrypt(ctx, recipients.data(), flags,
                                                   data_in, data_out));
         data_object->Swap({GpgEncryptResult(gpgme_op_encrypt_result(ctx))});
 
@@ -124,27 +307,37 @@ void GpgFileOpera::EncryptDirectory(const KeyArgsList& keys,
       },
       cb, "gpgme_op_encrypt", "2.1.0");
 
-  ArchiveFileOperator::NewArchive2DataExchanger(
-      in_path, ex, [=](GFError err, const DataObjectPtr&) {
+  auto archive_handler = ArchiveFileOperator::NewArchive2DataExchanger(
+      in_path, ex,
+      [=](GFError err, const DataObjectPtr&) {
         GF_CORE_LOG_DEBUG("new archive 2 data exchanger operation, err: {}",
                           err);
         if (decltype(ex) p_ex = w_ex.lock(); err < 0 && p_ex != nullptr) {
           ex->CloseWrite();
         }
-      });
+      },
+      filter, level);
+  LinkArchiveTask(handler, archive_handler, ex);
+  ForwardArchiveProgress(handler, archive_handler);
+  return handler;
 }
 
-void GpgFileOpera::DecryptFile(const QString& in_path, const QString& out_path,
-                               const GpgOperationCallback& cb) {
-  RunGpgOperaAsync(
-      [=](const DataObjectPtr& data_object) -> GpgError {
-        GpgData data_in(in_path, true);
+auto GpgFileOpera::DecryptFile(const QString& in_path, const QString& out_path,
+                               const GpgOperationCallback& cb)
+    -> Thread::Task::TaskHandler {
+  return RunGpgOperaAsync(
+      [=, map_input = map_input_file_.load()](
+          const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(true);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
+        GpgData data_in(in_path, true, map_input);
+        TrackProgress(data_in, QFileInfo(in_path).size());
         GpgData data_out(out_path, false);
 
-        auto err = CheckGpgError(
-            gpgme_op_decrypt(ctx_.DefaultContext(), data_in, data_out));
-        data_object->Swap(
-            {GpgDecryptResult(gpgme_op_decrypt_result(ctx_.DefaultContext()))});
+        auto err = CheckGpgError(gpgme_op_decrypt(ctx, data_in, data_out));
+        data_object->Swap({GpgDecryptResult(gpgme_op_decrypt_result(ctx))});
 
         return err;
       },
@@ -155,60 +348,77 @@ auto GpgFileOpera::DecryptFileSync(const QString& in_path,
                                    const QString& out_path)
     -> std::tuple<GpgError, DataObjectPtr> {
   return RunGpgOperaSync(
-      [=](const DataObjectPtr& data_object) -> GpgError {
-        GpgData data_in(in_path, true);
+      [=, map_input = map_input_file_.load()](
+          const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(true);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
+        GpgData data_in(in_path, true, map_input);
         GpgData data_out(out_path, false);
 
-        auto err = CheckGpgError(
-            gpgme_op_decrypt(ctx_.DefaultContext(), data_in, data_out));
-        data_object->Swap(
-            {GpgDecryptResult(gpgme_op_decrypt_result(ctx_.DefaultContext()))});
+        auto err = CheckGpgError(gpgme_op_decrypt(ctx, data_in, data_out));
+        data_object->Swap({GpgDecryptResult(gpgme_op_decrypt_result(ctx))});
 
         return err;
       },
       "gpgme_op_decrypt", "2.1.0");
 }
 
-void GpgFileOpera::DecryptArchive(const QString& in_path,
+auto GpgFileOpera::DecryptArchive(const QString& in_path,
                                   const QString& out_path,
-                                  const GpgOperationCallback& cb) {
+                                  const GpgOperationCallback& cb)
+    -> Thread::Task::TaskHandler {
   auto ex = std::make_shared<GFDataExchanger>(kDataExchangerSize);
 
-  ArchiveFileOperator::ExtractArchiveFromDataExchanger(
+  auto archive_handler = ArchiveFileOperator::ExtractArchiveFromDataExchanger(
       ex, out_path, [](GFError err, const DataObjectPtr&) {
         GF_CORE_LOG_DEBUG(
             "extract archive from data exchanger operation, err: {}", err);
       });
 
-  RunGpgOperaAsync(
-      [=](const DataObjectPtr& data_object) -> GpgError {
-        GpgData data_in(in_path, true);
+  auto handler = RunGpgOperaAsync(
+      [=, map_input = map_input_file_.load()](
+          const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(true);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
+        GpgData data_in(in_path, true, map_input);
+        TrackProgress(data_in, QFileInfo(in_path).size());
         GpgData data_out(ex);
 
-        auto err = CheckGpgError(
-            gpgme_op_decrypt(ctx_.DefaultContext(), data_in, data_out));
+        auto err = CheckGpgError(gpgme_op_decrypt(ctx, data_in, data_out));
 
-        data_object->Swap(
-            {GpgDecryptResult(gpgme_op_decrypt_result(ctx_.DefaultContext()))});
+        data_object->Swap({GpgDecryptResult(gpgme_op_decrypt_result(ctx))});
         return err;
       },
       cb, "gpgme_op_decrypt", "2.1.0");
+
+  LinkArchiveTask(handler, archive_handler, ex);
+  return handler;
 }
 
-void GpgFileOpera::SignFile(const KeyArgsList& keys, const QString& in_path,
+auto GpgFileOpera::SignFile(const KeyArgsList& keys, const QString& in_path,
                             bool ascii, const QString& out_path,
-                            const GpgOperationCallback& cb) {
-  RunGpgOperaAsync(
-      [=](const DataObjectPtr& data_object) -> GpgError {
+                            const GpgOperationCallback& cb)
+    -> Thread::Task::TaskHandler {
+  return RunGpgOperaAsync(
+      [=, map_input = map_input_file_.load()](
+          const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(ascii);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         GpgError err;
 
         // Set Singers of this opera
-        GpgBasicOperator::GetInstance().SetSigners(keys, ascii);
+        GpgBasicOperator::SetSigners(ctx, keys);
 
-        GpgData data_in(in_path, true);
+        GpgData data_in(in_path, true, map_input);
+        TrackProgress(data_in, QFileInfo(in_path).size());
         GpgData data_out(out_path, false);
 
-        auto* ctx = ascii ? ctx_.DefaultContext() : ctx_.BinaryContext();
         err = CheckGpgError(
             gpgme_op_sign(ctx, data_in, data_out, GPGME_SIG_MODE_DETACH));
 
@@ -224,16 +434,20 @@ auto GpgFileOpera::SignFileSync(const KeyArgsList& keys, const QString& in_path,
                                 bool ascii, const QString& out_path)
     -> std::tuple<GpgError, DataObjectPtr> {
   return RunGpgOperaSync(
-      [=](const DataObjectPtr& data_object) -> GpgError {
+      [=, map_input = map_input_file_.load()](
+          const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(ascii);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         GpgError err;
 
         // Set Singers of this opera
-        GpgBasicOperator::GetInstance().SetSigners(keys, ascii);
+        GpgBasicOperator::SetSigners(ctx, keys);
 
-        GpgData data_in(in_path, true);
+        GpgData data_in(in_path, true, map_input);
         GpgData data_out(out_path, false);
 
-        auto* ctx = ascii ? ctx_.DefaultContext() : ctx_.BinaryContext();
         err = CheckGpgError(
             gpgme_op_sign(ctx, data_in, data_out, GPGME_SIG_MODE_DETACH));
 
@@ -245,26 +459,31 @@ auto GpgFileOpera::SignFileSync(const KeyArgsList& keys, const QString& in_path,
       "gpgme_op_sign", "2.1.0");
 }
 
-void GpgFileOpera::VerifyFile(const QString& data_path,
+auto GpgFileOpera::VerifyFile(const QString& data_path,
                               const QString& sign_path,
-                              const GpgOperationCallback& cb) {
-  RunGpgOperaAsync(
-      [=](const DataObjectPtr& data_object) -> GpgError {
+                              const GpgOperationCallback& cb)
+    -> Thread::Task::TaskHandler {
+  return RunGpgOperaAsync(
+      [=, map_input = map_input_file_.load()](
+          const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(true);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         GpgError err;
 
-        GpgData data_in(data_path, true);
+        GpgData data_in(data_path, true, map_input);
+        TrackProgress(data_in, QFileInfo(data_path).size());
         GpgData data_out;
         if (!sign_path.isEmpty()) {
           GpgData sig_data(sign_path, true);
-          err = CheckGpgError(gpgme_op_verify(ctx_.DefaultContext(), sig_data,
-                                              data_in, nullptr));
+          err = CheckGpgError(gpgme_op_verify(ctx, sig_data, data_in, nullptr));
         } else {
-          err = CheckGpgError(gpgme_op_verify(ctx_.DefaultContext(), data_in,
-                                              nullptr, data_out));
+          err = CheckGpgError(gpgme_op_verify(ctx, data_in, nullptr, data_out));
         }
 
         data_object->Swap({
-            GpgVerifyResult(gpgme_op_verify_result(ctx_.DefaultContext())),
+            GpgVerifyResult(gpgme_op_verify_result(ctx)),
         });
 
         return err;
@@ -276,22 +495,25 @@ auto GpgFileOpera::VerifyFileSync(const QString& data_path,
                                   const QString& sign_path)
     -> std::tuple<GpgError, DataObjectPtr> {
   return RunGpgOperaSync(
-      [=](const DataObjectPtr& data_object) -> GpgError {
+      [=, map_input = map_input_file_.load()](
+          const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(true);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         GpgError err;
 
-        GpgData data_in(data_path, true);
+        GpgData data_in(data_path, true, map_input);
         GpgData data_out;
         if (!sign_path.isEmpty()) {
           GpgData sig_data(sign_path, true);
-          err = CheckGpgError(gpgme_op_verify(ctx_.DefaultContext(), sig_data,
-                                              data_in, nullptr));
+          err = CheckGpgError(gpgme_op_verify(ctx, sig_data, data_in, nullptr));
         } else {
-          err = CheckGpgError(gpgme_op_verify(ctx_.DefaultContext(), data_in,
-                                              nullptr, data_out));
+          err = CheckGpgError(gpgme_op_verify(ctx, data_in, nullptr, data_out));
         }
 
         data_object->Swap({
-            GpgVerifyResult(gpgme_op_verify_result(ctx_.DefaultContext())),
+            GpgVerifyResult(gpgme_op_verify_result(ctx)),
         });
 
         return err;
@@ -299,25 +521,31 @@ auto GpgFileOpera::VerifyFileSync(const QString& data_path,
       "gpgme_op_verify", "2.1.0");
 }
 
-void GpgFileOpera::EncryptSignFile(const KeyArgsList& keys,
+auto GpgFileOpera::EncryptSignFile(const KeyArgsList& keys,
                                    const KeyArgsList& signer_keys,
                                    const QString& in_path, bool ascii,
                                    const QString& out_path,
-                                   const GpgOperationCallback& cb) {
-  RunGpgOperaAsync(
-      [=](const DataObjectPtr& data_object) -> GpgError {
+                                   const GpgOperationCallback& cb)
+    -> Thread::Task::TaskHandler {
+  return RunGpgOperaAsync(
+      [=, map_input = map_input_file_.load()](
+          const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(ascii);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         GpgError err;
         std::vector<gpgme_key_t> recipients(keys.begin(), keys.end());
 
         // Last entry data_in array has to be nullptr
         recipients.emplace_back(nullptr);
 
-        GpgBasicOperator::GetInstance().SetSigners(signer_keys, ascii);
+        GpgBasicOperator::SetSigners(ctx, signer_keys);
 
-        GpgData data_in(in_path, true);
+        GpgData data_in(in_path, true, map_input);
+        TrackProgress(data_in, QFileInfo(in_path).size());
         GpgData data_out(out_path, false);
 
-        auto* ctx = ascii ? ctx_.DefaultContext() : ctx_.BinaryContext();
         err = CheckGpgError(gpgme_op_encrypt_sign(ctx, recipients.data(),
                                                   GPGME_ENCRYPT_ALWAYS_TRUST,
                                                   data_in, data_out));
@@ -337,19 +565,23 @@ auto GpgFileOpera::EncryptSignFileSync(const KeyArgsList& keys,
                                        const QString& out_path)
     -> std::tuple<GpgError, DataObjectPtr> {
   return RunGpgOperaSync(
-      [=](const DataObjectPtr& data_object) -> GpgError {
+      [=, map_input = map_input_file_.load()](
+          const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(ascii);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         GpgError err;
         std::vector<gpgme_key_t> recipients(keys.begin(), keys.end());
 
         // Last entry data_in array has to be nullptr
         recipients.emplace_back(nullptr);
 
-        GpgBasicOperator::GetInstance().SetSigners(signer_keys, ascii);
+        GpgBasicOperator::SetSigners(ctx, signer_keys);
 
-        GpgData data_in(in_path, true);
+        GpgData data_in(in_path, true, map_input);
         GpgData data_out(out_path, false);
 
-        auto* ctx = ascii ? ctx_.DefaultContext() : ctx_.BinaryContext();
         err = CheckGpgError(gpgme_op_encrypt_sign(ctx, recipients.data(),
                                                   GPGME_ENCRYPT_ALWAYS_TRUST,
                                                   data_in, data_out));
@@ -363,31 +595,36 @@ auto GpgFileOpera::EncryptSignFileSync(const KeyArgsList& keys,
       "gpgme_op_encrypt_sign", "2.1.0");
 }
 
-void GpgFileOpera::EncryptSignDirectory(const KeyArgsList& keys,
+auto GpgFileOpera::EncryptSignDirectory(const KeyArgsList& keys,
                                         const KeyArgsList& signer_keys,
                                         const QString& in_path, bool ascii,
                                         const QString& out_path,
-                                        const GpgOperationCallback& cb) {
+                                        const GpgOperationCallback& cb)
+    -> Thread::Task::TaskHandler {
   auto ex = std::make_shared<GFDataExchanger>(kDataExchangerSize);
+  const auto [filter, level] = ArchiveFileOperator::GetArchiveFilter();
+  const auto flags = ArchiveEncryptFlags(GPGME_ENCRYPT_ALWAYS_TRUST, filter);
   auto w_ex = std::weak_ptr<GFDataExchanger>(ex);
 
-  RunGpgOperaAsync(
+  auto handler = RunGpgOperaAsync(
       [=](const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(ascii);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         GpgError err;
         std::vector<gpgme_key_t> recipients(keys.begin(), keys.end());
 
         // Last entry data_in array has to be nullptr
         recipients.emplace_back(nullptr);
 
-        GpgBasicOperator::GetInstance().SetSigners(signer_keys, ascii);
+        GpgBasicOperator::SetSigners(ctx, signer_keys);
 
         GpgData data_in(ex);
         GpgData data_out(out_path, false);
 
-        auto* ctx = ascii ? ctx_.DefaultContext() : ctx_.BinaryContext();
         err = CheckGpgError(gpgme_op_encrypt_sign(ctx, recipients.data(),
-                                                  GPGME_ENCRYPT_ALWAYS_TRUST,
-                                                  data_in, data_out));
+                                                  flags, data_in, data_out));
 
         data_object->Swap({
             GpgEncryptResult(gpgme_op_encrypt_result(ctx)),
@@ -397,31 +634,42 @@ void GpgFileOpera::EncryptSignDirectory(const KeyArgsList& keys,
       },
       cb, "gpgme_op_encrypt_sign", "2.1.0");
 
-  ArchiveFileOperator::NewArchive2DataExchanger(
-      in_path, ex, [=](GFError err, const DataObjectPtr&) {
+  auto archive_handler = ArchiveFileOperator::NewArchive2DataExchanger(
+      in_path, ex,
+      [=](GFError err, const DataObjectPtr&) {
         GF_CORE_LOG_DEBUG("new archive 2 fd operation, err: {}", err);
         if (decltype(ex) p_ex = w_ex.lock(); err < 0 && p_ex != nullptr) {
           ex->CloseWrite();
         }
-      });
+      },
+      filter, level);
+  LinkArchiveTask(handler, archive_handler, ex);
+  ForwardArchiveProgress(handler, archive_handler);
+  return handler;
 }
 
-void GpgFileOpera::DecryptVerifyFile(const QString& in_path,
+auto GpgFileOpera::DecryptVerifyFile(const QString& in_path,
                                      const QString& out_path,
-                                     const GpgOperationCallback& cb) {
-  RunGpgOperaAsync(
-      [=](const DataObjectPtr& data_object) -> GpgError {
+                                     const GpgOperationCallback& cb)
+    -> Thread::Task::TaskHandler {
+  return RunGpgOperaAsync(
+      [=, map_input = map_input_file_.load()](
+          const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(true);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         GpgError err;
 
-        GpgData data_in(in_path, true);
+        GpgData data_in(in_path, true, map_input);
+        TrackProgress(data_in, QFileInfo(in_path).size());
         GpgData data_out(out_path, false);
 
-        err = CheckGpgError(
-            gpgme_op_decrypt_verify(ctx_.DefaultContext(), data_in, data_out));
+        err = CheckGpgError(gpgme_op_decrypt_verify(ctx, data_in, data_out));
 
         data_object->Swap({
-            GpgDecryptResult(gpgme_op_decrypt_result(ctx_.DefaultContext())),
-            GpgVerifyResult(gpgme_op_verify_result(ctx_.DefaultContext())),
+            GpgDecryptResult(gpgme_op_decrypt_result(ctx)),
+            GpgVerifyResult(gpgme_op_verify_result(ctx)),
         });
 
         return err;
@@ -433,18 +681,22 @@ auto GpgFileOpera::DecryptVerifyFileSync(const QString& in_path,
                                          const QString& out_path)
     -> std::tuple<GpgError, DataObjectPtr> {
   return RunGpgOperaSync(
-      [=](const DataObjectPtr& data_object) -> GpgError {
+      [=, map_input = map_input_file_.load()](
+          const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(true);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         GpgError err;
 
-        GpgData data_in(in_path, true);
+        GpgData data_in(in_path, true, map_input);
         GpgData data_out(out_path, false);
 
-        err = CheckGpgError(
-            gpgme_op_decrypt_verify(ctx_.DefaultContext(), data_in, data_out));
+        err = CheckGpgError(gpgme_op_decrypt_verify(ctx, data_in, data_out));
 
         data_object->Swap({
-            GpgDecryptResult(gpgme_op_decrypt_result(ctx_.DefaultContext())),
-            GpgVerifyResult(gpgme_op_verify_result(ctx_.DefaultContext())),
+            GpgDecryptResult(gpgme_op_decrypt_result(ctx)),
+            GpgVerifyResult(gpgme_op_verify_result(ctx)),
         });
 
         return err;
@@ -452,45 +704,60 @@ auto GpgFileOpera::DecryptVerifyFileSync(const QString& in_path,
       "gpgme_op_decrypt_verify", "2.1.0");
 }
 
-void GpgFileOpera::DecryptVerifyArchive(const QString& in_path,
+auto GpgFileOpera::DecryptVerifyArchive(const QString& in_path,
                                         const QString& out_path,
-                                        const GpgOperationCallback& cb) {
+                                        const GpgOperationCallback& cb)
+    -> Thread::Task::TaskHandler {
   auto ex = std::make_shared<GFDataExchanger>(kDataExchangerSize);
 
-  ArchiveFileOperator::ExtractArchiveFromDataExchanger(
+  auto archive_handler = ArchiveFileOperator::ExtractArchiveFromDataExchanger(
       ex, out_path, [](GFError err, const DataObjectPtr&) {
         GF_CORE_LOG_DEBUG("extract archive from ex operation, err: {}", err);
       });
 
-  RunGpgOperaAsync(
-      [=](const DataObjectPtr& data_object) -> GpgError {
+  auto handler = RunGpgOperaAsync(
+      [=, map_input = map_input_file_.load()](
+          const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(true);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         GpgError err;
 
-        GpgData data_in(in_path, true);
+        GpgData data_in(in_path, true, map_input);
+        TrackProgress(data_in, QFileInfo(in_path).size());
         GpgData data_out(ex);
 
-        err = CheckGpgError(
-            gpgme_op_decrypt_verify(ctx_.DefaultContext(), data_in, data_out));
+        err = CheckGpgError(gpgme_op_decrypt_verify(ctx, data_in, data_out));
 
         data_object->Swap({
-            GpgDecryptResult(gpgme_op_decrypt_result(ctx_.DefaultContext())),
-            GpgVerifyResult(gpgme_op_verify_result(ctx_.DefaultContext())),
+            GpgDecryptResult(gpgme_op_decrypt_result(ctx)),
+            GpgVerifyResult(gpgme_op_verify_result(ctx)),
         });
 
         return err;
       },
       cb, "gpgme_op_decrypt_verify", "2.1.0");
+
+  LinkArchiveTask(handler, archive_handler, ex);
+  return handler;
 }
 
-void GpgFileOpera::EncryptFileSymmetric(const QString& in_path, bool ascii,
+auto GpgFileOpera::EncryptFileSymmetric(const QString& in_path, bool ascii,
                                         const QString& out_path,
-                                        const GpgOperationCallback& cb) {
-  RunGpgOperaAsync(
-      [=](const DataObjectPtr& data_object) -> GpgError {
-        GpgData data_in(in_path, true);
+                                        const GpgOperationCallback& cb)
+    -> Thread::Task::TaskHandler {
+  return RunGpgOperaAsync(
+      [=, map_input = map_input_file_.load()](
+          const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(ascii);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
+        GpgData data_in(in_path, true, map_input);
+        TrackProgress(data_in, QFileInfo(in_path).size());
         GpgData data_out(out_path, false);
 
-        auto* ctx = ascii ? ctx_.DefaultContext() : ctx_.BinaryContext();
         auto err = CheckGpgError(gpgme_op_encrypt(
             ctx, nullptr, GPGME_ENCRYPT_SYMMETRIC, data_in, data_out));
         data_object->Swap({
@@ -506,11 +773,15 @@ auto GpgFileOpera::EncryptFileSymmetricSync(const QString& in_path, bool ascii,
                                             const QString& out_path)
     -> std::tuple<GpgError, DataObjectPtr> {
   return RunGpgOperaSync(
-      [=](const DataObjectPtr& data_object) -> GpgError {
-        GpgData data_in(in_path, true);
+      [=, map_input = map_input_file_.load()](
+          const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(ascii);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
+        GpgData data_in(in_path, true, map_input);
         GpgData data_out(out_path, false);
 
-        auto* ctx = ascii ? ctx_.DefaultContext() : ctx_.BinaryContext();
         auto err = CheckGpgError(gpgme_op_encrypt(
             ctx, nullptr, GPGME_ENCRYPT_SYMMETRIC, data_in, data_out));
         data_object->Swap({
@@ -522,19 +793,25 @@ auto GpgFileOpera::EncryptFileSymmetricSync(const QString& in_path, bool ascii,
       "gpgme_op_encrypt_symmetric", "2.1.0");
 }
 
-void GpgFileOpera::EncryptDerectorySymmetric(const QString& in_path, bool ascii,
+auto GpgFileOpera::EncryptDerectorySymmetric(const QString& in_path, bool ascii,
                                              const QString& out_path,
-                                             const GpgOperationCallback& cb) {
+                                             const GpgOperationCallback& cb)
+    -> Thread::Task::TaskHandler {
   auto ex = std::make_shared<GFDataExchanger>(kDataExchangerSize);
+  const auto [filter, level] = ArchiveFileOperator::GetArchiveFilter();
+  const auto flags = ArchiveEncryptFlags(GPGME_ENCRYPT_SYMMETRIC, filter);
 
-  RunGpgOperaAsync(
+  auto handler = RunGpgOperaAsync(
       [=](const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(ascii);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         GpgData data_in(ex);
         GpgData data_out(out_path, false);
 
-        auto* ctx = ascii ? ctx_.DefaultContext() : ctx_.BinaryContext();
         auto err = CheckGpgError(gpgme_op_encrypt(
-            ctx, nullptr, GPGME_ENCRYPT_SYMMETRIC, data_in, data_out));
+            ctx, nullptr, flags, data_in, data_out));
         data_object->Swap({
             GpgEncryptResult(gpgme_op_encrypt_result(ctx)),
         });
@@ -543,10 +820,15 @@ void GpgFileOpera::EncryptDerectorySymmetric(const QString& in_path, bool ascii,
       },
       cb, "gpgme_op_encrypt_symmetric", "2.1.0");
 
-  ArchiveFileOperator::NewArchive2DataExchanger(
-      in_path, ex, [=](GFError err, const DataObjectPtr&) {
+  auto archive_handler = ArchiveFileOperator::NewArchive2DataExchanger(
+      in_path, ex,
+      [=](GFError err, const DataObjectPtr&) {
         GF_CORE_LOG_DEBUG("new archive 2 fd operation, err: {}", err);
-      });
+      },
+      filter, level);
+  LinkArchiveTask(handler, archive_handler, ex);
+  ForwardArchiveProgress(handler, archive_handler);
+  return handler;
 }
 
 auto GpgFileOpera::EncryptDerectorySymmetricSync(const QString& in_path,
@@ -554,20 +836,27 @@ auto GpgFileOpera::EncryptDerectorySymmetricSync(const QString& in_path,
                                                  const QString& out_path)
     -> std::tuple<GpgError, DataObjectPtr> {
   auto ex = std::make_shared<GFDataExchanger>(kDataExchangerSize);
+  const auto [filter, level] = ArchiveFileOperator::GetArchiveFilter();
+  const auto flags = ArchiveEncryptFlags(GPGME_ENCRYPT_SYMMETRIC, filter);
 
   ArchiveFileOperator::NewArchive2DataExchanger(
-      in_path, ex, [=](GFError err, const DataObjectPtr&) {
+      in_path, ex,
+      [=](GFError err, const DataObjectPtr&) {
         GF_CORE_LOG_DEBUG("new archive 2 fd operation, err: {}", err);
-      });
+      },
+      filter, level);
 
   return RunGpgOperaSync(
       [=](const DataObjectPtr& data_object) -> GpgError {
+        auto holder = ctx_.AcquireContext(ascii);
+        if (holder == nullptr) return GPG_ERR_GENERAL;
+        auto* ctx = holder.get();
+
         GpgData data_in(ex);
         GpgData data_out(out_path, false);
 
-        auto* ctx = ascii ? ctx_.DefaultContext() : ctx_.BinaryContext();
         auto err = CheckGpgError(gpgme_op_encrypt(
-            ctx, nullptr, GPGME_ENCRYPT_SYMMETRIC, data_in, data_out));
+            ctx, nullptr, flags, data_in, data_out));
         data_object->Swap({
             GpgEncryptResult(gpgme_op_encrypt_result(ctx)),
         });
@@ -577,4 +866,101 @@ auto GpgFileOpera::EncryptDerectorySymmetricSync(const QString& in_path,
       "gpgme_op_encrypt_symmetric", "2.1.0");
 }
 
+auto GpgFileOpera::EncryptFiles(const KeyArgsList& keys,
+                                const GpgFilePathPairs& files, bool ascii,
+                                const GpgOperationCallback& cb)
+    -> Thread::Task::TaskHandler {
+  return RunGpgOperaAsync(
+      [=](const DataObjectPtr& data_object) -> GpgError {
+        auto [err, result] = RunFileBatch(
+            files, ctx_.ContextPoolSize(),
+            [=](const QString& in_path, const QString& out_path) {
+              return EncryptFileSync(keys, in_path, ascii, out_path);
+            });
+        data_object->Swap({result});
+        return err;
+      },
+      cb, "gpgme_op_encrypt", "2.1.0");
+}
+
+auto GpgFileOpera::EncryptFilesSync(const KeyArgsList& keys,
+                                    const GpgFilePathPairs& files, bool ascii)
+    -> std::tuple<GpgError, DataObjectPtr> {
+  return RunGpgOperaSync(
+      [=](const DataObjectPtr& data_object) -> GpgError {
+        auto [err, result] = RunFileBatch(
+            files, ctx_.ContextPoolSize(),
+            [=](const QString& in_path, const QString& out_path) {
+              return EncryptFileSync(keys, in_path, ascii, out_path);
+            });
+        data_object->Swap({result});
+        return err;
+      },
+      "gpgme_op_encrypt", "2.1.0");
+}
+
+auto GpgFileOpera::DecryptFiles(const GpgFilePathPairs& files,
+                                const GpgOperationCallback& cb)
+    -> Thread::Task::TaskHandler {
+  return RunGpgOperaAsync(
+      [=](const DataObjectPtr& data_object) -> GpgError {
+        auto [err, result] = RunFileBatch(
+            files, ctx_.ContextPoolSize(),
+            [=](const QString& in_path, const QString& out_path) {
+              return DecryptFileSync(in_path, out_path);
+            });
+        data_object->Swap({result});
+        return err;
+      },
+      cb, "gpgme_op_decrypt", "2.1.0");
+}
+
+auto GpgFileOpera::DecryptFilesSync(const GpgFilePathPairs& files)
+    -> std::tuple<GpgError, DataObjectPtr> {
+  return RunGpgOperaSync(
+      [=](const DataObjectPtr& data_object) -> GpgError {
+        auto [err, result] = RunFileBatch(
+            files, ctx_.ContextPoolSize(),
+            [=](const QString& in_path, const QString& out_path) {
+              return DecryptFileSync(in_path, out_path);
+            });
+        data_object->Swap({result});
+        return err;
+      },
+      "gpgme_op_decrypt", "2.1.0");
+}
+
+auto GpgFileOpera::SignFiles(const KeyArgsList& keys,
+                             const GpgFilePathPairs& files, bool ascii,
+                             const GpgOperationCallback& cb)
+    -> Thread::Task::TaskHandler {
+  return RunGpgOperaAsync(
+      [=](const DataObjectPtr& data_object) -> GpgError {
+        auto [err, result] = RunFileBatch(
+            files, ctx_.ContextPoolSize(),
+            [=](const QString& in_path, const QString& out_path) {
+              return SignFileSync(keys, in_path, ascii, out_path);
+            });
+        data_object->Swap({result});
+        return err;
+      },
+      cb, "gpgme_op_sign", "2.1.0");
+}
+
+auto GpgFileOpera::SignFilesSync(const KeyArgsList& keys,
+                                 const GpgFilePathPairs& files, bool ascii)
+    -> std::tuple<GpgError, DataObjectPtr> {
+  return RunGpgOperaSync(
+      [=](const DataObjectPtr& data_object) -> GpgError {
+        auto [err, result] = RunFileBatch(
+            files, ctx_.ContextPoolSize(),
+            [=](const QString& in_path, const QString& out_path) {
+              return SignFileSync(keys, in_path, ascii, out_path);
+            });
+        data_object->Swap({result});
+        return err;
+      },
+      "gpgme_op_sign", "2.1.0");
+}
+
 }  // namespace GpgFrontend
\ No newline at end of file
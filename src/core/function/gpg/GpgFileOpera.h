@@ -28,13 +28,19 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "core/function/basic/GpgFunctionObject.h"
 #include "core/function/gpg/GpgContext.h"
 #include "core/function/result_analyse/GpgResultAnalyse.h"
+#include "core/thread/Task.h"
 #include "core/typedef/GpgTypedef.h"
 
 namespace GpgFrontend {
 
+using GpgFilePathPairs =
+    std::vector<std::tuple<QString, QString>>;  ///< (in path, out path)
+
 /**
  * @brief Executive files related to the basic operations of GPG
  *
@@ -51,6 +57,16 @@ class GPGFRONTEND_CORE_EXPORT GpgFileOpera
   explicit GpgFileOpera(
       int channel = SingletonFunctionObject::GetDefaultChannel());
 
+  /**
+   * @brief read input files through a memory mapping instead of stdio, it
+   * falls back to the stream automatically when a file cannot be mapped.
+   * Operations take the mode when they are queued, those already queued
+   * keep theirs.
+   *
+   * @param map
+   */
+  void SetMapInputFile(bool map);
+
   /**
    * @brief Encrypted file with public key
    *
@@ -61,8 +77,9 @@ class GPGFRONTEND_CORE_EXPORT GpgFileOpera
    * @param channel Channel in context
    * @return unsigned int error code
    */
-  void EncryptFile(const KeyArgsList& keys, const QString& in_path, bool ascii,
-                   const QString& out_path, const GpgOperationCallback& cb);
+  auto EncryptFile(const KeyArgsList& keys, const QString& in_path, bool ascii,
+                   const QString& out_path, const GpgOperationCallback& cb)
+      -> Thread::Task::TaskHandler;
 
   /**
    * @brief
@@ -86,9 +103,10 @@ class GPGFRONTEND_CORE_EXPORT GpgFileOpera
    * @param out_path
    * @param cb
    */
-  void EncryptDirectory(const KeyArgsList& keys, const QString& in_path,
+  auto EncryptDirectory(const KeyArgsList& keys, const QString& in_path,
                         bool ascii, const QString& out_path,
-                        const GpgOperationCallback& cb);
+                        const GpgOperationCallback& cb)
+      -> Thread::Task::TaskHandler;
 
   /**
    * @brief Encrypted file symmetrically (with password)
@@ -99,9 +117,10 @@ class GPGFRONTEND_CORE_EXPORT GpgFileOpera
    * @param channel
    * @return unsigned int
    */
-  void EncryptFileSymmetric(const QString& in_path, bool ascii,
+  auto EncryptFileSymmetric(const QString& in_path, bool ascii,
                             const QString& out_path,
-                            const GpgOperationCallback& cb);
+                            const GpgOperationCallback& cb)
+      -> Thread::Task::TaskHandler;
 
   /**
    * @brief
@@ -123,9 +142,10 @@ class GPGFRONTEND_CORE_EXPORT GpgFileOpera
    * @param out_path
    * @param cb
    */
-  void EncryptDerectorySymmetric(const QString& in_path, bool ascii,
+  auto EncryptDerectorySymmetric(const QString& in_path, bool ascii,
                                  const QString& out_path,
-                                 const GpgOperationCallback& cb);
+                                 const GpgOperationCallback& cb)
+      -> Thread::Task::TaskHandler;
 
   /**
    * @brief
@@ -146,8 +166,8 @@ class GPGFRONTEND_CORE_EXPORT GpgFileOpera
    * @param result
    * @return GpgError
    */
-  void DecryptFile(const QString& in_path, const QString& out_path,
-                   const GpgOperationCallback& cb);
+  auto DecryptFile(const QString& in_path, const QString& out_path,
+                   const GpgOperationCallback& cb) -> Thread::Task::TaskHandler;
 
   /**
    * @brief
@@ -167,8 +187,9 @@ class GPGFRONTEND_CORE_EXPORT GpgFileOpera
    * @param out_path
    * @param cb
    */
-  void DecryptArchive(const QString& in_path, const QString& out_path,
-                      const GpgOperationCallback& cb);
+  auto DecryptArchive(const QString& in_path, const QString& out_path,
+                      const GpgOperationCallback& cb)
+      -> Thread::Task::TaskHandler;
 
   /**
    * @brief Sign file with private key
@@ -180,8 +201,9 @@ class GPGFRONTEND_CORE_EXPORT GpgFileOpera
    * @param channel
    * @return GpgError
    */
-  void SignFile(const KeyArgsList& keys, const QString& in_path, bool ascii,
-                const QString& out_path, const GpgOperationCallback& cb);
+  auto SignFile(const KeyArgsList& keys, const QString& in_path, bool ascii,
+                const QString& out_path, const GpgOperationCallback& cb)
+      -> Thread::Task::TaskHandler;
 
   /**
    * @brief
@@ -205,8 +227,8 @@ class GPGFRONTEND_CORE_EXPORT GpgFileOpera
    * @param channel Channel in context
    * @return GpgError
    */
-  void VerifyFile(const QString& data_path, const QString& sign_path,
-                  const GpgOperationCallback& cb);
+  auto VerifyFile(const QString& data_path, const QString& sign_path,
+                  const GpgOperationCallback& cb) -> Thread::Task::TaskHandler;
 
   /**
    * @brief
@@ -228,9 +250,10 @@ class GPGFRONTEND_CORE_EXPORT GpgFileOpera
    * @param out_path
    * @param cb
    */
-  void EncryptSignFile(const KeyArgsList& keys, const KeyArgsList& signer_keys,
+  auto EncryptSignFile(const KeyArgsList& keys, const KeyArgsList& signer_keys,
                        const QString& in_path, bool ascii,
-                       const QString& out_path, const GpgOperationCallback& cb);
+                       const QString& out_path, const GpgOperationCallback& cb)
+      -> Thread::Task::TaskHandler;
 
   /**
    * @brief
@@ -257,11 +280,12 @@ class GPGFRONTEND_CORE_EXPORT GpgFileOpera
    * @param out_path
    * @param cb
    */
-  void EncryptSignDirectory(const KeyArgsList& keys,
+  auto EncryptSignDirectory(const KeyArgsList& keys,
                             const KeyArgsList& signer_keys,
                             const QString& in_path, bool ascii,
                             const QString& out_path,
-                            const GpgOperationCallback& cb);
+                            const GpgOperationCallback& cb)
+      -> Thread::Task::TaskHandler;
 
   /**
    * @brief
@@ -272,8 +296,9 @@ class GPGFRONTEND_CORE_EXPORT GpgFileOpera
    * @param verify_res
    * @return GpgError
    */
-  void DecryptVerifyFile(const QString& in_path, const QString& out_path,
-                         const GpgOperationCallback& cb);
+  auto DecryptVerifyFile(const QString& in_path, const QString& out_path,
+                         const GpgOperationCallback& cb)
+      -> Thread::Task::TaskHandler;
 
   /**
    * @brief
@@ -291,12 +316,81 @@ class GPGFRONTEND_CORE_EXPORT GpgFileOpera
    * @param out_path
    * @param cb
    */
-  void DecryptVerifyArchive(const QString& in_path, const QString& out_path,
-                            const GpgOperationCallback& cb);
+  auto DecryptVerifyArchive(const QString& in_path, const QString& out_path,
+                            const GpgOperationCallback& cb)
+      -> Thread::Task::TaskHandler;
+
+  /**
+   * @brief encrypt every (in, out) pair of files. Up to ContextPoolSize()
+   * files are processed at the same time, each on its own pooled context.
+   *
+   * @param keys
+   * @param files
+   * @param ascii
+   * @param cb receives a GpgFileBatchResult, the error is the first failure
+   */
+  auto EncryptFiles(const KeyArgsList& keys, const GpgFilePathPairs& files,
+                    bool ascii, const GpgOperationCallback& cb)
+      -> Thread::Task::TaskHandler;
+
+  /**
+   * @brief
+   *
+   * @param keys
+   * @param files
+   * @param ascii
+   * @return std::tuple<GpgError, DataObjectPtr>
+   */
+  auto EncryptFilesSync(const KeyArgsList& keys, const GpgFilePathPairs& files,
+                        bool ascii) -> std::tuple<GpgError, DataObjectPtr>;
+
+  /**
+   * @brief decrypt every (in, out) pair of files, see EncryptFiles()
+   *
+   * @param files
+   * @param cb
+   */
+  auto DecryptFiles(const GpgFilePathPairs& files,
+                    const GpgOperationCallback& cb)
+      -> Thread::Task::TaskHandler;
+
+  /**
+   * @brief
+   *
+   * @param files
+   * @return std::tuple<GpgError, DataObjectPtr>
+   */
+  auto DecryptFilesSync(const GpgFilePathPairs& files)
+      -> std::tuple<GpgError, DataObjectPtr>;
+
+  /**
+   * @brief make a detached signature for every (in, out) pair of files, see
+   * EncryptFiles()
+   *
+   * @param keys
+   * @param files
+   * @param ascii
+   * @param cb
+   */
+  auto SignFiles(const KeyArgsList& keys, const GpgFilePathPairs& files,
+                 bool ascii, const GpgOperationCallback& cb)
+      -> Thread::Task::TaskHandler;
+
+  /**
+   * @brief
+   *
+   * @param keys
+   * @param files
+   * @param ascii
+   * @return std::tuple<GpgError, DataObjectPtr>
+   */
+  auto SignFilesSync(const KeyArgsList& keys, const GpgFilePathPairs& files,
+                     bool ascii) -> std::tuple<GpgError, DataObjectPtr>;
 
  private:
   GpgContext& ctx_ = GpgContext::GetInstance(
       SingletonFunctionObject::GetChannel());  ///< Corresponding context
+  std::atomic_bool map_input_file_;            ///<
 };
 
 }  // namespace GpgFrontend
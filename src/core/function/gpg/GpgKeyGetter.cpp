@@ -30,15 +30,405 @@
 
 #include <gpg-error.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <iterator>
+#include <memory>
 #include <mutex>
-#include <shared_mutex>
 
 #include "core/GpgModel.h"
 #include "core/function/gpg/GpgContext.h"
+#include "core/function/gpg/GpgKeyMetadataStore.h"
+#include "core/model/GpgKeySummaryTable.h"
 #include "core/utils/GpgUtils.h"
 
 namespace GpgFrontend {
 
+// what the key tables show, certifications and tofu records are left out
+constexpr gpgme_keylist_mode_t kSummaryKeyListMode =
+    GPGME_KEYLIST_MODE_LOCAL | GPGME_KEYLIST_MODE_WITH_SECRET;
+
+constexpr int kKeyDetailCacheSize = 64;
+
+constexpr int kShortKeyIdLength = 8;
+
+/**
+ * @brief turn a key id or fingerprint query into the form gpgme reports,
+ * other queries are returned as they are
+ *
+ * @param query
+ * @return QString
+ */
+auto NormalizeKeyQuery(const QString& query) -> QString {
+  const auto trimmed = query.trimmed();
+  auto hex = trimmed;
+  if (hex.startsWith("0x", Qt::CaseInsensitive)) hex.remove(0, 2);
+  if (hex.isEmpty()) return trimmed;
+
+  for (const auto& c : hex) {
+    if (std::isxdigit(static_cast<unsigned char>(c.toLatin1())) == 0) {
+      return trimmed;
+    }
+  }
+  return hex.toUpper();
+}
+
+/**
+ * @brief the lower cased text a key table keyword is searched in
+ *
+ * @param key
+ * @return QString
+ */
+auto GetKeySearchText(const GpgKey& key) -> QString {
+  QStringList infos;
+  for (const auto& uid : key.GetUIDView()) infos << uid.GetUID();
+  for (const auto& subkey : key.GetSubKeyView()) {
+    infos << subkey.GetFingerprint() << subkey.GetID();
+  }
+
+  // the separator keeps a keyword from matching across two fields
+  return infos.join('\n').toLower();
+}
+
+/**
+ * @brief inverted index from the trigrams of the search text to the keys,
+ * a keyword is looked up by intersecting the lists of its trigrams and
+ * then checking the few keys left
+ *
+ */
+class KeyKeywordIndex {
+ public:
+  using Trigram = quint64;
+
+  void Add(const GpgKey& key) {
+    const auto text = GetKeySearchText(key);
+
+    // a key replaced or removed before leaves its slot to the next one
+    quint32 slot;
+    if (!free_slots_.isEmpty()) {
+      slot = free_slots_.takeLast();
+      fprs_[slot] = key.GetFingerprint();
+      texts_[slot] = text;
+    } else {
+      slot = static_cast<quint32>(fprs_.size());
+      fprs_.push_back(key.GetFingerprint());
+      texts_.push_back(text);
+    }
+    slots_.insert(key.GetFingerprint(), slot);
+
+    // the lists stay sorted, a new slot is simply appended
+    for (const auto& trigram : trigrams(text)) {
+      auto& list = postings_[trigram];
+      if (list.isEmpty() || list.back() < slot) {
+        list.push_back(slot);
+      } else {
+        list.insert(std::lower_bound(list.begin(), list.end(), slot), slot);
+      }
+    }
+  }
+
+  void Remove(const QString& fpr) {
+    auto it = slots_.find(fpr);
+    if (it == slots_.end()) return;
+    const auto slot = it.value();
+    slots_.erase(it);
+
+    for (const auto& trigram : trigrams(texts_[slot])) {
+      auto posting = postings_.find(trigram);
+      if (posting == postings_.end()) continue;
+
+      auto& list = posting.value();
+      auto pos = std::lower_bound(list.begin(), list.end(), slot);
+      if (pos != list.end() && *pos == slot) list.erase(pos);
+      if (list.isEmpty()) postings_.erase(posting);
+    }
+
+    fprs_[slot].clear();
+    texts_[slot].clear();
+    free_slots_.push_back(slot);
+  }
+
+  [[nodiscard]] auto Search(const QString& keyword) const -> QSet<QString> {
+    const auto lower = keyword.toLower();
+    QSet<QString> matches;
+
+    // too short for a trigram, check every key
+    if (lower.size() < 3) {
+      for (const auto& slot : slots_) {
+        if (texts_[slot].contains(lower)) matches.insert(fprs_[slot]);
+      }
+      return matches;
+    }
+
+    std::vector<const QVector<quint32>*> lists;
+    for (const auto& trigram : trigrams(lower)) {
+      auto posting = postings_.find(trigram);
+      if (posting == postings_.end()) return matches;
+      lists.push_back(&posting.value());
+    }
+
+    std::sort(lists.begin(), lists.end(), [](const auto* a, const auto* b) {
+      return a->size() < b->size();
+    });
+
+    std::vector<quint32> candidates(lists.front()->begin(),
+                                    lists.front()->end());
+    for (auto it = lists.begin() + 1;
+         it != lists.end() && candidates.size() > 1; ++it) {
+      std::vector<quint32> common;
+      std::set_intersection(candidates.begin(), candidates.end(),
+                            (*it)->begin(), (*it)->end(),
+                            std::back_inserter(common));
+      candidates.swap(common);
+    }
+
+    // the trigrams may be scattered, confirm the keyword itself
+    for (const auto& slot : candidates) {
+      if (texts_[slot].contains(lower)) matches.insert(fprs_[slot]);
+    }
+    return matches;
+  }
+
+ private:
+  QVector<QString> fprs_;                      ///< by slot, empty if removed
+  QVector<QString> texts_;                     ///< search text by slot
+  QHash<QString, quint32> slots_;              ///< fingerprint to slot
+  QHash<Trigram, QVector<quint32>> postings_;  ///< trigram to sorted slots
+  QVector<quint32> free_slots_;                ///< of the removed keys
+
+  static auto trigrams(const QString& text) -> std::vector<Trigram> {
+    std::vector<Trigram> ret;
+    if (text.size() < 3) return ret;
+
+    ret.reserve(text.size() - 2);
+    for (int i = 0; i + 2 < text.size(); i++) {
+      ret.push_back(static_cast<Trigram>(text[i].unicode()) << 32 |
+                    static_cast<Trigram>(text[i + 1].unicode()) << 16 |
+                    text[i + 2].unicode());
+    }
+
+    std::sort(ret.begin(), ret.end());
+    ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+    return ret;
+  }
+};
+
+/**
+ * @brief whether a listed key differs from the cached one in anything the
+ * key tables or the key details show
+ *
+ * @param cached
+ * @param listed
+ * @return true
+ * @return false
+ */
+auto IsKeyStateChanged(const GpgKey& cached, const GpgKey& listed) -> bool {
+  if (cached.IsPrivateKey() != listed.IsPrivateKey() ||
+      cached.IsHasMasterKey() != listed.IsHasMasterKey() ||
+      cached.IsExpired() != listed.IsExpired() ||
+      cached.IsRevoked() != listed.IsRevoked() ||
+      cached.IsDisabled() != listed.IsDisabled() ||
+      cached.GetOwnerTrustLevel() != listed.GetOwnerTrustLevel() ||
+      cached.GetExpireTime() != listed.GetExpireTime() ||
+      cached.IsHasEncryptionCapability() !=
+          listed.IsHasEncryptionCapability() ||
+      cached.IsHasSigningCapability() != listed.IsHasSigningCapability() ||
+      cached.IsHasCertificationCapability() !=
+          listed.IsHasCertificationCapability() ||
+      cached.IsHasAuthenticationCapability() !=
+          listed.IsHasAuthenticationCapability()) {
+    return true;
+  }
+
+  // walk both lists side by side, nothing is copied out of the keys
+  auto cached_subkeys = cached.GetSubKeyView();
+  auto listed_subkeys = listed.GetSubKeyView();
+  auto subkey_it = listed_subkeys.begin();
+  for (const auto& a : cached_subkeys) {
+    if (subkey_it == listed_subkeys.end()) return true;
+    const auto b = *subkey_it++;
+    if (a.GetFingerprint() != b.GetFingerprint() ||
+        a.GetExpireTime() != b.GetExpireTime() ||
+        a.IsExpired() != b.IsExpired() || a.IsRevoked() != b.IsRevoked() ||
+        a.IsDisabled() != b.IsDisabled() ||
+        a.IsSecretKey() != b.IsSecretKey() || a.IsCardKey() != b.IsCardKey() ||
+        a.IsHasEncryptionCapability() != b.IsHasEncryptionCapability() ||
+        a.IsHasSigningCapability() != b.IsHasSigningCapability() ||
+        a.IsHasCertificationCapability() !=
+            b.IsHasCertificationCapability() ||
+        a.IsHasAuthenticationCapability() !=
+            b.IsHasAuthenticationCapability()) {
+      return true;
+    }
+  }
+  if (subkey_it != listed_subkeys.end()) return true;
+
+  auto cached_uids = cached.GetUIDView();
+  auto listed_uids = listed.GetUIDView();
+  auto uid_it = listed_uids.begin();
+  for (const auto& a : cached_uids) {
+    if (uid_it == listed_uids.end()) return true;
+    const auto b = *uid_it++;
+    if (a.GetUID() != b.GetUID() || a.GetRevoked() != b.GetRevoked() ||
+        a.GetInvalid() != b.GetInvalid() ||
+        a.GetValidity() != b.GetValidity()) {
+      return true;
+    }
+  }
+  if (uid_it != listed_uids.end()) return true;
+
+  return false;
+}
+
+/**
+ * @brief an immutable state of the keys cache
+ *
+ */
+struct KeyCacheSnapshot {
+  GpgKeyLinkList keys;                          ///< in the order of the listing
+  QHash<QString, GpgKey> index;                 ///< by subkey ids and fprs
+  QMultiHash<QString, QString> short_id_index;  ///< short id to fingerprints
+  QMultiHash<QString, QString> email_index;     ///< email to fingerprints
+  QMultiHash<QString, QString> uid_index;       ///< uid to fingerprints
+  KeyKeywordIndex keyword_index;                ///< for the key tables
+
+  KeyCacheSnapshot() = default;
+
+  // the positions point into the list they were taken from, a copy takes
+  // them again from its own
+  KeyCacheSnapshot(const KeyCacheSnapshot& other)
+      : keys(other.keys),
+        index(other.index),
+        short_id_index(other.short_id_index),
+        email_index(other.email_index),
+        uid_index(other.uid_index),
+        keyword_index(other.keyword_index) {
+    positions_.reserve(static_cast<int>(keys.size()));
+    for (auto it = keys.begin(); it != keys.end(); ++it) {
+      positions_.insert(it->GetFingerprint(), it);
+    }
+  }
+
+  auto operator=(const KeyCacheSnapshot&) -> KeyCacheSnapshot& = delete;
+
+  void Append(const GpgKey& key) {
+    keys.push_back(key);
+    positions_.insert(key.GetFingerprint(), std::prev(keys.end()));
+    add_to_index(key);
+  }
+
+  auto Replace(const GpgKey& key) -> bool {
+    auto it = Find(key.GetFingerprint());
+    if (it == keys.end()) return false;
+
+    // subkeys and uids may come and go, index the key from scratch
+    remove_from_index(*it);
+    *it = key;
+    add_to_index(key);
+    return true;
+  }
+
+  auto Remove(const QString& fpr) -> bool {
+    auto it = Find(fpr);
+    if (it == keys.end()) return false;
+
+    remove_from_index(*it);
+    positions_.remove(fpr);
+    keys.erase(it);
+    return true;
+  }
+
+  auto Find(const QString& fpr) -> GpgKeyLinkList::iterator {
+    auto it = positions_.find(fpr);
+    return it != positions_.end() ? it.value() : keys.end();
+  }
+
+  /**
+   * @brief resolve a key id, fingerprint, short id, email or uid, a bad key
+   * is returned when nothing or more than one key matches
+   *
+   * @param query
+   * @return GpgKey
+   */
+  [[nodiscard]] auto Lookup(const QString& query) const -> GpgKey {
+    const auto normalized = NormalizeKeyQuery(query);
+    if (normalized.isEmpty()) return {};
+
+    auto it = index.find(normalized);
+    if (it != index.end()) return it.value();
+
+    if (normalized.size() == kShortKeyIdLength) {
+      auto key = lookup_unique(short_id_index, normalized);
+      if (key.IsGood()) return key;
+    }
+
+    if (normalized.contains('@')) {
+      auto email = normalized;
+      if (email.startsWith('<') && email.endsWith('>')) {
+        email = email.mid(1, email.size() - 2);
+      }
+      auto key = lookup_unique(email_index, email.toLower());
+      if (key.IsGood()) return key;
+    }
+
+    return lookup_unique(uid_index, normalized);
+  }
+
+ private:
+  QHash<QString, GpgKeyLinkList::iterator> positions_;  ///< by fingerprint
+
+  void add_to_index(const GpgKey& key) {
+    const auto fpr = key.GetFingerprint();
+    index.insert(key.GetId(), key);
+    index.insert(fpr, key);
+    keyword_index.Add(key);
+
+    for (const auto& subkey : key.GetSubKeyView()) {
+      index.insert(subkey.GetID(), key);
+      index.insert(subkey.GetFingerprint(), key);
+      short_id_index.insert(subkey.GetID().right(kShortKeyIdLength), fpr);
+      if (!subkey.GetKeyGrip().isEmpty()) {
+        index.insert("&" + subkey.GetKeyGrip(), key);
+      }
+    }
+
+    for (const auto& uid : key.GetUIDView()) {
+      if (!uid.GetEmail().isEmpty()) {
+        email_index.insert(uid.GetEmail().toLower(), fpr);
+      }
+      uid_index.insert(uid.GetUID(), fpr);
+    }
+  }
+
+  void remove_from_index(const GpgKey& key) {
+    const auto fpr = key.GetFingerprint();
+    index.remove(key.GetId());
+    index.remove(fpr);
+    keyword_index.Remove(fpr);
+
+    for (const auto& subkey : key.GetSubKeyView()) {
+      index.remove(subkey.GetID());
+      index.remove(subkey.GetFingerprint());
+      short_id_index.remove(subkey.GetID().right(kShortKeyIdLength), fpr);
+      index.remove("&" + subkey.GetKeyGrip());
+    }
+
+    for (const auto& uid : key.GetUIDView()) {
+      email_index.remove(uid.GetEmail().toLower(), fpr);
+      uid_index.remove(uid.GetUID(), fpr);
+    }
+  }
+
+  [[nodiscard]] auto lookup_unique(const QMultiHash<QString, QString>& hash,
+                                   const QString& key) const -> GpgKey {
+    auto fprs = hash.values(key);
+    fprs.removeDuplicates();
+    if (fprs.size() != 1) return {};
+    return index.value(fprs.front());
+  }
+};
+
 class GpgKeyGetter::Impl : public SingletonFunctionObject<GpgKeyGetter::Impl> {
  public:
   explicit Impl(int channel)
@@ -76,71 +466,199 @@ class GpgKeyGetter::Impl : public SingletonFunctionObject<GpgKeyGetter::Impl> {
     return GpgKey(std::move(p_key));
   }
 
-  auto FetchKey() -> KeyLinkListPtr {
-    if (keys_search_cache_.empty()) {
-      FlushKeyCache();
+  auto FetchKey() -> KeyListSnapshotPtr {
+    auto snapshot = load_snapshot();
+    if (snapshot == nullptr) {
+      // wait for a listing in progress rather than starting another one
+      std::lock_guard<std::mutex> lock(flush_mutex_);
+      if (load_snapshot() == nullptr) flush_key_cache();
+      snapshot = load_snapshot();
     }
+    if (snapshot == nullptr) return std::make_shared<const GpgKeyLinkList>();
 
-    auto keys_list = std::make_unique<GpgKeyLinkList>();
+    // shares the ownership of the snapshot, nothing is copied
+    return {snapshot, &snapshot->keys};
+  }
+
+  auto SearchKeys(const QString& keyword) -> QSet<QString> {
+    auto snapshot = load_snapshot();
+    if (snapshot == nullptr) return {};
+    return snapshot->keyword_index.Search(keyword);
+  }
+
+  auto GetKeySummary(const KeyListSnapshotPtr& keys) -> KeySummaryTablePtr {
     {
-      // get the lock
-      std::lock_guard<std::mutex> lock(keys_cache_mutex_);
-      for (const auto& key : keys_cache_) {
-        keys_list->push_back(key);
-      }
+      std::lock_guard<std::mutex> lock(summary_mutex_);
+      if (summary_ != nullptr && summary_->GetKeys() == keys) return summary_;
     }
-    return keys_list;
+
+    // published along with the snapshot for the default channel, taken
+    // here outside of the lock otherwise, a table racing for the same
+    // snapshot is simply dropped
+    auto summary = std::make_shared<const GpgKeySummaryTable>(keys);
+
+    std::lock_guard<std::mutex> lock(summary_mutex_);
+    if (summary_ != nullptr && summary_->GetKeys() == keys) return summary_;
+    summary_ = summary;
+    return summary;
   }
 
   auto FlushKeyCache() -> bool {
-    GF_CORE_LOG_DEBUG("flush key channel called, channel: {}", GetChannel());
+    std::lock_guard<std::mutex> lock(flush_mutex_);
+    return flush_key_cache();
+  }
+
+  auto IsKeyCacheLoaded() const -> bool { return load_snapshot() != nullptr; }
+
+  auto GetKeyDetail(const QString& key_id) -> GpgKey {
+    auto key = get_key_in_cache(key_id);
+    const auto fpr = key.IsGood() ? key.GetFingerprint() : key_id;
+    {
+      std::lock_guard<std::mutex> lock(keys_detail_cache_mutex_);
+      auto it = keys_detail_cache_.find(fpr);
+      if (it != keys_detail_cache_.end()) return it.value();
+    }
 
-    // clear the keys cache
-    keys_cache_.clear();
-    keys_search_cache_.clear();
+    // the default context lists signatures, notations and tofu information
+    // and, with WITH_SECRET, the secret parts too. asking for the secret key
+    // instead would list in secret mode, which drops the signatures
+    gpgme_key_t p_key = nullptr;
+    gpgme_get_key(ctx_.DefaultContext(), fpr.toUtf8(), &p_key, 0);
+    if (p_key == nullptr) {
+      GF_CORE_LOG_WARN("cannot get the detail of key: {}", key_id);
+      return {};
+    }
 
-    // init
-    GpgError err = gpgme_op_keylist_start(ctx_.DefaultContext(), nullptr, 0);
+    auto detail = GpgKey(std::move(p_key));
+    std::lock_guard<std::mutex> lock(keys_detail_cache_mutex_);
+    if (keys_detail_cache_.size() >= kKeyDetailCacheSize) {
+      keys_detail_cache_.clear();
+    }
+    keys_detail_cache_.insert(detail.GetFingerprint(), detail);
+    return detail;
+  }
 
-    // for debug
-    assert(CheckGpgError(err) == GPG_ERR_NO_ERROR);
+  auto ReconcileKeys() -> GpgKeyCacheChanges {
+    GpgKeyCacheChanges changes;
+    if (load_snapshot() == nullptr) return first_listing_changes();
 
-    // return when error
-    if (CheckGpgError(err) != GPG_ERR_NO_ERROR) return false;
+    const auto stamp = get_key_database_stamp();
+    QList<GpgKey> listed;
+    if (!list_keys({}, listed)) return changes;
 
     {
-      // get the lock
-      std::lock_guard<std::mutex> lock(keys_cache_mutex_);
-      gpgme_key_t key;
-      while ((err = gpgme_op_keylist_next(ctx_.DefaultContext(), &key)) ==
-             GPG_ERR_NO_ERROR) {
-        auto gpg_key = GpgKey(std::move(key));
-
-        // detect if the key is in a smartcard
-        // if so, try to get full information using gpgme_get_key()
-        // this maybe a bug in gpgme
-        if (gpg_key.IsHasCardKey()) {
-          gpg_key = GetKey(gpg_key.GetId(), false);
+      std::lock_guard<std::mutex> lock(keys_cache_write_mutex_);
+      auto snapshot = load_snapshot();
+      const auto stamp_changed = stamp != listed_stamp_;
+      listed_stamp_ = stamp;
+
+      QSet<QString> listed_fprs;
+      QHash<QString, GpgKey> changed_keys;
+      for (const auto& key : listed) {
+        const auto fpr = key.GetFingerprint();
+        listed_fprs.insert(fpr);
+
+        auto it = snapshot->index.find(fpr);
+        if (it == snapshot->index.end()) {
+          changes.added.append(fpr);
+          changed_keys.insert(fpr, key);
+        } else if (IsKeyStateChanged(it.value(), key)) {
+          changes.updated.append(fpr);
+          changed_keys.insert(fpr, key);
+        }
+      }
+
+      for (const auto& key : snapshot->keys) {
+        if (!listed_fprs.contains(key.GetFingerprint())) {
+          changes.removed.append(key.GetFingerprint());
         }
+      }
 
-        keys_cache_.push_back(gpg_key);
-        keys_search_cache_.insert(gpg_key.GetId(), gpg_key);
-        keys_search_cache_.insert(gpg_key.GetFingerprint(), gpg_key);
+      // the readers keep the snapshot they have when nothing changed
+      if (!changes.Empty()) {
+        snapshot = reconciled_snapshot(*snapshot, listed, changes,
+                                       changed_keys);
+        publish_snapshot(snapshot);
       }
+
+      // a targeted refresh may have dropped the stored metadata
+      if (!changes.Empty() || stamp_changed) store_metadata(stamp, snapshot);
     }
+    if (changes.Empty()) return changes;
 
-    GF_CORE_LOG_DEBUG("flush key channel cache address: {} object address: {}",
-                      static_cast<void*>(&keys_search_cache_),
-                      static_cast<void*>(this));
+    invalidate_key_details(changes);
 
-    // for debug
-    assert(CheckGpgError2ErrCode(err, GPG_ERR_EOF) == GPG_ERR_EOF);
+    GF_CORE_LOG_DEBUG(
+        "reconcile keys done, channel: {}, added: {}, updated: {}, removed: "
+        "{}",
+        GetChannel(), changes.added.size(), changes.updated.size(),
+        changes.removed.size());
+    return changes;
+  }
 
-    err = gpgme_op_keylist_end(ctx_.DefaultContext());
-    assert(CheckGpgError2ErrCode(err, GPG_ERR_EOF) == GPG_ERR_NO_ERROR);
+  auto RefreshKeys(const KeyIdArgsList& key_ids) -> GpgKeyCacheChanges {
+    GpgKeyCacheChanges changes;
+    if (key_ids.empty()) return changes;
 
-    GF_CORE_LOG_DEBUG("flush key channel done, channel: {}", GetChannel());
-    return true;
+    // nothing to patch before the first full listing
+    if (load_snapshot() == nullptr) return first_listing_changes();
+
+    // the cached keys the arguments refer to, what is not listed again
+    // has been deleted
+    QStringList missing;
+    for (const auto& key_id : key_ids) {
+      auto key = get_key_in_cache(key_id);
+      if (key.IsGood() && !missing.contains(key.GetFingerprint())) {
+        missing.append(key.GetFingerprint());
+      }
+    }
+
+    const auto stamp = get_key_database_stamp();
+    QList<GpgKey> listed;
+    if (!list_keys(key_ids, listed)) return changes;
+
+    {
+      // writers patch a copy of the latest snapshot, one at a time
+      std::lock_guard<std::mutex> lock(keys_cache_write_mutex_);
+      auto snapshot = std::make_shared<KeyCacheSnapshot>(*load_snapshot());
+
+      for (const auto& key : listed) {
+        const auto fpr = key.GetFingerprint();
+        missing.removeAll(fpr);
+
+        if (snapshot->Replace(key)) {
+          changes.updated.append(fpr);
+        } else {
+          snapshot->Append(key);
+          changes.added.append(fpr);
+        }
+      }
+
+      for (const auto& fpr : missing) {
+        if (snapshot->Remove(fpr)) changes.removed.append(fpr);
+      }
+
+      publish_snapshot(snapshot);
+
+      // only a complete listing vouches for the other keys, once the key
+      // database moved on from it, by our write or another, the stored
+      // metadata waits for the next one
+      if (!changes.Empty()) {
+        if (stamp == listed_stamp_) {
+          store_metadata(stamp, snapshot);
+        } else {
+          drop_metadata();
+        }
+      }
+    }
+
+    invalidate_key_details(changes);
+
+    GF_CORE_LOG_DEBUG(
+        "refresh keys done, channel: {}, added: {}, updated: {}, removed: {}",
+        GetChannel(), changes.added.size(), changes.updated.size(),
+        changes.removed.size());
+    return changes;
   }
 
   auto GetKeys(const KeyIdArgsListPtr& ids) -> KeyListPtr {
@@ -180,22 +698,249 @@ class GpgKeyGetter::Impl : public SingletonFunctionObject<GpgKeyGetter::Impl> {
   mutable std::mutex ctx_mutex_;
 
   /**
-   * @brief cache the keys with key id
+   * @brief the keys in the cache, never changed once published, readers
+   * load it atomically and writers swap in a patched copy
    *
    */
-  QMap<QString, GpgKey> keys_search_cache_;
+  std::shared_ptr<const KeyCacheSnapshot> keys_cache_;
 
   /**
-   * @brief
+   * @brief serializes the writers of the keys cache, readers never take it
    *
    */
-  QList<GpgKey> keys_cache_;
+  mutable std::mutex keys_cache_write_mutex_;
 
   /**
-   * @brief shared mutex for the keys cache
+   * @brief the stamp taken before the last complete listing, guarded by
+   * the write mutex
+   *
+   */
+  QByteArray listed_stamp_;
+
+  /**
+   * @brief one full listing at a time
+   *
+   */
+  mutable std::mutex flush_mutex_;
+
+  /**
+   * @brief cache the keys with full details, for the key details dialogs
+   *
+   */
+  QMap<QString, GpgKey> keys_detail_cache_;
+
+  /**
+   * @brief mutex for the detail cache
+   *
+   */
+  mutable std::mutex keys_detail_cache_mutex_;
+
+  /**
+   * @brief the summary table of the latest snapshot published or asked for
+   *
+   */
+  KeySummaryTablePtr summary_;
+
+  /**
+   * @brief mutex for the summary table
+   *
+   */
+  mutable std::mutex summary_mutex_;
+
+  /**
+   * @brief list the keys matching the patterns on a pooled context, only
+   * with their summary (no signatures, notations or tofu information)
+   *
+   * @param patterns all keys if empty
+   * @param keys
+   * @return true if the listing was complete
+   */
+  auto list_keys(const KeyIdArgsList& patterns, QList<GpgKey>& keys) -> bool {
+    auto ctx = ctx_.AcquireContext(true);
+    if (ctx == nullptr) return false;
+
+    std::vector<QByteArray> buffers;
+    std::vector<const char*> c_patterns;
+    buffers.reserve(patterns.size());
+    for (const auto& pattern : patterns) buffers.push_back(pattern.toUtf8());
+    for (const auto& buffer : buffers) c_patterns.push_back(buffer.constData());
+    c_patterns.push_back(nullptr);
+
+    // the pooled context goes back with the mode it was checked out with
+    const auto mode = gpgme_get_keylist_mode(ctx.get());
+    gpgme_set_keylist_mode(ctx.get(), kSummaryKeyListMode);
+
+    GpgError err =
+        patterns.empty()
+            ? gpgme_op_keylist_start(ctx.get(), nullptr, 0)
+            : gpgme_op_keylist_ext_start(ctx.get(), c_patterns.data(), 0, 0);
+    if (CheckGpgError(err) != GPG_ERR_NO_ERROR) {
+      gpgme_set_keylist_mode(ctx.get(), mode);
+      return false;
+    }
+
+    gpgme_key_t key;
+    while ((err = gpgme_op_keylist_next(ctx.get(), &key)) ==
+           GPG_ERR_NO_ERROR) {
+      auto gpg_key = GpgKey(std::move(key));
+
+      // detect if the key is in a smartcard
+      // if so, try to get full information using gpgme_get_key()
+      // this maybe a bug in gpgme
+      if (gpg_key.IsHasCardKey()) {
+        gpg_key = GetKey(gpg_key.GetId(), false);
+      }
+      keys.push_back(gpg_key);
+    }
+    gpgme_op_keylist_end(ctx.get());
+    gpgme_set_keylist_mode(ctx.get(), mode);
+
+    // anything but the end of the listing means keys may be missing
+    return gpg_err_code(err) == GPG_ERR_EOF;
+  }
+
+  auto flush_key_cache() -> bool {
+    GF_CORE_LOG_DEBUG("flush key channel called, channel: {}", GetChannel());
+
+    const auto stamp = get_key_database_stamp();
+    QList<GpgKey> listed;
+    if (!list_keys({}, listed)) {
+      GF_CORE_LOG_ERROR("cannot list the keys, channel: {}", GetChannel());
+      return false;
+    }
+
+    auto snapshot = std::make_shared<KeyCacheSnapshot>();
+    for (const auto& key : listed) snapshot->Append(key);
+
+    {
+      std::lock_guard<std::mutex> lock(keys_cache_write_mutex_);
+      publish_snapshot(snapshot);
+      listed_stamp_ = stamp;
+      store_metadata(stamp, snapshot);
+    }
+    clear_detail_cache();
+
+    GF_CORE_LOG_DEBUG("flush key channel done, channel: {}", GetChannel());
+    return true;
+  }
+
+  /**
+   * @brief only the default channel is shown at the next startup
+   *
+   * @return QByteArray
+   */
+  auto get_key_database_stamp() -> QByteArray {
+    if (GetChannel() != kGpgFrontendDefaultChannel) return {};
+    return GpgKeyMetadataStore::GetInstance(GetChannel())
+        .GetKeyDatabaseStamp();
+  }
+
+  /**
+   * @brief store the metadata of the keys in the background, with the stamp
+   * taken before they were listed, so a change during the listing
+   * invalidates it. Called with the write mutex held, so the stores are
+   * asked for in the order the snapshots are published.
+   *
+   * @param stamp
+   * @param snapshot
+   */
+  void store_metadata(const QByteArray& stamp,
+                      const std::shared_ptr<const KeyCacheSnapshot>& snapshot) {
+    if (stamp.isEmpty()) return;
+    GpgKeyMetadataStore::GetInstance(GetChannel())
+        .SaveLater(stamp, {snapshot, &snapshot->keys});
+  }
+
+  /**
+   * @brief apply the changes found by a full listing, a copy of the
+   * snapshot is patched for a few of them, for more it is cheaper to index
+   * the listing from scratch
+   *
+   * @param snapshot
+   * @param listed
+   * @param changes
+   * @param changed_keys the listed keys which were added or updated
+   * @return std::shared_ptr<const KeyCacheSnapshot>
+   */
+  static auto reconciled_snapshot(const KeyCacheSnapshot& snapshot,
+                                  const QList<GpgKey>& listed,
+                                  const GpgKeyCacheChanges& changes,
+                                  const QHash<QString, GpgKey>& changed_keys)
+      -> std::shared_ptr<const KeyCacheSnapshot> {
+    const auto changed =
+        changes.added.size() + changes.updated.size() + changes.removed.size();
+    if (changed * 10 > listed.size()) {
+      auto rebuilt = std::make_shared<KeyCacheSnapshot>();
+      for (const auto& key : listed) rebuilt->Append(key);
+      return rebuilt;
+    }
+
+    auto patched = std::make_shared<KeyCacheSnapshot>(snapshot);
+    for (const auto& fpr : changes.added) {
+      patched->Append(changed_keys.value(fpr));
+    }
+    for (const auto& fpr : changes.updated) {
+      patched->Replace(changed_keys.value(fpr));
+    }
+    for (const auto& fpr : changes.removed) patched->Remove(fpr);
+    return patched;
+  }
+
+  /**
+   * @brief drop the stored metadata, it no longer matches the key database
+   *
+   */
+  void drop_metadata() {
+    if (GetChannel() != kGpgFrontendDefaultChannel) return;
+    GpgKeyMetadataStore::GetInstance(GetChannel()).Remove();
+  }
+
+  auto load_snapshot() const -> std::shared_ptr<const KeyCacheSnapshot> {
+    return std::atomic_load(&keys_cache_);
+  }
+
+  void publish_snapshot(std::shared_ptr<const KeyCacheSnapshot> snapshot) {
+    // the key tables ask for the summary of every snapshot shown, take it
+    // here on the thread of the writer rather than on the ui thread
+    if (GetChannel() == kGpgFrontendDefaultChannel) {
+      auto summary = std::make_shared<const GpgKeySummaryTable>(
+          KeyListSnapshotPtr(snapshot, &snapshot->keys));
+      std::lock_guard<std::mutex> lock(summary_mutex_);
+      summary_ = std::move(summary);
+    }
+    std::atomic_store(&keys_cache_, std::move(snapshot));
+  }
+
+  /**
+   * @brief list the keys for the first time, every key is new
    *
+   * @return GpgKeyCacheChanges
    */
-  mutable std::mutex keys_cache_mutex_;
+  auto first_listing_changes() -> GpgKeyCacheChanges {
+    GpgKeyCacheChanges changes;
+    {
+      // the listing may be running already, at startup
+      std::lock_guard<std::mutex> lock(flush_mutex_);
+      if (load_snapshot() == nullptr && !flush_key_cache()) return changes;
+    }
+
+    for (const auto& key : load_snapshot()->keys) {
+      changes.added.append(key.GetFingerprint());
+    }
+    return changes;
+  }
+
+  void invalidate_key_details(const GpgKeyCacheChanges& changes) {
+    std::lock_guard<std::mutex> lock(keys_detail_cache_mutex_);
+    for (const auto& fpr : changes.updated + changes.removed) {
+      keys_detail_cache_.remove(fpr);
+    }
+  }
+
+  void clear_detail_cache() {
+    std::lock_guard<std::mutex> lock(keys_detail_cache_mutex_);
+    keys_detail_cache_.clear();
+  }
 
   /**
    * @brief Get the Key object
@@ -204,15 +949,11 @@ class GpgKeyGetter::Impl : public SingletonFunctionObject<GpgKeyGetter::Impl> {
    * @return GpgKey
    */
   auto get_key_in_cache(const QString& key_id) -> GpgKey {
-    std::lock_guard<std::mutex> lock(keys_cache_mutex_);
-    if (keys_search_cache_.find(key_id) != keys_search_cache_.end()) {
-      std::lock_guard<std::mutex> lock(ctx_mutex_);
-      // return a copy of the key in cache
-      return keys_search_cache_[key_id];
-    }
+    auto snapshot = load_snapshot();
+    if (snapshot == nullptr) return {};
 
-    // return a bad key
-    return {};
+    // return a copy of the key in cache, or a bad key
+    return snapshot->Lookup(key_id);
   }
 };
 
@@ -234,6 +975,14 @@ auto GpgKeyGetter::GetPubkey(const QString& key_id, bool use_cache) -> GpgKey {
 
 auto GpgKeyGetter::FlushKeyCache() -> bool { return p_->FlushKeyCache(); }
 
+auto GpgKeyGetter::ReconcileKeys() -> GpgKeyCacheChanges {
+  return p_->ReconcileKeys();
+}
+
+auto GpgKeyGetter::IsKeyCacheLoaded() const -> bool {
+  return p_->IsKeyCacheLoaded();
+}
+
 auto GpgKeyGetter::GetKeys(const KeyIdArgsListPtr& ids) -> KeyListPtr {
   return p_->GetKeys(ids);
 }
@@ -246,6 +995,24 @@ auto GpgKeyGetter::GetKeysCopy(const KeyListPtr& keys) -> KeyListPtr {
   return p_->GetKeysCopy(keys);
 }
 
-auto GpgKeyGetter::FetchKey() -> KeyLinkListPtr { return p_->FetchKey(); }
+auto GpgKeyGetter::FetchKey() -> KeyListSnapshotPtr { return p_->FetchKey(); }
+
+auto GpgKeyGetter::SearchKeys(const QString& keyword) -> QSet<QString> {
+  return p_->SearchKeys(keyword);
+}
+
+auto GpgKeyGetter::GetKeySummary(const KeyListSnapshotPtr& keys)
+    -> KeySummaryTablePtr {
+  return p_->GetKeySummary(keys);
+}
+
+auto GpgKeyGetter::GetKeyDetail(const QString& key_id) -> GpgKey {
+  return p_->GetKeyDetail(key_id);
+}
+
+auto GpgKeyGetter::RefreshKeys(const KeyIdArgsList& key_ids)
+    -> GpgKeyCacheChanges {
+  return p_->RefreshKeys(key_ids);
+}
 
 }  // namespace GpgFrontend
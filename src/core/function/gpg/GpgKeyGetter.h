@@ -33,6 +33,25 @@
 
 namespace GpgFrontend {
 
+/**
+ * @brief fingerprints of the keys a targeted refresh touched
+ *
+ */
+struct GpgKeyCacheChanges {
+  QStringList added;    ///< listed now, not in the cache before
+  QStringList updated;  ///< listed again and replaced in the cache
+  QStringList removed;  ///< in the cache before, not listed any more
+
+  [[nodiscard]] auto Empty() const -> bool {
+    return added.isEmpty() && updated.isEmpty() && removed.isEmpty();
+  }
+
+  [[nodiscard]] auto Contains(const QString& fpr) const -> bool {
+    return added.contains(fpr) || updated.contains(fpr) ||
+           removed.contains(fpr);
+  }
+};
+
 /**
  * @brief
  *
@@ -78,11 +97,39 @@ class GPGFRONTEND_CORE_EXPORT GpgKeyGetter
   auto GetPubkey(const QString& key_id, bool use_cache = true) -> GpgKey;
 
   /**
-   * @brief Get all the keys by receiving a linked list
+   * @brief get the key with its signatures, notations and tofu information,
+   * the cached keys only carry a summary of them
    *
-   * @return KeyLinkListPtr
+   * @param key_id
+   * @return GpgKey
+   */
+  auto GetKeyDetail(const QString& key_id) -> GpgKey;
+
+  /**
+   * @brief Get all the keys, the list is a snapshot of the cache shared
+   * with other readers and never changes, a refresh publishes a new one
+   *
+   * @return KeyListSnapshotPtr
+   */
+  auto FetchKey() -> KeyListSnapshotPtr;
+
+  /**
+   * @brief find the cached keys whose uids, key ids or fingerprints contain
+   * the keyword, ignoring case
+   *
+   * @param keyword
+   * @return QSet<QString> fingerprints of the keys
    */
-  auto FetchKey() -> KeyLinkListPtr;
+  auto SearchKeys(const QString& keyword) -> QSet<QString>;
+
+  /**
+   * @brief the summary table of a listing returned by FetchKey, taken once
+   * per snapshot and shared by all the key tables
+   *
+   * @param keys
+   * @return KeySummaryTablePtr
+   */
+  auto GetKeySummary(const KeyListSnapshotPtr& keys) -> KeySummaryTablePtr;
 
   /**
    * @brief flush the keys in the cache
@@ -90,6 +137,33 @@ class GPGFRONTEND_CORE_EXPORT GpgKeyGetter
    */
   auto FlushKeyCache() -> bool;
 
+  /**
+   * @brief list all the keys again but patch only the cached keys that
+   * differ, for changes made to the key database outside of this process.
+   * The listing itself is as costly as a flush, only the readers are spared.
+   *
+   * @return GpgKeyCacheChanges
+   */
+  auto ReconcileKeys() -> GpgKeyCacheChanges;
+
+  /**
+   * @brief whether the keys have been listed once, before that the key
+   * cache is empty and FetchKey lists them
+   *
+   * @return true
+   * @return false
+   */
+  [[nodiscard]] auto IsKeyCacheLoaded() const -> bool;
+
+  /**
+   * @brief list only the given keys again and patch the cache in place,
+   * a cached key which is not listed any more is removed
+   *
+   * @param key_ids key ids, fingerprints or keygrips prefixed with "&"
+   * @return GpgKeyCacheChanges
+   */
+  auto RefreshKeys(const KeyIdArgsList& key_ids) -> GpgKeyCacheChanges;
+
   /**
    * @brief Get the Keys Copy object
    *
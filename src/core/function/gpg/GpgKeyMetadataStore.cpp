@@ -0,0 +1,282 @@
+/**
+ * Copyright (C) 2021 Saturneric <eric@bktus.com>
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric <eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include "core/function/gpg/GpgKeyMetadataStore.h"
+
+#include <atomic>
+#include <mutex>
+
+#include "core/function/GlobalSettingStation.h"
+#include "core/function/gpg/GpgContext.h"
+#include "core/thread/TaskRunnerGetter.h"
+
+namespace GpgFrontend {
+
+constexpr quint32 kKeyMetadataMagic = 0x47464B4D;  // "GFKM"
+constexpr quint32 kKeyMetadataVersion = 1;
+
+// a burst of listings is stored once, after it settles
+constexpr int kKeyMetadataSaveDelay = 500;
+
+// the files gnupg touches whenever a key or its trust changes
+const std::initializer_list<const char*> kKeyDatabaseFiles = {
+    "pubring.kbx",
+    "pubring.gpg",
+    "secring.gpg",
+    "trustdb.gpg",
+    "private-keys-v1.d",
+    "public-keys.d/pubring.db",
+    "public-keys.d/pubring.db-wal",
+};
+
+class GpgKeyMetadataStore::Impl
+    : public SingletonFunctionObject<GpgKeyMetadataStore::Impl> {
+ public:
+  Impl(int channel, QString store_path)
+      : SingletonFunctionObject<GpgKeyMetadataStore::Impl>(channel),
+        store_path_(std::move(store_path)),
+        save_timer_(new QTimer()) {
+    // the file is written on the io thread, never on the one listing
+    save_timer_->setSingleShot(true);
+    save_timer_->setInterval(kKeyMetadataSaveDelay);
+    save_timer_->moveToThread(
+        Thread::TaskRunnerGetter::GetInstance()
+            .GetTaskRunner(Thread::TaskRunnerGetter::kTaskRunnerType_IO)
+            ->GetThread());
+    QObject::connect(save_timer_, &QTimer::timeout, save_timer_,
+                     [this]() { save_pending(); });
+  }
+
+  ~Impl() {
+    QObject::disconnect(save_timer_, nullptr, nullptr, nullptr);
+    save_timer_->deleteLater();
+  }
+
+  auto GetKeyDatabaseStamp() -> QByteArray {
+    const auto db_path =
+        GpgContext::GetInstance(GetChannel()).GetDatabasePath();
+
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(db_path.toUtf8());
+
+    for (const auto* file : kKeyDatabaseFiles) {
+      QFileInfo info(QDir(db_path).filePath(file));
+      const auto state =
+          info.exists() ? QString("%1:%2:%3").arg(file).arg(info.size()).arg(
+                              info.lastModified().toMSecsSinceEpoch())
+                        : QString("%1:-").arg(file);
+      hash.addData(state.toUtf8());
+    }
+    return hash.result();
+  }
+
+  auto Save(const QByteArray& stamp, const GpgKeyLinkList& keys) -> bool {
+    std::lock_guard<std::mutex> lock(store_mutex_);
+    return save(stamp, keys);
+  }
+
+  void SaveLater(const QByteArray& stamp, KeyListSnapshotPtr keys) {
+    {
+      std::lock_guard<std::mutex> lock(pending_mutex_);
+      pending_stamp_ = stamp;
+      pending_keys_ = std::move(keys);
+      generation_++;
+    }
+
+    // restart the quiet period
+    QMetaObject::invokeMethod(save_timer_,
+                              [timer = save_timer_]() { timer->start(); });
+  }
+
+  auto IsValid() -> bool {
+    std::lock_guard<std::mutex> lock(store_mutex_);
+
+    QFile file(store_path_);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+    return read_header(stream);
+  }
+
+  auto Load() -> std::optional<QList<GpgKeyMetadata>> {
+    std::lock_guard<std::mutex> lock(store_mutex_);
+
+    QFile file(store_path_);
+    if (!file.open(QIODevice::ReadOnly)) return {};
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+    if (!read_header(stream)) return {};
+
+    quint32 count = 0;
+    stream >> count;
+
+    QList<GpgKeyMetadata> metadata_list;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok;
+         i++) {
+      GpgKeyMetadata metadata;
+      stream >> metadata;
+      metadata_list.append(metadata);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+      GF_CORE_LOG_WARN("broken key metadata file: {}", store_path_);
+      return {};
+    }
+    return metadata_list;
+  }
+
+  void Remove() {
+    {
+      // a pending or running save is older than the removal
+      std::lock_guard<std::mutex> lock(pending_mutex_);
+      pending_keys_ = nullptr;
+      generation_++;
+    }
+
+    std::lock_guard<std::mutex> lock(store_mutex_);
+    QFile::remove(store_path_);
+  }
+
+ private:
+  const QString store_path_;
+  std::mutex store_mutex_;
+
+  QTimer* save_timer_;                  ///< lives on the io thread
+  std::mutex pending_mutex_;            ///<
+  QByteArray pending_stamp_;            ///<
+  KeyListSnapshotPtr pending_keys_;     ///< the latest listing to store
+  std::atomic<quint64> generation_{0};  ///< bumped by every change request
+
+  /**
+   * @brief store the latest listing asked for, unless another one or a
+   * removal came in while writing
+   *
+   */
+  void save_pending() {
+    QByteArray stamp;
+    KeyListSnapshotPtr keys;
+    quint64 generation;
+    {
+      std::lock_guard<std::mutex> lock(pending_mutex_);
+      if (pending_keys_ == nullptr) return;
+      stamp = pending_stamp_;
+      keys.swap(pending_keys_);
+      generation = generation_;
+    }
+
+    std::lock_guard<std::mutex> lock(store_mutex_);
+    if (!save(stamp, *keys, generation)) {
+      GF_CORE_LOG_WARN("cannot store the key metadata to: {}", store_path_);
+    }
+  }
+
+  /**
+   * @brief write the file, with the store mutex held
+   *
+   * @param stamp
+   * @param keys
+   * @param generation only commit if no later request came in, 0 always
+   * commits
+   * @return true
+   * @return false
+   */
+  auto save(const QByteArray& stamp, const GpgKeyLinkList& keys,
+            quint64 generation = 0) -> bool {
+    QDir().mkpath(QFileInfo(store_path_).absolutePath());
+    QSaveFile file(store_path_);
+    if (!file.open(QIODevice::WriteOnly)) {
+      GF_CORE_LOG_WARN("cannot write key metadata to: {}", store_path_);
+      return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << kKeyMetadataMagic << kKeyMetadataVersion << stamp
+           << static_cast<quint32>(keys.size());
+    for (const auto& key : keys) stream << GpgKeyMetadata::FromKey(key);
+
+    if (stream.status() != QDataStream::Ok) return false;
+
+    // a newer listing or a removal is committed by its own request
+    if (generation != 0 && generation != generation_) {
+      file.cancelWriting();
+      return true;
+    }
+
+    // the file is only replaced when everything was written
+    return file.commit();
+  }
+
+  auto read_header(QDataStream& stream) -> bool {
+    quint32 magic = 0;
+    quint32 version = 0;
+    QByteArray stamp;
+    stream >> magic >> version >> stamp;
+
+    return stream.status() == QDataStream::Ok && magic == kKeyMetadataMagic &&
+           version == kKeyMetadataVersion && stamp == GetKeyDatabaseStamp();
+  }
+};
+
+GpgKeyMetadataStore::GpgKeyMetadataStore(int channel)
+    : GpgKeyMetadataStore(
+          channel, GlobalSettingStation::GetInstance().GetAppDataPath() +
+                       QString("/cache/key_metadata_%1.bin").arg(channel)) {}
+
+GpgKeyMetadataStore::GpgKeyMetadataStore(int channel,
+                                         const QString& store_path)
+    : SingletonFunctionObject<GpgKeyMetadataStore>(channel),
+      p_(SecureCreateUniqueObject<Impl>(channel, store_path)) {}
+
+GpgKeyMetadataStore::~GpgKeyMetadataStore() = default;
+
+auto GpgKeyMetadataStore::GetKeyDatabaseStamp() -> QByteArray {
+  return p_->GetKeyDatabaseStamp();
+}
+
+auto GpgKeyMetadataStore::Save(const QByteArray& stamp,
+                               const GpgKeyLinkList& keys) -> bool {
+  return p_->Save(stamp, keys);
+}
+
+void GpgKeyMetadataStore::SaveLater(const QByteArray& stamp,
+                                    KeyListSnapshotPtr keys) {
+  p_->SaveLater(stamp, std::move(keys));
+}
+
+auto GpgKeyMetadataStore::IsValid() -> bool { return p_->IsValid(); }
+
+auto GpgKeyMetadataStore::Load() -> std::optional<QList<GpgKeyMetadata>> {
+  return p_->Load();
+}
+
+void GpgKeyMetadataStore::Remove() { p_->Remove(); }
+
+}  // namespace GpgFrontend
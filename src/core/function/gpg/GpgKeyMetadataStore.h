@@ -0,0 +1,129 @@
+/**
+ * Copyright (C) 2021 Saturneric <eric@bktus.com>
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric <eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#pragma once
+
+#include <optional>
+
+#include "core/function/basic/GpgFunctionObject.h"
+#include "core/model/GpgKeyMetadata.h"
+#include "core/typedef/GpgTypedef.h"
+
+namespace GpgFrontend {
+
+/**
+ * @brief keeps the metadata of the listed keys on disk, so the key tables
+ * can be shown at startup before the keys are listed again.
+ *
+ * The file holds what the key tables show in plaintext: the user ids and
+ * thus the names and emails, the key ids and fingerprints. It is written
+ * to the app data directory of the user, no key material is stored.
+ *
+ */
+class GPGFRONTEND_CORE_EXPORT GpgKeyMetadataStore
+    : public SingletonFunctionObject<GpgKeyMetadataStore> {
+ public:
+  /**
+   * @brief Construct a new Gpg Key Metadata Store object
+   *
+   * @param channel
+   */
+  explicit GpgKeyMetadataStore(int channel = kGpgFrontendDefaultChannel);
+
+  /**
+   * @brief Construct a new Gpg Key Metadata Store object, which keeps the
+   * metadata in another file than the one of the channel
+   *
+   * @param channel
+   * @param store_path
+   */
+  GpgKeyMetadataStore(int channel, const QString& store_path);
+
+  /**
+   * @brief Destroy the Gpg Key Metadata Store object
+   *
+   */
+  ~GpgKeyMetadataStore();
+
+  /**
+   * @brief the modification state of the key database, the keyboxes, the
+   * keyboxd database, the private keys and the trustdb
+   *
+   * @return QByteArray
+   */
+  auto GetKeyDatabaseStamp() -> QByteArray;
+
+  /**
+   * @brief store the metadata of the keys, taken when the key database was
+   * in the state of the stamp
+   *
+   * @param stamp
+   * @param keys
+   * @return true
+   * @return false
+   */
+  auto Save(const QByteArray& stamp, const GpgKeyLinkList& keys) -> bool;
+
+  /**
+   * @brief store the metadata of the keys on the io thread once no other
+   * listing came in for a while, only the latest one is written and a
+   * Remove() meanwhile drops it
+   *
+   * @param stamp
+   * @param keys kept alive until written
+   */
+  void SaveLater(const QByteArray& stamp, KeyListSnapshotPtr keys);
+
+  /**
+   * @brief whether the stored metadata matches the key database
+   *
+   * @return true
+   * @return false
+   */
+  auto IsValid() -> bool;
+
+  /**
+   * @brief load the stored metadata, nothing if it does not match the key
+   * database any more
+   *
+   * @return std::optional<QList<GpgKeyMetadata>>
+   */
+  auto Load() -> std::optional<QList<GpgKeyMetadata>>;
+
+  /**
+   * @brief drop the stored metadata, e.g. when the keys cannot be listed
+   *
+   */
+  void Remove();
+
+ private:
+  class Impl;
+  SecureUniquePtr<Impl> p_;
+};
+
+}  // namespace GpgFrontend
@@ -28,32 +28,186 @@
 
 #include "GFBuffer.h"
 
+#include <cstring>
+
 namespace GpgFrontend {
 
+const char kEmptyBufferData[1] = {'\0'};
+
+struct GFBuffer::Storage {
+  char* data = nullptr;
+  size_t capacity = 0;  ///< without the terminating zero
+  size_t size = 0;
+
+  explicit Storage(size_t min_capacity) {
+    size_t block = 0;
+    data = static_cast<char*>(
+        SecureBufferPool::Acquire(min_capacity + 1, block));
+    capacity = block - 1;
+    data[0] = '\0';
+  }
+
+  ~Storage() { SecureBufferPool::Release(data, capacity + 1); }
+
+  Storage(const Storage&) = delete;
+
+  auto operator=(const Storage&) -> Storage& = delete;
+};
+
 GFBuffer::GFBuffer() = default;
 
-GFBuffer::GFBuffer(QByteArray buffer) : buffer_(std::move(buffer)) {}
+GFBuffer::GFBuffer(QByteArray buffer)
+    : GFBuffer(buffer.constData(), static_cast<size_t>(buffer.size())) {
+  // nobody else can read it once it was handed over to us
+  if (buffer.isDetached()) wipememory(buffer.data(), buffer.size());
+}
+
+GFBuffer::GFBuffer(const QString& str) : GFBuffer(str.toUtf8()) {}
+
+GFBuffer::GFBuffer(const char* buffer, size_t size) {
+  if (size == 0) return;
+  storage_ = std::make_shared<Storage>(size);
+  memcpy(storage_->data, buffer, size);
+  storage_->size = size;
+  storage_->data[size] = '\0';
+}
+
+GFBuffer::GFBuffer(const GFBufferView& view)
+    : GFBuffer(view.Data(), view.Size()) {}
+
+GFBuffer::GFBuffer(const GFBuffer&) = default;
 
-GFBuffer::GFBuffer(const QString& str) : buffer_(str.toUtf8()) {}
+GFBuffer::GFBuffer(GFBuffer&&) noexcept = default;
+
+auto GFBuffer::operator=(const GFBuffer&) -> GFBuffer& = default;
+
+auto GFBuffer::operator=(GFBuffer&&) noexcept -> GFBuffer& = default;
+
+GFBuffer::~GFBuffer() = default;
 
 auto GFBuffer::operator==(const GFBuffer& o) const -> bool {
-  return buffer_ == o.buffer_;
+  return Size() == o.Size() && memcmp(Data(), o.Data(), Size()) == 0;
+}
+
+auto GFBuffer::Data() const -> const char* {
+  return storage_ != nullptr ? storage_->data : kEmptyBufferData;
+}
+
+auto GFBuffer::MutableData() -> char* {
+  prepare_write(Size());
+  return storage_->data;
+}
+
+auto GFBuffer::prepare_write(size_t capacity) -> std::shared_ptr<Storage> {
+  if (storage_ != nullptr && storage_.use_count() == 1 &&
+      storage_->capacity >= capacity) {
+    return {};
+  }
+
+  // grow geometrically so that appending stays linear
+  auto next_capacity = capacity;
+  if (storage_ != nullptr && capacity > storage_->capacity) {
+    next_capacity = std::max(capacity, storage_->capacity * 2);
+  }
+
+  // a shrinking detach keeps only what fits, the caller cuts it anyway
+  auto next = std::make_shared<Storage>(next_capacity);
+  if (storage_ != nullptr) {
+    next->size = std::min(storage_->size, next->capacity);
+    memcpy(next->data, storage_->data, next->size);
+    next->data[next->size] = '\0';
+  }
+
+  // the old storage is wiped once its last copy or view is gone
+  auto prev = std::move(storage_);
+  storage_ = std::move(next);
+  return prev;
 }
 
-auto GFBuffer::Data() const -> const char* { return buffer_.constData(); }
+void GFBuffer::Resize(ssize_t size) {
+  const auto new_size = static_cast<size_t>(std::max<ssize_t>(size, 0));
+  const auto old_size = Size();
+  if (new_size == old_size) return;
 
-void GFBuffer::Resize(ssize_t size) { buffer_.resize(size); }
+  prepare_write(new_size);
 
-auto GFBuffer::Size() const -> size_t { return buffer_.size(); }
+  // a detached storage may hold less than the old size
+  auto* data = storage_->data;
+  const auto kept_size = storage_->size;
+  if (new_size > kept_size) {
+    memset(data + kept_size, 0, new_size - kept_size);
+  } else {
+    wipememory(data + new_size, kept_size - new_size);
+  }
+  storage_->size = new_size;
+  data[new_size] = '\0';
+}
+
+void GFBuffer::Reserve(size_t size) {
+  if (size <= Capacity()) return;
+  prepare_write(size);
+}
 
-auto GFBuffer::ConvertToQByteArray() const -> QByteArray { return buffer_; }
+auto GFBuffer::Capacity() const -> size_t {
+  return storage_ != nullptr ? storage_->capacity : 0;
+}
+
+auto GFBuffer::Size() const -> size_t {
+  return storage_ != nullptr ? storage_->size : 0;
+}
+
+auto GFBuffer::ConvertToQByteArray() const -> QByteArray {
+  return QByteArray(Data(), static_cast<qsizetype>(Size()));
+}
 
 auto GFBuffer::Empty() const -> bool { return this->Size() == 0; }
 
-void GFBuffer::Append(const GFBuffer& o) { buffer_.append(o.buffer_); }
+void GFBuffer::Append(const GFBuffer& o) {
+  Append(o.Data(), static_cast<ssize_t>(o.Size()));
+}
 
 void GFBuffer::Append(const char* buffer, ssize_t size) {
-  buffer_.append(buffer, size);
+  if (size <= 0) return;
+
+  // keeps the source alive in case it points into our own storage
+  const auto append_size = static_cast<size_t>(size);
+  auto prev = prepare_write(Size() + append_size);
+  memcpy(storage_->data + storage_->size, buffer, append_size);
+  storage_->size += append_size;
+  storage_->data[storage_->size] = '\0';
+}
+
+auto GFBuffer::Slice(size_t offset, size_t size) const -> GFBufferView {
+  return View().Slice(offset, size);
+}
+
+auto GFBuffer::View() const -> GFBufferView {
+  return {storage_, Data(), Size()};
+}
+
+GFBufferView::GFBufferView() : data_(kEmptyBufferData) {}
+
+GFBufferView::GFBufferView(std::shared_ptr<const void> owner,
+                           const char* data, size_t size)
+    : owner_(std::move(owner)), data_(data), size_(size) {}
+
+auto GFBufferView::Data() const -> const char* { return data_; }
+
+auto GFBufferView::Size() const -> size_t { return size_; }
+
+auto GFBufferView::Empty() const -> bool { return size_ == 0; }
+
+auto GFBufferView::Slice(size_t offset, size_t size) const -> GFBufferView {
+  offset = std::min(offset, size_);
+  return {owner_, data_ + offset, std::min(size, size_ - offset)};
+}
+
+auto GFBufferView::ConvertToQByteArray() const -> QByteArray {
+  return QByteArray(data_, static_cast<qsizetype>(size_));
+}
+
+auto GFBufferView::operator==(const GFBufferView& o) const -> bool {
+  return size_ == o.size_ && memcmp(data_, o.data_, size_) == 0;
 }
 
-}  // namespace GpgFrontend
\ No newline at end of file
+}  // namespace GpgFrontend
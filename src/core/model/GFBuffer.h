@@ -33,20 +33,64 @@
 
 namespace GpgFrontend {
 
+class GFBufferView;
+
+/**
+ * @brief byte buffer for plaintext and key material, the storage comes from
+ * the SecureBufferPool, is shared between copies and views until one of
+ * them writes, and is wiped when the last owner lets it go
+ *
+ */
 class GPGFRONTEND_CORE_EXPORT GFBuffer {
  public:
   GFBuffer();
 
+  /**
+   * @brief copies the bytes into pooled storage, the array is wiped when
+   * it was not shared, pass it with std::move to get it wiped
+   *
+   * @param buffer
+   */
   explicit GFBuffer(QByteArray buffer);
 
   explicit GFBuffer(const QString& str);
 
+  GFBuffer(const char* buffer, size_t size);
+
+  explicit GFBuffer(const GFBufferView& view);
+
+  GFBuffer(const GFBuffer&);
+
+  GFBuffer(GFBuffer&&) noexcept;
+
+  auto operator=(const GFBuffer&) -> GFBuffer&;
+
+  auto operator=(GFBuffer&&) noexcept -> GFBuffer&;
+
+  ~GFBuffer();
+
   auto operator==(const GFBuffer& o) const -> bool;
 
+  /**
+   * @brief the data, always followed by a terminating zero
+   *
+   * @return const char*
+   */
   [[nodiscard]] auto Data() const -> const char*;
 
+  /**
+   * @brief writable data, detaches from the copies and views sharing it
+   *
+   * @return char*
+   */
+  auto MutableData() -> char*;
+
   void Resize(ssize_t size);
 
+  void Reserve(size_t size);
+
+  [[nodiscard]] auto Capacity() const -> size_t;
+
   [[nodiscard]] auto Size() const -> size_t;
 
   [[nodiscard]] auto Empty() const -> bool;
@@ -55,10 +99,68 @@ class GPGFRONTEND_CORE_EXPORT GFBuffer {
 
   void Append(const char*, ssize_t);
 
+  /**
+   * @brief read only view of a range, shares the storage without copying
+   *
+   * @param offset
+   * @param size clamped to the end of the buffer
+   * @return GFBufferView
+   */
+  [[nodiscard]] auto Slice(size_t offset, size_t size) const -> GFBufferView;
+
+  [[nodiscard]] auto View() const -> GFBufferView;
+
+  /**
+   * @brief a copy out of the pooled storage, which Qt never wipes, prefer
+   * Data() and Size() where the bytes are only read
+   *
+   * @return QByteArray
+   */
+  [[nodiscard]] auto ConvertToQByteArray() const -> QByteArray;
+
+ private:
+  struct Storage;
+
+  std::shared_ptr<Storage> storage_;
+
+  /**
+   * @brief make sure the storage is owned by this buffer alone and holds
+   * at least capacity bytes
+   *
+   * @return the storage it replaced, if any
+   */
+  auto prepare_write(size_t capacity) -> std::shared_ptr<Storage>;
+};
+
+/**
+ * @brief read only range of a GFBuffer, keeps the storage alive
+ *
+ */
+class GPGFRONTEND_CORE_EXPORT GFBufferView {
+ public:
+  GFBufferView();
+
+  [[nodiscard]] auto Data() const -> const char*;
+
+  [[nodiscard]] auto Size() const -> size_t;
+
+  [[nodiscard]] auto Empty() const -> bool;
+
+  [[nodiscard]] auto Slice(size_t offset, size_t size) const -> GFBufferView;
+
   [[nodiscard]] auto ConvertToQByteArray() const -> QByteArray;
 
+  auto operator==(const GFBufferView& o) const -> bool;
+
  private:
-  QByteArray buffer_;
+  friend class GFBuffer;
+
+  GFBufferView(std::shared_ptr<const void> owner, const char* data,
+               size_t size);
+
+  std::shared_ptr<const void> owner_;  ///< storage of the viewed buffer
+  const char* data_;
+  size_t size_ = 0;
 };
 
-}  // namespace GpgFrontend
\ No newline at end of file
+}  // namespace GpgFrontend
@@ -28,52 +28,95 @@
 
 #include "GFDataExchanger.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "core/utils/LogUtils.h"
 
 namespace GpgFrontend {
 
+GFDataExchanger::GFDataExchanger(ssize_t size)
+    : capacity_(size > 0 ? static_cast<size_t>(size) : 1), ring_(capacity_) {
+  if (size <= 0) {
+    GF_CORE_LOG_WARN("illegal gf data exchanger size: {}, fallback to 1",
+                     size);
+  }
+}
+
 auto GFDataExchanger::Write(const std::byte* buffer, size_t size) -> ssize_t {
   if (close_) return -1;
   if (size == 0) return 0;
 
-  std::atomic<ssize_t> write_bytes = 0;
-  std::unique_lock<std::mutex> lock(mutex_);
-  try {
-    for (size_t i = 0; i < size; i++) {
-      if (queue_.size() == queue_max_size_) not_empty_.notify_all();
-      not_full_.wait(lock,
-                     [=] { return queue_.size() < queue_max_size_ || close_; });
+  size_t write_bytes = 0;
+  while (write_bytes < size) {
+    const auto w_pos = write_pos_.load(std::memory_order_relaxed);
+    const auto free_space = capacity_ - (w_pos - read_pos_.load());
+
+    if (free_space == 0) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      writer_waiting_ = true;
+      not_full_.wait(lock, [this, w_pos] {
+        return close_ || w_pos - read_pos_.load() < capacity_;
+      });
+      writer_waiting_ = false;
+
       if (close_) return -1;
+      continue;
+    }
+
+    // copy as much as possible, at most two segments because of wrapping
+    const auto chunk = std::min(free_space, size - write_bytes);
+    const auto offset = w_pos % capacity_;
+    const auto first = std::min(chunk, capacity_ - offset);
 
-      queue_.push(buffer[i]);
-      write_bytes++;
+    std::memcpy(ring_.data() + offset, buffer + write_bytes, first);
+    if (chunk > first) {
+      std::memcpy(ring_.data(), buffer + write_bytes + first, chunk - first);
     }
-  } catch (...) {
-    GF_CORE_LOG_ERROR(
-        "gf data exchanger caught exception when it writes to queue, abort...");
+
+    write_pos_.store(w_pos + chunk);
+    write_bytes += chunk;
+
+    notify_peer(reader_waiting_, not_empty_);
   }
 
-  if (!queue_.empty()) not_empty_.notify_all();
-  return write_bytes;
+  return static_cast<ssize_t>(write_bytes);
 }
 
 auto GFDataExchanger::Read(std::byte* buffer, size_t size) -> ssize_t {
-  std::unique_lock<std::mutex> lock(mutex_);
-  if (size == 0 || (close_ && queue_.empty())) return 0;
-
-  std::atomic<ssize_t> read_bytes = 0;
-  for (size_t i = 0; i < size; ++i) {
-    if (queue_.empty()) not_full_.notify_all();
-    not_empty_.wait(lock, [=] { return !queue_.empty() || close_; });
-
-    if (close_ && queue_.empty()) return 0;
-    buffer[i] = queue_.front();
-    queue_.pop();
-    read_bytes++;
+  if (abort_) return -1;
+  if (size == 0) return 0;
+
+  const auto r_pos = read_pos_.load(std::memory_order_relaxed);
+  auto available = write_pos_.load() - r_pos;
+
+  if (available == 0) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    reader_waiting_ = true;
+    not_empty_.wait(lock,
+                    [this, r_pos] { return close_ || write_pos_ != r_pos; });
+    reader_waiting_ = false;
+
+    if (abort_) return -1;
+
+    // closed and all data was consumed
+    available = write_pos_.load() - r_pos;
+    if (available == 0) return 0;
   }
 
-  if (queue_.size() < queue_max_size_) not_full_.notify_all();
-  return read_bytes;
+  const auto chunk = std::min(available, size);
+  const auto offset = r_pos % capacity_;
+  const auto first = std::min(chunk, capacity_ - offset);
+
+  std::memcpy(buffer, ring_.data() + offset, first);
+  if (chunk > first) {
+    std::memcpy(buffer + first, ring_.data(), chunk - first);
+  }
+
+  read_pos_.store(r_pos + chunk);
+
+  notify_peer(writer_waiting_, not_full_);
+  return static_cast<ssize_t>(chunk);
 }
 
 void GFDataExchanger::CloseWrite() {
@@ -84,6 +127,27 @@ void GFDataExchanger::CloseWrite() {
   not_empty_.notify_all();
 }
 
-GFDataExchanger::GFDataExchanger(ssize_t size) : queue_max_size_(size) {}
+void GFDataExchanger::Close() {
+  std::unique_lock<std::mutex> const lock(mutex_);
+
+  abort_ = true;
+  close_ = true;
+  not_full_.notify_all();
+  not_empty_.notify_all();
+}
+
+auto GFDataExchanger::IsAborted() const -> bool { return abort_; }
+
+auto GFDataExchanger::Capacity() const -> size_t { return capacity_; }
+
+void GFDataExchanger::notify_peer(std::atomic_bool& waiting,
+                                  std::condition_variable& cv) {
+  // the waiting flag and the positions are sequentially consistent, so
+  // either the peer sees the new position or we see that it is waiting
+  if (!waiting) return;
+
+  std::unique_lock<std::mutex> const lock(mutex_);
+  cv.notify_one();
+}
 
 }  // namespace GpgFrontend
\ No newline at end of file
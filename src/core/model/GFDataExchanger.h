@@ -28,26 +28,96 @@
 
 #pragma once
 
-#include <queue>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
 
 namespace GpgFrontend {
 
+/**
+ * @brief a bounded single-producer/single-consumer byte pipe
+ *
+ * Data is kept in a fixed ring buffer and copied in and out in bulk. The
+ * positions are published through atomics, so the mutex is only taken when
+ * one side has to sleep or wake up the other one.
+ */
 class GFDataExchanger {
  public:
+  /**
+   * @brief Construct a new GFDataExchanger object
+   *
+   * @param size capacity of the ring buffer in bytes
+   */
   explicit GFDataExchanger(ssize_t size);
 
+  /**
+   * @brief write all bytes, blocking while the ring buffer is full
+   *
+   * @param buffer
+   * @param size
+   * @return ssize_t bytes written, -1 if the exchanger was closed
+   */
   auto Write(const std::byte* buffer, size_t size) -> ssize_t;
 
+  /**
+   * @brief read at most size bytes, blocking until some data is available
+   *
+   * @param buffer
+   * @param size
+   * @return ssize_t bytes read, 0 at the end of stream, -1 if the exchanger
+   * was aborted by Close()
+   */
   auto Read(std::byte* buffer, size_t size) -> ssize_t;
 
+  /**
+   * @brief
+   *
+   */
   void CloseWrite();
 
+  /**
+   * @brief close both sides, pending and further reads fail instead of
+   * reaching the end of stream, so a truncated stream is never mistaken for
+   * a complete one
+   *
+   */
+  void Close();
+
+  /**
+   * @brief
+   *
+   * @return true if Close() was called
+   */
+  [[nodiscard]] auto IsAborted() const -> bool;
+
+  /**
+   * @brief Get the capacity of the ring buffer
+   *
+   * @return size_t
+   */
+  [[nodiscard]] auto Capacity() const -> size_t;
+
  private:
-  std::condition_variable not_full_, not_empty_;
-  std::queue<std::byte> queue_;
+  const size_t capacity_;
+  std::vector<std::byte> ring_;
+
+  // monotonic counters, the ring index is pos % capacity_
+  std::atomic<size_t> read_pos_ = 0;
+  std::atomic<size_t> write_pos_ = 0;
+
   std::mutex mutex_;
-  const ssize_t queue_max_size_;
+  std::condition_variable not_full_, not_empty_;
+  std::atomic_bool reader_waiting_ = false;
+  std::atomic_bool writer_waiting_ = false;
   std::atomic_bool close_ = false;
+  std::atomic_bool abort_ = false;
+
+  /**
+   * @brief wake up the peer if it is sleeping on the condition variable
+   *
+   */
+  void notify_peer(std::atomic_bool& waiting, std::condition_variable& cv);
 };
 
 }  // namespace GpgFrontend
\ No newline at end of file
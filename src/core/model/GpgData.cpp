@@ -30,26 +30,52 @@
 
 #include <unistd.h>
 
+#include <cerrno>
+#include <cstring>
+
+#ifndef WINDOWS
+#include <sys/mman.h>
+#endif
+
 #include "core/model/GFDataExchanger.h"
+#include "core/thread/Task.h"
 #include "core/typedef/GpgTypedef.h"
 
 namespace GpgFrontend {
 
 constexpr size_t kBufferSize = 32 * 1024;
 
-auto GFReadExCb(void* handle, void* buffer, size_t size) -> ssize_t {
-  auto* ex = static_cast<GFDataExchanger*>(handle);
-  return ex->Read(static_cast<std::byte*>(buffer), size);
+auto GFWriteBufferCb(void* handle, const void* buffer, size_t size) -> ssize_t {
+  auto* out_buffer = static_cast<GFBuffer*>(handle);
+  out_buffer->Append(static_cast<const char*>(buffer),
+                     static_cast<ssize_t>(size));
+  return static_cast<ssize_t>(size);
 }
 
-auto GFWriteExCb(void* handle, const void* buffer, size_t size) -> ssize_t {
-  auto* ex = static_cast<GFDataExchanger*>(handle);
-  return ex->Write(static_cast<const std::byte*>(buffer), size);
+auto MakeGpgDataSink(QIODevice* device) -> GpgDataSink {
+  return [device](const char* buffer, size_t size) -> bool {
+    while (size > 0) {
+      auto ret = device->write(buffer, static_cast<qint64>(size));
+      if (ret <= 0) return false;
+      buffer += ret;
+      size -= static_cast<size_t>(ret);
+    }
+    return true;
+  };
 }
 
-void GFReleaseExCb(void* handle) {
-  auto* ex = static_cast<GFDataExchanger*>(handle);
-  ex->CloseWrite();
+auto MakeGpgDataSink(int fd) -> GpgDataSink {
+  auto file = std::make_shared<QFile>();
+  if (!file->open(fd, QIODevice::WriteOnly | QIODevice::Unbuffered,
+                  QFileDevice::DontCloseHandle)) {
+    GF_CORE_LOG_ERROR("cannot open file descriptor as sink: {}", fd);
+    return [](const char*, size_t) -> bool { return false; };
+  }
+
+  auto sink = MakeGpgDataSink(file.get());
+  return [file, sink](const char* buffer, size_t size) -> bool {
+    return sink(buffer, size);
+  };
 }
 
 GpgData::GpgData() {
@@ -61,11 +87,14 @@ GpgData::GpgData() {
   data_ref_ = std::unique_ptr<struct gpgme_data, DataRefDeleter>(data);
 }
 
-GpgData::GpgData(GFBuffer buffer) : cached_buffer_(buffer) {
+GpgData::GpgData(GFBuffer buffer) : GpgData(buffer.View()) {}
+
+GpgData::GpgData(GFBufferView view) : cached_view_(std::move(view)) {
   gpgme_data_t data;
 
-  auto err = gpgme_data_new_from_mem(
-      &data, reinterpret_cast<const char*>(buffer.Data()), buffer.Size(), 0);
+  // no copy, gpgme reads the shared storage of the cached view directly
+  auto err = gpgme_data_new_from_mem(&data, cached_view_.Data(),
+                                     cached_view_.Size(), 0);
   assert(gpgme_err_code(err) == GPG_ERR_NO_ERROR);
 
   data_ref_ = std::unique_ptr<struct gpgme_data, DataRefDeleter>(data);
@@ -91,35 +120,83 @@ GpgData::GpgData(int fd) : fd_(fd), data_cbs_() {
 }
 
 GpgData::GpgData(const QString& path, bool read) {
+  init_from_stream(path, read);
+}
+
+GpgData::GpgData(const QString& path, bool read, bool map) {
+  if (read && map && init_from_mapped_file(path)) return;
+  init_from_stream(path, read);
+}
+
+GpgData::GpgData(std::shared_ptr<GFDataExchanger> ex)
+    : data_cbs_(), data_ex_(std::move(ex)) {
   gpgme_data_t data;
 
-  // support unicode path
-  QFile file(path);
-  file.open(read ? QIODevice::ReadOnly : QIODevice::WriteOnly);
-  fp_ = fdopen(dup(file.handle()), read ? "rb" : "wb");
+  data_cbs_.read = read_ex_cb;
+  data_cbs_.write = write_ex_cb;
+  data_cbs_.seek = nullptr;
+  data_cbs_.release = release_ex_cb;
 
-  auto err = gpgme_data_new_from_stream(&data, fp_);
+  auto err = gpgme_data_new_from_cbs(&data, &data_cbs_, this);
   assert(gpgme_err_code(err) == GPG_ERR_NO_ERROR);
 
   data_ref_ = std::unique_ptr<struct gpgme_data, DataRefDeleter>(data);
 }
 
-GpgData::GpgData(std::shared_ptr<GFDataExchanger> ex)
-    : data_cbs_(), data_ex_(std::move(ex)) {
+GpgData::GpgData(GpgDataSink sink, size_t buffer_size)
+    : data_cbs_(),
+      sink_(std::move(sink)),
+      sink_buffer_size_(std::max<size_t>(buffer_size, 1)) {
+  gpgme_data_t data;
+
+  sink_buffer_.reserve(static_cast<qsizetype>(sink_buffer_size_));
+
+  // output only, gpgme neither reads nor seeks it
+  data_cbs_.read = nullptr;
+  data_cbs_.write = write_sink_cb;
+  data_cbs_.seek = nullptr;
+  data_cbs_.release = nullptr;
+
+  auto err = gpgme_data_new_from_cbs(&data, &data_cbs_, this);
+  assert(gpgme_err_code(err) == GPG_ERR_NO_ERROR);
+
+  data_ref_ = std::unique_ptr<struct gpgme_data, DataRefDeleter>(data);
+}
+
+auto GpgData::FlushSink() -> bool {
+  if (!sink_ || sink_failed_) return !sink_failed_;
+  if (!sink_buffer_.isEmpty()) {
+    sink_failed_ = !sink_(sink_buffer_.constData(),
+                          static_cast<size_t>(sink_buffer_.size()));
+    sink_buffer_.clear();
+  }
+  return !sink_failed_;
+}
+
+GpgData::GpgData(GpgDataSizeHint size_hint)
+    : buffer_output_(true), data_cbs_() {
   gpgme_data_t data;
 
-  data_cbs_.read = GFReadExCb;
-  data_cbs_.write = GFWriteExCb;
+  // avoid reallocations while gpgme is writing
+  out_buffer_.Reserve(size_hint.size);
+
+  // output only, gpgme neither reads nor seeks it
+  data_cbs_.read = nullptr;
+  data_cbs_.write = GFWriteBufferCb;
   data_cbs_.seek = nullptr;
-  data_cbs_.release = GFReleaseExCb;
+  data_cbs_.release = nullptr;
 
-  auto err = gpgme_data_new_from_cbs(&data, &data_cbs_, data_ex_.get());
+  auto err = gpgme_data_new_from_cbs(&data, &data_cbs_, &out_buffer_);
   assert(gpgme_err_code(err) == GPG_ERR_NO_ERROR);
 
   data_ref_ = std::unique_ptr<struct gpgme_data, DataRefDeleter>(data);
 }
 
 GpgData::~GpgData() {
+  // the release callback still uses the members, e.g. to close the writing
+  // side of the exchanger, release the handle while they are alive
+  data_ref_.reset();
+
   if (fp_ != nullptr) {
     fclose(fp_);
   }
@@ -127,9 +204,18 @@ GpgData::~GpgData() {
   if (fd_ >= 0) {
     close(fd_);
   }
+
+  // don't leave the partial output of a cancelled operation behind
+  auto* task = Thread::Task::Current();
+  if (!out_path_.isEmpty() && task != nullptr && task->IsCancelled()) {
+    GF_CORE_LOG_INFO("task cancelled, removing partial output: {}", out_path_);
+    QFile::remove(out_path_);
+  }
 }
 
 auto GpgData::Read2GFBuffer() -> GFBuffer {
+  if (buffer_output_) return std::move(out_buffer_);
+
   gpgme_off_t ret = gpgme_data_seek(*this, 0, SEEK_SET);
   GFBuffer out_buffer;
 
@@ -152,4 +238,215 @@ auto GpgData::Read2GFBuffer() -> GFBuffer {
 }
 
 GpgData::operator gpgme_data_t() { return data_ref_.get(); }
+
+auto GpgData::IsMapped() const -> bool { return mapped_ != nullptr; }
+
+void GpgData::SetProgressCb(GpgDataProgressCb cb) {
+  progress_cb_ = std::move(cb);
+}
+
+auto GpgData::ProcessedBytes() const -> qint64 { return processed_; }
+
+void GpgData::set_processed(qint64 processed) {
+  processed_ = processed;
+  if (progress_cb_) progress_cb_(processed);
+}
+
+auto GpgData::read_file_cb(void* handle, void* buffer, size_t size) -> ssize_t {
+  auto* data = static_cast<GpgData*>(handle);
+  if (data->fp_ == nullptr) {
+    errno = EBADF;
+    return -1;
+  }
+
+  auto ret = fread(buffer, 1, size, data->fp_);
+  if (ret == 0 && ferror(data->fp_) != 0) return -1;
+
+  data->set_processed(data->processed_ + static_cast<qint64>(ret));
+  return static_cast<ssize_t>(ret);
+}
+
+auto GpgData::write_file_cb(void* handle, const void* buffer, size_t size)
+    -> ssize_t {
+  auto* data = static_cast<GpgData*>(handle);
+  if (data->fp_ == nullptr) {
+    errno = EBADF;
+    return -1;
+  }
+
+  auto ret = fwrite(buffer, 1, size, data->fp_);
+  if (ret == 0 && ferror(data->fp_) != 0) return -1;
+
+  data->set_processed(data->processed_ + static_cast<qint64>(ret));
+  return static_cast<ssize_t>(ret);
+}
+
+auto GpgData::seek_file_cb(void* handle, off_t offset, int whence) -> off_t {
+  auto* data = static_cast<GpgData*>(handle);
+  if (data->fp_ == nullptr) {
+    errno = EBADF;
+    return -1;
+  }
+
+  if (fseeko(data->fp_, offset, whence) != 0) return -1;
+
+  auto pos = ftello(data->fp_);
+  if (pos >= 0) data->set_processed(pos);
+  return pos;
+}
+
+auto GpgData::read_mapped_cb(void* handle, void* buffer, size_t size)
+    -> ssize_t {
+  auto* data = static_cast<GpgData*>(handle);
+
+  auto pos = data->processed_.load();
+  auto len = std::min<qint64>(static_cast<qint64>(size),
+                              data->mapped_size_ - pos);
+  if (len <= 0) return 0;
+
+  memcpy(buffer, data->mapped_ + pos, static_cast<size_t>(len));
+  data->set_processed(pos + len);
+  return static_cast<ssize_t>(len);
+}
+
+auto GpgData::seek_mapped_cb(void* handle, off_t offset, int whence) -> off_t {
+  auto* data = static_cast<GpgData*>(handle);
+
+  qint64 pos;
+  switch (whence) {
+    case SEEK_SET:
+      pos = offset;
+      break;
+    case SEEK_CUR:
+      pos = data->processed_ + offset;
+      break;
+    case SEEK_END:
+      pos = data->mapped_size_ + offset;
+      break;
+    default:
+      errno = EINVAL;
+      return -1;
+  }
+
+  if (pos < 0 || pos > data->mapped_size_) {
+    errno = EINVAL;
+    return -1;
+  }
+
+  data->set_processed(pos);
+  return static_cast<off_t>(pos);
+}
+
+auto GpgData::read_ex_cb(void* handle, void* buffer, size_t size) -> ssize_t {
+  auto* data = static_cast<GpgData*>(handle);
+  auto ret = data->data_ex_->Read(static_cast<std::byte*>(buffer), size);
+  if (ret < 0) errno = ECANCELED;
+  if (ret > 0) data->set_processed(data->processed_ + ret);
+  return ret;
+}
+
+auto GpgData::write_ex_cb(void* handle, const void* buffer, size_t size)
+    -> ssize_t {
+  auto* data = static_cast<GpgData*>(handle);
+  auto ret =
+      data->data_ex_->Write(static_cast<const std::byte*>(buffer), size);
+  if (ret < 0) errno = ECANCELED;
+  if (ret > 0) data->set_processed(data->processed_ + ret);
+  return ret;
+}
+
+void GpgData::release_ex_cb(void* handle) {
+  static_cast<GpgData*>(handle)->data_ex_->CloseWrite();
+}
+
+auto GpgData::write_sink_cb(void* handle, const void* buffer, size_t size)
+    -> ssize_t {
+  auto* data = static_cast<GpgData*>(handle);
+  const auto* bytes = static_cast<const char*>(buffer);
+
+  // at most sink_buffer_size_ bytes are held, larger writes pass through
+  if (static_cast<size_t>(data->sink_buffer_.size()) + size >
+      data->sink_buffer_size_) {
+    if (!data->FlushSink()) {
+      errno = EIO;
+      return -1;
+    }
+  }
+
+  if (size >= data->sink_buffer_size_) {
+    data->sink_failed_ = !data->sink_(bytes, size);
+  } else {
+    data->sink_buffer_.append(bytes, static_cast<qsizetype>(size));
+  }
+
+  if (data->sink_failed_) {
+    errno = EIO;
+    return -1;
+  }
+  data->set_processed(data->processed_ + static_cast<qint64>(size));
+  return static_cast<ssize_t>(size);
+}
+
+void GpgData::init_from_stream(const QString& path, bool read) {
+  gpgme_data_t data;
+
+  // support unicode path
+  QFile file(path);
+  file.open(read ? QIODevice::ReadOnly : QIODevice::WriteOnly);
+  fp_ = fdopen(dup(file.handle()), read ? "rb" : "wb");
+  if (!read) out_path_ = path;
+
+  // same as gpgme's own stream data, but counting the bytes
+  data_cbs_.read = read_file_cb;
+  data_cbs_.write = write_file_cb;
+  data_cbs_.seek = seek_file_cb;
+  data_cbs_.release = nullptr;
+
+  auto err = gpgme_data_new_from_cbs(&data, &data_cbs_, this);
+  assert(gpgme_err_code(err) == GPG_ERR_NO_ERROR);
+
+  data_ref_ = std::unique_ptr<struct gpgme_data, DataRefDeleter>(data);
+}
+
+auto GpgData::init_from_mapped_file(const QString& path) -> bool {
+  auto file = std::make_unique<QFile>(path);
+  if (!file->open(QIODevice::ReadOnly) || file->size() <= 0) return false;
+
+  // fails for pipes, special files and files beyond the address space
+  auto* mapped = file->map(0, file->size());
+  if (mapped == nullptr) {
+    GF_CORE_LOG_DEBUG("cannot map file: {}, fallback to stream, reason: {}",
+                      path, file->errorString());
+    return false;
+  }
+
+#ifndef WINDOWS
+  // hints only, failures are harmless
+  madvise(mapped, file->size(), MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+  madvise(mapped, file->size(), MADV_HUGEPAGE);
+#endif
+#endif
+
+  mapped_file_ = std::move(file);
+  mapped_ = mapped;
+  mapped_size_ = mapped_file_->size();
+
+  data_cbs_.read = read_mapped_cb;
+  data_cbs_.write = nullptr;
+  data_cbs_.seek = seek_mapped_cb;
+  data_cbs_.release = nullptr;
+
+  gpgme_data_t data;
+  auto err = gpgme_data_new_from_cbs(&data, &data_cbs_, this);
+  if (gpgme_err_code(err) != GPG_ERR_NO_ERROR) {
+    mapped_file_->unmap(mapped_);
+    mapped_file_.reset();
+    mapped_ = nullptr;
+    return false;
+  }
+
+  data_ref_ = std::unique_ptr<struct gpgme_data, DataRefDeleter>(data);
+  return true;
+}
 }  // namespace GpgFrontend
\ No newline at end of file
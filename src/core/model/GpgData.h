@@ -36,6 +36,41 @@ namespace GpgFrontend {
 
 class GFDataExchanger;
 
+/**
+ * @brief expected size of the output of an operation
+ *
+ */
+struct GpgDataSizeHint {
+  size_t size = 0;
+};
+
+using GpgDataProgressCb = std::function<void(qint64)>;  ///<
+
+/**
+ * @brief receives the output of an operation piece by piece on the thread
+ * running it, returning false aborts the operation
+ *
+ */
+using GpgDataSink = std::function<bool(const char*, size_t)>;
+
+/**
+ * @brief a sink writing to an opened device, the caller keeps the device
+ * alive until the operation is done
+ *
+ * @param device
+ * @return GpgDataSink
+ */
+auto GPGFRONTEND_CORE_EXPORT MakeGpgDataSink(QIODevice* device)
+    -> GpgDataSink;
+
+/**
+ * @brief a sink writing to a file descriptor, which is not closed
+ *
+ * @param fd
+ * @return GpgDataSink
+ */
+auto GPGFRONTEND_CORE_EXPORT MakeGpgDataSink(int fd) -> GpgDataSink;
+
 /**
  * @brief
  *
@@ -79,11 +114,77 @@ class GPGFRONTEND_CORE_EXPORT GpgData {
   explicit GpgData(const QString& path, bool read);
 
   /**
-   * @brief Construct a new Gpg Data object
+   * @brief Construct a new Gpg Data object, the input file is memory mapped
+   * if map is true, otherwise or if mapping fails it is read as a stream
+   *
+   * @param path
+   * @param read
+   * @param map
+   */
+  explicit GpgData(const QString& path, bool read, bool map);
+
+  /**
+   * @brief
+   *
+   * @return true if the data is backed by a memory mapped file
+   */
+  [[nodiscard]] auto IsMapped() const -> bool;
+
+  /**
+   * @brief called with ProcessedBytes() after each read, write or seek of
+   * gpgme on a file or exchanger backed data object
+   *
+   * @param cb
+   */
+  void SetProgressCb(GpgDataProgressCb cb);
+
+  /**
+   * @brief
+   *
+   * @return qint64 bytes gpgme has read or written so far, or the position
+   * after its last seek
+   */
+  [[nodiscard]] auto ProcessedBytes() const -> qint64;
+
+  /**
+   * @brief Construct a new Gpg Data object, gpgme reads the storage of
+   * the buffer in place
    *
    */
   explicit GpgData(GFBuffer);
 
+  /**
+   * @brief Construct a new Gpg Data object reading a range of a buffer in
+   * place, the view keeps the storage alive
+   *
+   */
+  explicit GpgData(GFBufferView);
+
+  /**
+   * @brief Construct a new Gpg Data object for output, gpgme writes
+   * straight into a GFBuffer reserved by the size hint
+   *
+   * @param size_hint
+   */
+  explicit GpgData(GpgDataSizeHint size_hint);
+
+  /**
+   * @brief Construct a new Gpg Data object for output, gpgme writes are
+   * gathered up to buffer_size bytes and passed to the sink
+   *
+   * @param sink
+   * @param buffer_size
+   */
+  explicit GpgData(GpgDataSink sink, size_t buffer_size = 64 * 1024);
+
+  /**
+   * @brief pass the gathered output to the sink, call it once the operation
+   * is done
+   *
+   * @return false if the sink failed
+   */
+  auto FlushSink() -> bool;
+
   /**
    * @brief Destroy the Gpg Data object
    *
@@ -98,9 +199,10 @@ class GPGFRONTEND_CORE_EXPORT GpgData {
   operator gpgme_data_t();
 
   /**
-   * @brief
+   * @brief read all the data, for the output mode the collected buffer
+   * is handed over without copying
    *
-   * @return ByteArrayPtr
+   * @return GFBuffer
    */
   auto Read2GFBuffer() -> GFBuffer;
 
@@ -115,14 +217,73 @@ class GPGFRONTEND_CORE_EXPORT GpgData {
     }
   };
 
-  GFBuffer cached_buffer_;
+  GFBufferView cached_view_;
+  std::unique_ptr<QFile> mapped_file_;
+  uchar* mapped_ = nullptr;
+  qint64 mapped_size_ = 0;
+  GFBuffer out_buffer_;
+  bool buffer_output_ = false;
 
   std::unique_ptr<struct gpgme_data, DataRefDeleter> data_ref_ = nullptr;  ///<
   FILE* fp_ = nullptr;
+  QString out_path_;  ///< removed on close if the task was cancelled
   int fd_ = -1;
 
   struct gpgme_data_cbs data_cbs_;
   std::shared_ptr<GFDataExchanger> data_ex_;
+
+  GpgDataSink sink_;        ///<
+  QByteArray sink_buffer_;  ///< output not passed to the sink yet
+  size_t sink_buffer_size_ = 0;  ///<
+  bool sink_failed_ = false;     ///<
+
+  std::atomic<qint64> processed_{0};  ///<
+  GpgDataProgressCb progress_cb_;     ///<
+
+  /**
+   * @brief
+   *
+   * @param path
+   * @param read
+   */
+  void init_from_stream(const QString& path, bool read);
+
+  /**
+   * @brief
+   *
+   * @param path
+   * @return true if the file was mapped
+   */
+  auto init_from_mapped_file(const QString& path) -> bool;
+
+  /**
+   * @brief
+   *
+   * @param processed
+   */
+  void set_processed(qint64 processed);
+
+  static auto read_file_cb(void* handle, void* buffer, size_t size) -> ssize_t;
+
+  static auto write_file_cb(void* handle, const void* buffer, size_t size)
+      -> ssize_t;
+
+  static auto seek_file_cb(void* handle, off_t offset, int whence) -> off_t;
+
+  static auto read_mapped_cb(void* handle, void* buffer, size_t size)
+      -> ssize_t;
+
+  static auto seek_mapped_cb(void* handle, off_t offset, int whence) -> off_t;
+
+  static auto read_ex_cb(void* handle, void* buffer, size_t size) -> ssize_t;
+
+  static auto write_ex_cb(void* handle, const void* buffer, size_t size)
+      -> ssize_t;
+
+  static void release_ex_cb(void* handle);
+
+  static auto write_sink_cb(void* handle, const void* buffer, size_t size)
+      -> ssize_t;
 };
 
 }  // namespace GpgFrontend
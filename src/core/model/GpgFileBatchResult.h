@@ -0,0 +1,59 @@
+/**
+ * Copyright (C) 2021 Saturneric <eric@bktus.com>
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric <eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+#pragma once
+
+#include "core/typedef/GpgTypedef.h"
+
+namespace GpgFrontend {
+
+/**
+ * @brief outcome of one file of a batch operation of GpgFileOpera
+ *
+ */
+struct GpgFileBatchEntry {
+  QString in_path;                  ///<
+  QString out_path;                 ///<
+  GpgError err = GPG_ERR_NO_ERROR;  ///<
+  DataObjectPtr data_object;        ///< as returned for a single file
+};
+
+/**
+ * @brief per file results and a summary of a batch operation
+ *
+ */
+struct GpgFileBatchResult {
+  std::vector<GpgFileBatchEntry> entries;  ///< in the order of the input
+
+  size_t succeeded = 0;  ///<
+  size_t failed = 0;     ///<
+  qint64 in_bytes = 0;   ///< total size of all input files
+  qint64 elapsed = 0;    ///< wall clock time, in milliseconds
+  int workers = 0;       ///< number of files processed concurrently
+};
+
+}  // namespace GpgFrontend
@@ -51,4 +51,12 @@ GpgImportInformation::GpgImportInformation(gpgme_import_result_t result) {
   if (result->not_imported != 0) not_imported = result->not_imported;
 }
 
+auto GpgImportInformation::GetImportedKeyFprs() const -> QStringList {
+  QStringList fprs;
+  for (const auto& key : imported_keys) {
+    if (!key.fpr.isEmpty() && !fprs.contains(key.fpr)) fprs.append(key.fpr);
+  }
+  return fprs;
+}
+
 }  // namespace GpgFrontend
\ No newline at end of file
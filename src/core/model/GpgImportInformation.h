@@ -61,6 +61,13 @@ class GPGFRONTEND_CORE_EXPORT GpgImportInformation {
    */
   explicit GpgImportInformation(gpgme_import_result_t result);
 
+  /**
+   * @brief fingerprints of the keys the import touched
+   *
+   * @return QStringList
+   */
+  [[nodiscard]] auto GetImportedKeyFprs() const -> QStringList;
+
   int considered = 0;        ///<
   int no_user_id = 0;        ///<
   int imported = 0;          ///<
@@ -166,12 +166,22 @@ auto GpgKey::IsHasAuthenticationCapability() const -> bool {
 }
 
 auto GpgKey::IsHasCardKey() const -> bool {
-  auto subkeys = GetSubKeys();
+  auto subkeys = GetSubKeyView();
   return std::any_of(
-      subkeys->begin(), subkeys->end(),
+      subkeys.begin(), subkeys.end(),
       [](const GpgSubKey &subkey) -> bool { return subkey.IsCardKey(); });
 }
 
+auto GpgKey::IsHasDetail() const -> bool {
+  if ((key_ref_->keylist_mode & GPGME_KEYLIST_MODE_SIGS) == 0) return false;
+
+  // a listing in secret mode keeps the mode but leaves the signatures out
+  for (auto *uid = key_ref_->uids; uid != nullptr; uid = uid->next) {
+    if (uid->signatures != nullptr || uid->tofu != nullptr) return true;
+  }
+  return false;
+}
+
 auto GpgKey::IsPrivateKey() const -> bool { return key_ref_->secret; }
 
 auto GpgKey::IsExpired() const -> bool { return key_ref_->expired; }
@@ -204,10 +214,18 @@ auto GpgKey::GetUIDs() const -> std::unique_ptr<std::vector<GpgUID>> {
   return p_uids;
 }
 
+auto GpgKey::GetSubKeyView() const -> GpgSubKeyView {
+  return GpgSubKeyView(key_ref_->subkeys);
+}
+
+auto GpgKey::GetUIDView() const -> GpgUIDView {
+  return GpgUIDView(key_ref_->uids);
+}
+
 auto GpgKey::IsHasActualSigningCapability() const -> bool {
-  auto subkeys = GetSubKeys();
+  auto subkeys = GetSubKeyView();
   return std::any_of(
-      subkeys->begin(), subkeys->end(), [](const GpgSubKey &subkey) -> bool {
+      subkeys.begin(), subkeys.end(), [](const GpgSubKey &subkey) -> bool {
         return subkey.IsSecretKey() && subkey.IsHasSigningCapability() &&
                !subkey.IsDisabled() && !subkey.IsRevoked() &&
                !subkey.IsExpired();
@@ -215,9 +233,9 @@ auto GpgKey::IsHasActualSigningCapability() const -> bool {
 }
 
 auto GpgKey::IsHasActualAuthenticationCapability() const -> bool {
-  auto subkeys = GetSubKeys();
+  auto subkeys = GetSubKeyView();
   return std::any_of(
-      subkeys->begin(), subkeys->end(), [](const GpgSubKey &subkey) -> bool {
+      subkeys.begin(), subkeys.end(), [](const GpgSubKey &subkey) -> bool {
         return subkey.IsSecretKey() && subkey.IsHasAuthenticationCapability() &&
                !subkey.IsDisabled() && !subkey.IsRevoked() &&
                !subkey.IsExpired();
@@ -239,9 +257,9 @@ auto GpgKey::IsHasActualCertificationCapability() const -> bool {
  * @return if key encrypt
  */
 auto GpgKey::IsHasActualEncryptionCapability() const -> bool {
-  auto subkeys = GetSubKeys();
+  auto subkeys = GetSubKeyView();
   return std::any_of(
-      subkeys->begin(), subkeys->end(), [](const GpgSubKey &subkey) -> bool {
+      subkeys.begin(), subkeys.end(), [](const GpgSubKey &subkey) -> bool {
         return subkey.IsHasEncryptionCapability() && !subkey.IsDisabled() &&
                !subkey.IsRevoked() && !subkey.IsExpired();
       });
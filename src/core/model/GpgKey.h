@@ -28,11 +28,15 @@
 
 #pragma once
 
+#include "core/model/GpgLinkedListView.h"
 #include "core/model/GpgSubKey.h"
 #include "core/model/GpgUID.h"
 
 namespace GpgFrontend {
 
+using GpgSubKeyView = GpgLinkedListView<GpgSubKey, gpgme_subkey_t>;
+using GpgUIDView = GpgLinkedListView<GpgUID, gpgme_user_id_t>;
+
 /**
  * @brief
  *
@@ -219,6 +223,16 @@ class GPGFRONTEND_CORE_EXPORT GpgKey {
    */
   [[nodiscard]] auto IsHasCardKey() const -> bool;
 
+  /**
+   * @brief whether the key was listed with its signatures, notations and
+   * tofu information and any of them came along, see
+   * GpgKeyGetter::GetKeyDetail()
+   *
+   * @return true
+   * @return false
+   */
+  [[nodiscard]] auto IsHasDetail() const -> bool;
+
   /**
    * @brief
    *
@@ -274,6 +288,21 @@ class GPGFRONTEND_CORE_EXPORT GpgKey {
    */
   [[nodiscard]] auto GetUIDs() const -> std::unique_ptr<std::vector<GpgUID>>;
 
+  /**
+   * @brief the subkeys without copying them out, the key must outlive the
+   * view
+   *
+   * @return GpgSubKeyView
+   */
+  [[nodiscard]] auto GetSubKeyView() const -> GpgSubKeyView;
+
+  /**
+   * @brief the uids without copying them out, the key must outlive the view
+   *
+   * @return GpgUIDView
+   */
+  [[nodiscard]] auto GetUIDView() const -> GpgUIDView;
+
   /**
    * @brief Construct a new Gpg Key object
    *
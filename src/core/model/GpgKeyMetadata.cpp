@@ -0,0 +1,88 @@
+/**
+ * Copyright (C) 2021 Saturneric <eric@bktus.com>
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric <eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include "core/model/GpgKeyMetadata.h"
+
+namespace GpgFrontend {
+
+auto GpgKeyMetadata::FromKey(const GpgKey& key) -> GpgKeyMetadata {
+  GpgKeyMetadata metadata;
+  metadata.fingerprint = key.GetFingerprint();
+  metadata.id = key.GetId();
+  metadata.name = key.GetName();
+  metadata.email = key.GetEmail();
+  metadata.comment = key.GetComment();
+  metadata.owner_trust = key.GetOwnerTrust();
+  metadata.algo = key.GetKeyAlgo();
+  metadata.create_time = key.GetCreateTime();
+  metadata.expire_time = key.GetExpireTime();
+
+  const std::initializer_list<std::pair<Flag, bool>> flags = {
+      {kPrivateKey, key.IsPrivateKey()},
+      {kHasMasterKey, key.IsHasMasterKey()},
+      {kHasCardKey, key.IsHasCardKey()},
+      {kExpired, key.IsExpired()},
+      {kRevoked, key.IsRevoked()},
+      {kDisabled, key.IsDisabled()},
+      {kCertification, key.IsHasActualCertificationCapability()},
+      {kEncryption, key.IsHasActualEncryptionCapability()},
+      {kSigning, key.IsHasActualSigningCapability()},
+      {kAuthentication, key.IsHasActualAuthenticationCapability()},
+  };
+  for (const auto& flag : flags) {
+    if (flag.second) metadata.flags |= flag.first;
+  }
+  return metadata;
+}
+
+auto GpgKeyMetadata::GetUsage() const -> QString {
+  QString usage;
+  if (Has(kCertification)) usage += "C";
+  if (Has(kEncryption)) usage += "E";
+  if (Has(kSigning)) usage += "S";
+  if (Has(kAuthentication)) usage += "A";
+  return usage;
+}
+
+auto operator<<(QDataStream& stream, const GpgKeyMetadata& metadata)
+    -> QDataStream& {
+  return stream << metadata.fingerprint << metadata.id << metadata.name
+                << metadata.email << metadata.comment << metadata.owner_trust
+                << metadata.algo << metadata.create_time
+                << metadata.expire_time << metadata.flags;
+}
+
+auto operator>>(QDataStream& stream, GpgKeyMetadata& metadata)
+    -> QDataStream& {
+  return stream >> metadata.fingerprint >> metadata.id >> metadata.name >>
+         metadata.email >> metadata.comment >> metadata.owner_trust >>
+         metadata.algo >> metadata.create_time >> metadata.expire_time >>
+         metadata.flags;
+}
+
+}  // namespace GpgFrontend
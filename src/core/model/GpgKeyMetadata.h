@@ -0,0 +1,100 @@
+/**
+ * Copyright (C) 2021 Saturneric <eric@bktus.com>
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric <eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#pragma once
+
+#include "core/model/GpgKey.h"
+
+namespace GpgFrontend {
+
+/**
+ * @brief what the key tables show of a key, as plain values which outlive
+ * the gpgme key and can be stored on disk
+ *
+ */
+struct GPGFRONTEND_CORE_EXPORT GpgKeyMetadata {
+  enum Flag : quint32 {
+    kPrivateKey = 1 << 0,
+    kHasMasterKey = 1 << 1,
+    kHasCardKey = 1 << 2,
+    kExpired = 1 << 3,
+    kRevoked = 1 << 4,
+    kDisabled = 1 << 5,
+    kCertification = 1 << 6,  ///< actual capabilities, subkeys included
+    kEncryption = 1 << 7,
+    kSigning = 1 << 8,
+    kAuthentication = 1 << 9,
+  };
+
+  QString fingerprint;    ///<
+  QString id;             ///<
+  QString name;           ///<
+  QString email;          ///<
+  QString comment;        ///<
+  QString owner_trust;    ///< as shown when it was taken
+  QString algo;           ///<
+  QDateTime create_time;  ///<
+  QDateTime expire_time;  ///<
+  quint32 flags = 0;      ///< combination of Flag
+
+  /**
+   * @brief take the metadata of a key
+   *
+   * @param key
+   * @return GpgKeyMetadata
+   */
+  static auto FromKey(const GpgKey& key) -> GpgKeyMetadata;
+
+  /**
+   * @brief
+   *
+   * @param flag
+   * @return true
+   * @return false
+   */
+  [[nodiscard]] auto Has(Flag flag) const -> bool {
+    return (flags & flag) != 0;
+  }
+
+  /**
+   * @brief the usage letters of the key tables, e.g. "CES"
+   *
+   * @return QString
+   */
+  [[nodiscard]] auto GetUsage() const -> QString;
+};
+
+GPGFRONTEND_CORE_EXPORT auto operator<<(QDataStream& stream,
+                                        const GpgKeyMetadata& metadata)
+    -> QDataStream&;
+
+GPGFRONTEND_CORE_EXPORT auto operator>>(QDataStream& stream,
+                                        GpgKeyMetadata& metadata)
+    -> QDataStream&;
+
+}  // namespace GpgFrontend
@@ -0,0 +1,234 @@
+/**
+ * Copyright (C) 2021 Saturneric <eric@bktus.com>
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric <eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include "core/model/GpgKeySummaryTable.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace GpgFrontend {
+
+GpgKeySummaryTable::GpgKeySummaryTable(KeyListSnapshotPtr keys)
+    : keys_(std::move(keys)) {
+  if (keys_ == nullptr) keys_ = std::make_shared<const GpgKeyLinkList>();
+
+  const auto size = static_cast<int>(keys_->size());
+  for (auto* column : {&fpr_, &id_, &name_, &email_, &comment_, &owner_trust_,
+                       &algo_, &flags_}) {
+    column->reserve(size);
+  }
+  key_refs_.reserve(size);
+  owner_trust_level_.reserve(size);
+  create_time_.reserve(size);
+  expire_time_.reserve(size);
+  rows_.reserve(size);
+
+  // names, trust levels and algorithms repeat a lot, keep one copy of each
+  QHash<QString, quint32> pool;
+  auto intern = [this, &pool](const QString& str) -> quint32 {
+    auto it = pool.constFind(str);
+    if (it != pool.constEnd()) return it.value();
+
+    auto index = static_cast<quint32>(strings_.size());
+    strings_.push_back(str);
+    pool.insert(str, index);
+    return index;
+  };
+
+  for (const auto& key : *keys_) {
+    auto metadata = GpgKeyMetadata::FromKey(key);
+
+    rows_.insert(metadata.fingerprint, static_cast<int>(key_refs_.size()));
+    key_refs_.push_back(&key);
+    fpr_.push_back(intern(metadata.fingerprint));
+    id_.push_back(intern(metadata.id));
+    name_.push_back(intern(metadata.name));
+    email_.push_back(intern(metadata.email));
+    comment_.push_back(intern(metadata.comment));
+    owner_trust_.push_back(intern(metadata.owner_trust));
+    algo_.push_back(intern(metadata.algo));
+    owner_trust_level_.push_back(
+        static_cast<qint8>(key.GetOwnerTrustLevel()));
+    flags_.push_back(metadata.flags);
+    create_time_.push_back(metadata.create_time.toSecsSinceEpoch());
+    expire_time_.push_back(metadata.expire_time.toSecsSinceEpoch());
+  }
+}
+
+auto GpgKeySummaryTable::GetKeys() const -> const KeyListSnapshotPtr& {
+  return keys_;
+}
+
+auto GpgKeySummaryTable::Size() const -> int {
+  return static_cast<int>(key_refs_.size());
+}
+
+auto GpgKeySummaryTable::IndexOf(const QString& fpr) const -> int {
+  return rows_.value(fpr, -1);
+}
+
+auto GpgKeySummaryTable::GetKey(int row) const -> const GpgKey& {
+  return *key_refs_[row];
+}
+
+auto GpgKeySummaryTable::GetFingerprint(int row) const -> const QString& {
+  return strings_[fpr_[row]];
+}
+
+auto GpgKeySummaryTable::GetId(int row) const -> const QString& {
+  return strings_[id_[row]];
+}
+
+auto GpgKeySummaryTable::GetName(int row) const -> const QString& {
+  return strings_[name_[row]];
+}
+
+auto GpgKeySummaryTable::GetEmail(int row) const -> const QString& {
+  return strings_[email_[row]];
+}
+
+auto GpgKeySummaryTable::GetComment(int row) const -> const QString& {
+  return strings_[comment_[row]];
+}
+
+auto GpgKeySummaryTable::GetOwnerTrust(int row) const -> const QString& {
+  return strings_[owner_trust_[row]];
+}
+
+auto GpgKeySummaryTable::GetOwnerTrustLevel(int row) const -> int {
+  return owner_trust_level_[row];
+}
+
+auto GpgKeySummaryTable::GetKeyAlgo(int row) const -> const QString& {
+  return strings_[algo_[row]];
+}
+
+auto GpgKeySummaryTable::GetCreateTime(int row) const -> qint64 {
+  return create_time_[row];
+}
+
+auto GpgKeySummaryTable::GetExpireTime(int row) const -> qint64 {
+  return expire_time_[row];
+}
+
+auto GpgKeySummaryTable::Has(int row, GpgKeyMetadata::Flag flag) const
+    -> bool {
+  return (flags_[row] & flag) != 0;
+}
+
+auto GpgKeySummaryTable::GetMetadata(int row) const -> GpgKeyMetadata {
+  GpgKeyMetadata metadata;
+  metadata.fingerprint = GetFingerprint(row);
+  metadata.id = GetId(row);
+  metadata.name = GetName(row);
+  metadata.email = GetEmail(row);
+  metadata.comment = GetComment(row);
+  metadata.owner_trust = GetOwnerTrust(row);
+  metadata.algo = GetKeyAlgo(row);
+  metadata.create_time = QDateTime::fromSecsSinceEpoch(create_time_[row]);
+  metadata.expire_time = QDateTime::fromSecsSinceEpoch(expire_time_[row]);
+  metadata.flags = flags_[row];
+  return metadata;
+}
+
+auto GpgKeySummaryTable::SortedRows(Column column,
+                                    Qt::SortOrder order) const -> QVector<int> {
+  QVector<int> rows(Size());
+  std::iota(rows.begin(), rows.end(), 0);
+
+  // compare plain integers, the strings are compared once by rank_strings
+  QVector<qint64> sort_keys;
+  auto sort_by_strings = [&](const QVector<quint32>& strings) {
+    auto ranks = rank_strings(strings);
+    sort_keys.reserve(Size());
+    for (auto index : strings) sort_keys.push_back(ranks[index]);
+  };
+
+  switch (column) {
+    case kName:
+      sort_by_strings(name_);
+      break;
+    case kEmail:
+      sort_by_strings(email_);
+      break;
+    case kKeyId:
+      sort_by_strings(id_);
+      break;
+    case kFingerprint:
+      sort_by_strings(fpr_);
+      break;
+    case kOwnerTrust:
+      sort_keys = QVector<qint64>(owner_trust_level_.begin(),
+                                  owner_trust_level_.end());
+      break;
+    case kCreateTime:
+      sort_keys = create_time_;
+      break;
+    case kExpireTime:
+      sort_keys = expire_time_;
+      break;
+    case kListing:
+    default:
+      return rows;
+  }
+
+  if (order == Qt::AscendingOrder) {
+    std::stable_sort(rows.begin(), rows.end(), [&sort_keys](int a, int b) {
+      return sort_keys[a] < sort_keys[b];
+    });
+  } else {
+    std::stable_sort(rows.begin(), rows.end(), [&sort_keys](int a, int b) {
+      return sort_keys[a] > sort_keys[b];
+    });
+  }
+  return rows;
+}
+
+auto GpgKeySummaryTable::rank_strings(const QVector<quint32>& column) const
+    -> QVector<int> {
+  QVector<quint32> used(column);
+  std::sort(used.begin(), used.end());
+  used.erase(std::unique(used.begin(), used.end()), used.end());
+
+  std::sort(used.begin(), used.end(), [this](quint32 a, quint32 b) {
+    return strings_[a].compare(strings_[b], Qt::CaseInsensitive) < 0;
+  });
+
+  QVector<int> ranks(strings_.size(), 0);
+  int rank = 0;
+  for (int i = 0; i < used.size(); i++) {
+    if (i > 0 && strings_[used[i - 1]].compare(strings_[used[i]],
+                                               Qt::CaseInsensitive) != 0) {
+      rank++;
+    }
+    ranks[used[i]] = rank;
+  }
+  return ranks;
+}
+
+}  // namespace GpgFrontend
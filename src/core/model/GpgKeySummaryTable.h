@@ -0,0 +1,161 @@
+/**
+ * Copyright (C) 2021 Saturneric <eric@bktus.com>
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric <eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#pragma once
+
+#include "core/model/GpgKeyMetadata.h"
+#include "core/typedef/GpgTypedef.h"
+
+namespace GpgFrontend {
+
+/**
+ * @brief what the key tables need of a listing, taken once and laid out
+ * column by column: strings interned into one pool, capabilities as bit
+ * flags and timestamps as seconds, so rendering and sorting thousands of
+ * keys never walks the gpgme linked lists again
+ *
+ */
+class GPGFRONTEND_CORE_EXPORT GpgKeySummaryTable {
+ public:
+  enum Column {
+    kListing,  ///< the order of the listing
+    kName,
+    kEmail,
+    kKeyId,
+    kFingerprint,
+    kOwnerTrust,  ///< by the trust level
+    kCreateTime,
+    kExpireTime,
+  };
+
+  /**
+   * @brief take the summary of the keys, which are kept alive by the table
+   *
+   * @param keys
+   */
+  explicit GpgKeySummaryTable(KeyListSnapshotPtr keys);
+
+  /**
+   * @brief the listing the table was taken from
+   *
+   * @return const KeyListSnapshotPtr&
+   */
+  [[nodiscard]] auto GetKeys() const -> const KeyListSnapshotPtr&;
+
+  /**
+   * @brief
+   *
+   * @return int
+   */
+  [[nodiscard]] auto Size() const -> int;
+
+  /**
+   * @brief
+   *
+   * @param fpr
+   * @return int the row of the key, -1 if it is not in the table
+   */
+  [[nodiscard]] auto IndexOf(const QString& fpr) const -> int;
+
+  /**
+   * @brief the key in the row, in the order of the listing
+   *
+   * @param row
+   * @return const GpgKey&
+   */
+  [[nodiscard]] auto GetKey(int row) const -> const GpgKey&;
+
+  [[nodiscard]] auto GetFingerprint(int row) const -> const QString&;  ///<
+  [[nodiscard]] auto GetId(int row) const -> const QString&;           ///<
+  [[nodiscard]] auto GetName(int row) const -> const QString&;         ///<
+  [[nodiscard]] auto GetEmail(int row) const -> const QString&;        ///<
+  [[nodiscard]] auto GetComment(int row) const -> const QString&;      ///<
+  [[nodiscard]] auto GetOwnerTrust(int row) const -> const QString&;   ///<
+  [[nodiscard]] auto GetOwnerTrustLevel(int row) const -> int;         ///<
+  [[nodiscard]] auto GetKeyAlgo(int row) const -> const QString&;      ///<
+  [[nodiscard]] auto GetCreateTime(int row) const -> qint64;           ///<
+  [[nodiscard]] auto GetExpireTime(int row) const -> qint64;           ///<
+
+  /**
+   * @brief
+   *
+   * @param row
+   * @param flag
+   * @return true
+   * @return false
+   */
+  [[nodiscard]] auto Has(int row, GpgKeyMetadata::Flag flag) const -> bool;
+
+  /**
+   * @brief the row as the key tables render it
+   *
+   * @param row
+   * @return GpgKeyMetadata
+   */
+  [[nodiscard]] auto GetMetadata(int row) const -> GpgKeyMetadata;
+
+  /**
+   * @brief the rows ordered by a column, strings ignoring case, keys which
+   * compare equal stay in the order of the listing
+   *
+   * @param column
+   * @param order
+   * @return QVector<int>
+   */
+  [[nodiscard]] auto SortedRows(Column column, Qt::SortOrder order) const
+      -> QVector<int>;
+
+ private:
+  KeyListSnapshotPtr keys_;           ///<
+  QVector<const GpgKey*> key_refs_;   ///< into keys_, by row
+  QVector<QString> strings_;          ///< the interned strings
+  QVector<quint32> fpr_;              ///< columns of indexes into strings_
+  QVector<quint32> id_;               ///<
+  QVector<quint32> name_;             ///<
+  QVector<quint32> email_;            ///<
+  QVector<quint32> comment_;          ///<
+  QVector<quint32> owner_trust_;      ///<
+  QVector<quint32> algo_;             ///<
+  QVector<qint8> owner_trust_level_;  ///<
+  QVector<quint32> flags_;            ///< combination of GpgKeyMetadata::Flag
+  QVector<qint64> create_time_;       ///<
+  QVector<qint64> expire_time_;       ///<
+  QHash<QString, int> rows_;          ///< fingerprint to row
+
+  /**
+   * @brief the rank of each interned string of the column in the sorted
+   * order, strings equal ignoring case share their rank
+   *
+   * @param column
+   * @return QVector<int> by string index
+   */
+  [[nodiscard]] auto rank_strings(const QVector<quint32>& column) const
+      -> QVector<int>;
+};
+
+}  // namespace GpgFrontend
@@ -0,0 +1,123 @@
+/**
+ * Copyright (C) 2021 Saturneric <eric@bktus.com>
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric <eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+
+namespace GpgFrontend {
+
+/**
+ * @brief a view over a gpgme linked list (subkeys, uids, signatures, tofu
+ * information...), the elements are wrapped on the fly while iterating so
+ * walking it allocates nothing, the list must outlive the view
+ *
+ * @tparam T the wrapper, constructible from a node
+ * @tparam Node the gpgme node pointer, with a next member
+ */
+template <typename T, typename Node>
+class GpgLinkedListView {
+ public:
+  class Iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;  ///<
+    using value_type = T;                               ///<
+    using difference_type = std::ptrdiff_t;             ///<
+    using pointer = void;                               ///<
+    using reference = T;                                ///< a temporary
+
+    explicit Iterator(Node node = nullptr) : node_(node) {}
+
+    auto operator*() const -> T { return T(node_); }
+
+    auto operator++() -> Iterator& {
+      node_ = node_->next;
+      return *this;
+    }
+
+    auto operator++(int) -> Iterator {
+      auto it = *this;
+      ++*this;
+      return it;
+    }
+
+    auto operator==(const Iterator& o) const -> bool {
+      return node_ == o.node_;
+    }
+
+    auto operator!=(const Iterator& o) const -> bool {
+      return node_ != o.node_;
+    }
+
+   private:
+    Node node_;  ///<
+  };
+
+  /**
+   * @brief Construct a new view
+   *
+   * @param head the first node, may be null
+   */
+  explicit GpgLinkedListView(Node head) : head_(head) {}
+
+  [[nodiscard]] auto begin() const -> Iterator { return Iterator(head_); }
+
+  [[nodiscard]] auto end() const -> Iterator { return Iterator(); }
+
+  /**
+   * @brief
+   *
+   * @return true
+   * @return false
+   */
+  [[nodiscard]] auto Empty() const -> bool { return head_ == nullptr; }
+
+  /**
+   * @brief the count of the nodes, walks the list
+   *
+   * @return size_t
+   */
+  [[nodiscard]] auto Size() const -> size_t {
+    size_t size = 0;
+    for (auto node = head_; node != nullptr; node = node->next) size++;
+    return size;
+  }
+
+  /**
+   * @brief the first element, the view must not be empty
+   *
+   * @return T
+   */
+  [[nodiscard]] auto Front() const -> T { return T(head_); }
+
+ private:
+  Node head_;  ///<
+};
+
+}  // namespace GpgFrontend
@@ -51,6 +51,8 @@ auto GpgSubKey::GetID() const -> QString { return subkey_ref_->keyid; }
 
 auto GpgSubKey::GetFingerprint() const -> QString { return subkey_ref_->fpr; }
 
+auto GpgSubKey::GetKeyGrip() const -> QString { return subkey_ref_->keygrip; }
+
 auto GpgSubKey::GetPubkeyAlgo() const -> QString {
   return gpgme_pubkey_algo_name(subkey_ref_->pubkey_algo);
 }
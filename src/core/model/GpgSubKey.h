@@ -50,6 +50,14 @@ class GPGFRONTEND_CORE_EXPORT GpgSubKey {
    */
   [[nodiscard]] auto GetFingerprint() const -> QString;
 
+  /**
+   * @brief the keygrip, which names the file of the secret key in the
+   * private-keys-v1.d directory
+   *
+   * @return QString
+   */
+  [[nodiscard]] auto GetKeyGrip() const -> QString;
+
   /**
    * @brief
    *
@@ -49,6 +49,10 @@ auto GpgUID::GetRevoked() const -> bool { return uid_ref_->revoked; }
 
 auto GpgUID::GetInvalid() const -> bool { return uid_ref_->invalid; }
 
+auto GpgUID::GetValidity() const -> gpgme_validity_t {
+  return uid_ref_->validity;
+}
+
 auto GpgUID::GetTofuInfos() const -> std::unique_ptr<std::vector<GpgTOFUInfo>> {
   auto infos = std::make_unique<std::vector<GpgTOFUInfo>>();
   auto *info_next = uid_ref_->tofu;
@@ -70,4 +74,12 @@ auto GpgUID::GetSignatures() const
   return sigs;
 }
 
+auto GpgUID::GetTofuInfoView() const -> GpgTOFUInfoView {
+  return GpgTOFUInfoView(uid_ref_->tofu);
+}
+
+auto GpgUID::GetSignatureView() const -> GpgKeySignatureView {
+  return GpgKeySignatureView(uid_ref_->signatures);
+}
+
 }  // namespace GpgFrontend
\ No newline at end of file
@@ -29,9 +29,15 @@
 #pragma once
 
 #include "GpgKeySignature.h"
+#include "GpgLinkedListView.h"
 #include "GpgTOFUInfo.h"
 
 namespace GpgFrontend {
+
+using GpgKeySignatureView =
+    GpgLinkedListView<GpgKeySignature, gpgme_key_sig_t>;
+using GpgTOFUInfoView = GpgLinkedListView<GpgTOFUInfo, gpgme_tofu_info_t>;
+
 /**
  * @brief
  *
@@ -82,6 +88,14 @@ class GPGFRONTEND_CORE_EXPORT GpgUID {
    */
   [[nodiscard]] auto GetInvalid() const -> bool;
 
+  /**
+   * @brief how far the uid is trusted to belong to the key, computed from
+   * the trustdb
+   *
+   * @return gpgme_validity_t
+   */
+  [[nodiscard]] auto GetValidity() const -> gpgme_validity_t;
+
   /**
    * @brief
    *
@@ -98,6 +112,22 @@ class GPGFRONTEND_CORE_EXPORT GpgUID {
   [[nodiscard]] auto GetSignatures() const
       -> std::unique_ptr<std::vector<GpgKeySignature>>;
 
+  /**
+   * @brief the tofu information without copying it out, the key must
+   * outlive the view
+   *
+   * @return GpgTOFUInfoView
+   */
+  [[nodiscard]] auto GetTofuInfoView() const -> GpgTOFUInfoView;
+
+  /**
+   * @brief the signatures without copying them out, the key must outlive
+   * the view
+   *
+   * @return GpgKeySignatureView
+   */
+  [[nodiscard]] auto GetSignatureView() const -> GpgKeySignatureView;
+
   /**
    * @brief Construct a new Gpg U I D object
    *
@@ -30,10 +30,20 @@
 
 #include <qscopedpointer.h>
 
+#include <atomic>
+#include <map>
+#include <mutex>
+
 #include "utils/MemoryUtils.h"
 
 namespace GpgFrontend::Thread {
 
+namespace {
+
+thread_local Task *current_task = nullptr;
+
+}  // namespace
+
 class Task::Impl {
  public:
   Impl(Task *parent, QString name)
@@ -126,6 +136,82 @@ class Task::Impl {
    */
   [[nodiscard]] auto GetRTN() const { return this->rtn_; }
 
+  /**
+   * @brief
+   *
+   */
+  void Cancel() {
+    // hooks run under the lock, so a removed hook never runs afterwards
+    std::lock_guard<std::mutex> lock(cancel_lock_);
+    if (cancelled_.exchange(true)) return;
+
+    GF_CORE_LOG_DEBUG("task {} is cancelled, hooks: {}", GetFullID(),
+                      cancel_hooks_.size());
+    for (auto &[id, hook] : cancel_hooks_) hook();
+  }
+
+  /**
+   * @brief
+   *
+   * @return true if cancelled
+   */
+  [[nodiscard]] auto IsCancelled() const -> bool { return cancelled_; }
+
+  /**
+   * @brief
+   *
+   * @param hook
+   * @return int
+   */
+  auto AddCancelHook(std::function<void()> hook) -> int {
+    std::lock_guard<std::mutex> lock(cancel_lock_);
+    if (cancelled_) {
+      hook();
+      return -1;
+    }
+
+    auto id = next_cancel_hook_id_++;
+    cancel_hooks_.emplace(id, std::move(hook));
+    return id;
+  }
+
+  /**
+   * @brief
+   *
+   * @param id
+   */
+  void RemoveCancelHook(int id) {
+    std::lock_guard<std::mutex> lock(cancel_lock_);
+    cancel_hooks_.erase(id);
+  }
+
+  /**
+   * @brief
+   *
+   * @param processed
+   * @param total
+   * @param speed set if a progress signal is due
+   * @return true if a progress signal is due
+   */
+  auto UpdateProgress(qint64 processed, qint64 total, double &speed) -> bool {
+    std::lock_guard<std::mutex> lock(progress_lock_);
+    const auto now = progress_timer_.elapsed();
+    const auto finished = total > 0 && processed >= total;
+    if (finished ? progress_finished_
+                 : now - progress_last_signal_ < kTaskProgressInterval) {
+      return false;
+    }
+
+    const auto interval = std::max<qint64>(now - progress_last_signal_, 1);
+    speed = static_cast<double>(processed - progress_last_bytes_) * 1000 /
+            static_cast<double>(interval);
+
+    progress_last_signal_ = now;
+    progress_last_bytes_ = processed;
+    progress_finished_ = finished;
+    return true;
+  }
+
  private:
   Task *const parent_;
   const QString uuid_;
@@ -136,10 +222,24 @@ class Task::Impl {
   QThread *callback_thread_ = nullptr;   ///<
   DataObjectPtr data_object_ = nullptr;  ///<
 
+  std::mutex cancel_lock_;                             ///<
+  std::atomic_bool cancelled_ = false;                 ///<
+  std::map<int, std::function<void()>> cancel_hooks_;  ///<
+  int next_cancel_hook_id_ = 0;                        ///<
+
+  std::mutex progress_lock_;         ///<
+  QElapsedTimer progress_timer_;     ///< started with the task
+  qint64 progress_last_signal_ = 0;  ///< ms since the task was created
+  qint64 progress_last_bytes_ = 0;   ///<
+  bool progress_finished_ = false;   ///<
+
   void init() {
     GF_CORE_LOG_TRACE("task {} created, parent: {}, impl: {}", name_,
                       static_cast<void *>(parent_), static_cast<void *>(this));
 
+    // the progress interval counts from the creation of the task
+    progress_timer_.start();
+
     //
     HoldOnLifeCycle(false);
 
@@ -227,7 +327,7 @@ void Task::TaskHandler::Start() {
 }
 
 void Task::TaskHandler::Cancel() {
-  if (task_ != nullptr) emit task_->SignalTaskEnd();
+  if (task_ != nullptr) task_->Cancel();
 }
 
 auto Task::TaskHandler::GetTask() -> Task * {
@@ -237,6 +337,7 @@ auto Task::TaskHandler::GetTask() -> Task * {
 
 void Task::slot_exception_safe_run() noexcept {
   auto rtn = p_->GetRTN();
+  auto *outer_task = std::exchange(current_task, this);
   try {
     GF_CORE_LOG_TRACE("task runnable {} is starting...", GetFullID());
 
@@ -247,9 +348,36 @@ void Task::slot_exception_safe_run() noexcept {
   } catch (...) {
     GF_CORE_LOG_ERROR("exception was caught at task: {}", GetFullID());
   }
+  current_task = outer_task;
 
   // raise signal to anounce after runnable returned
   if (this->autoDelete()) emit this->SignalTaskShouldEnd(rtn);
 }
 auto Task::GetRTN() { return p_->GetRTN(); }
+
+void Task::ReportProgress(qint64 processed, qint64 total) {
+  double speed = 0;
+  if (p_->UpdateProgress(processed, total, speed)) {
+    emit SignalTaskProgress(processed, total, speed);
+  }
+}
+
+auto Task::Current() -> Task * { return current_task; }
+
+void Task::RunOnBehalf(const std::function<void()> &function) {
+  auto *outer_task = std::exchange(current_task, this);
+  function();
+  current_task = outer_task;
+}
+
+void Task::Cancel() { p_->Cancel(); }
+
+auto Task::IsCancelled() const -> bool { return p_->IsCancelled(); }
+
+auto Task::AddCancelHook(std::function<void()> hook) -> int {
+  return p_->AddCancelHook(std::move(hook));
+}
+
+void Task::RemoveCancelHook(int id) { p_->RemoveCancelHook(id); }
+
 }  // namespace GpgFrontend::Thread
\ No newline at end of file
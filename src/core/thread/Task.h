@@ -36,6 +36,8 @@ namespace GpgFrontend::Thread {
 
 class TaskRunner;
 
+constexpr qint64 kTaskProgressInterval = 200;  ///< ms between progress signals
+
 class GPGFRONTEND_CORE_EXPORT Task : public QObject, public QRunnable {
   Q_OBJECT
  public:
@@ -121,6 +123,63 @@ class GPGFRONTEND_CORE_EXPORT Task : public QObject, public QRunnable {
    */
   [[nodiscard]] auto GetRTN();
 
+  /**
+   * @brief report that the runnable has processed some of total bytes, may
+   * be called from any thread. SignalTaskProgress is emitted at most every
+   * kTaskProgressInterval ms, counted from the creation of the task, and
+   * once more when processed reaches total.
+   *
+   * @param processed
+   * @param total zero or less if unknown
+   */
+  void ReportProgress(qint64 processed, qint64 total);
+
+  /**
+   * @brief the task whose runnable is running on the calling thread
+   *
+   * @return Task* nullptr outside of a runnable
+   */
+  static auto Current() -> Task*;
+
+  /**
+   * @brief run function on the calling thread as a part of the runnable,
+   * Current() returns this task inside of it
+   *
+   * @param function
+   */
+  void RunOnBehalf(const std::function<void()>& function);
+
+  /**
+   * @brief ask the runnable to stop, may be called from any thread. The
+   * cancel hooks are called on the calling thread, the callback still runs
+   * once the runnable returned.
+   *
+   */
+  void Cancel();
+
+  /**
+   * @brief
+   *
+   * @return true if Cancel() was called
+   */
+  [[nodiscard]] auto IsCancelled() const -> bool;
+
+  /**
+   * @brief register a hook which aborts the work of the runnable, it is
+   * called at once if the task was already cancelled
+   *
+   * @param hook
+   * @return int id of the hook
+   */
+  auto AddCancelHook(std::function<void()> hook) -> int;
+
+  /**
+   * @brief unregister a hook, waits for it if Cancel() is running it
+   *
+   * @param id
+   */
+  void RemoveCancelHook(int id);
+
  public slots:
 
   /**
@@ -149,6 +208,15 @@ class GPGFRONTEND_CORE_EXPORT Task : public QObject, public QRunnable {
    */
   void SignalTaskEnd();
 
+  /**
+   * @brief throttled progress of the runnable
+   *
+   * @param processed bytes processed so far
+   * @param total zero or less if unknown
+   * @param speed bytes per second since the last signal
+   */
+  void SignalTaskProgress(qint64 processed, qint64 total, double speed);
+
  protected:
   /**
    * @brief
@@ -38,26 +38,29 @@ class GpgKey;  ///< forward declaration
 class GpgSubKey;
 class GpgSignature;
 class GpgTOFUInfo;
+class GpgKeySummaryTable;
 
 using GpgError = gpgme_error_t;  ///< gpgme error
 using GpgErrorCode = gpg_err_code_t;
 using GpgErrorDesc = std::pair<QString, QString>;
 
-using KeyId = QString;                                            ///<
-using SubkeyId = QString;                                         ///<
-using KeyIdArgsList = std::vector<KeyId>;                         ///<
-using KeyIdArgsListPtr = std::unique_ptr<KeyIdArgsList>;          ///<
-using UIDArgsList = std::vector<QString>;                         ///<
-using UIDArgsListPtr = std::unique_ptr<UIDArgsList>;              ///<
-using SignIdArgsList = std::vector<std::pair<QString, QString>>;  ///<
-using SignIdArgsListPtr = std::unique_ptr<SignIdArgsList>;        ///<
-using KeyFprArgsListPtr = std::unique_ptr<std::vector<QString>>;  ///<
-using KeyArgsList = std::vector<GpgKey>;                          ///<
-using KeyListPtr = std::shared_ptr<KeyArgsList>;                  ///<
-using GpgKeyLinkList = std::list<GpgKey>;                         ///<
-using KeyLinkListPtr = std::unique_ptr<GpgKeyLinkList>;           ///<
-using KeyPtr = std::unique_ptr<GpgKey>;                           ///<
-using KeyPtrArgsList = const std::initializer_list<KeyPtr>;       ///<
+using KeyId = QString;                                                 ///<
+using SubkeyId = QString;                                              ///<
+using KeyIdArgsList = std::vector<KeyId>;                              ///<
+using KeyIdArgsListPtr = std::unique_ptr<KeyIdArgsList>;               ///<
+using UIDArgsList = std::vector<QString>;                              ///<
+using UIDArgsListPtr = std::unique_ptr<UIDArgsList>;                   ///<
+using SignIdArgsList = std::vector<std::pair<QString, QString>>;       ///<
+using SignIdArgsListPtr = std::unique_ptr<SignIdArgsList>;             ///<
+using KeyFprArgsListPtr = std::unique_ptr<std::vector<QString>>;       ///<
+using KeyArgsList = std::vector<GpgKey>;                               ///<
+using KeyListPtr = std::shared_ptr<KeyArgsList>;                       ///<
+using GpgKeyLinkList = std::list<GpgKey>;                              ///<
+using KeyLinkListPtr = std::unique_ptr<GpgKeyLinkList>;                ///<
+using KeyListSnapshotPtr = std::shared_ptr<const GpgKeyLinkList>;      ///<
+using KeySummaryTablePtr = std::shared_ptr<const GpgKeySummaryTable>;  ///<
+using KeyPtr = std::unique_ptr<GpgKey>;                                ///<
+using KeyPtrArgsList = const std::initializer_list<KeyPtr>;            ///<
 
 using GpgSignMode = gpgme_sig_mode_t;
 
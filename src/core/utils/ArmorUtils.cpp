@@ -0,0 +1,294 @@
+/**
+ * Copyright (C) 2021 Saturneric <eric@bktus.com>
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric <eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+#include "ArmorUtils.h"
+
+#include <array>
+#include <cstring>
+
+namespace GpgFrontend {
+
+namespace {
+
+constexpr size_t kArmorLineLength = 64;  ///< characters per line, like gpg
+constexpr size_t kArmorLineBytes = kArmorLineLength / 4 * 3;
+constexpr uint32_t kCRC24Init = 0xB704CE;
+constexpr uint32_t kCRC24Poly = 0x1864CFB;
+
+constexpr char kBase64Chars[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+constexpr int8_t kBase64Invalid = -1;
+constexpr int8_t kBase64Space = -2;
+
+/**
+ * @brief lookup tables of the codec, the encoder turns 12 bits into two
+ * characters at once
+ *
+ */
+struct Base64Tables {
+  std::array<std::array<char, 2>, 4096> pairs;  ///<
+  std::array<int8_t, 256> values;               ///<
+  std::array<uint32_t, 256> crc24;              ///<
+};
+
+auto GetBase64Tables() -> const Base64Tables & {
+  static const auto kTables = []() {
+    Base64Tables tables{};
+    for (size_t i = 0; i < tables.pairs.size(); i++) {
+      tables.pairs[i] = {kBase64Chars[i >> 6], kBase64Chars[i & 0x3F]};
+    }
+
+    tables.values.fill(kBase64Invalid);
+    for (int8_t i = 0; i < 64; i++) {
+      tables.values[static_cast<uchar>(kBase64Chars[i])] = i;
+    }
+    for (const auto c : {' ', '\t', '\r', '\n'}) {
+      tables.values[static_cast<uchar>(c)] = kBase64Space;
+    }
+
+    for (uint32_t i = 0; i < tables.crc24.size(); i++) {
+      auto crc = i << 16;
+      for (int k = 0; k < 8; k++) {
+        crc <<= 1;
+        if ((crc & 0x1000000) != 0) crc ^= kCRC24Poly;
+      }
+      tables.crc24[i] = crc & 0xFFFFFF;
+    }
+    return tables;
+  }();
+  return kTables;
+}
+
+/**
+ * @brief encode whole groups of 3 bytes, returns the end of the output
+ */
+auto EncodeBase64Groups(const Base64Tables &tables, const uchar *in,
+                        size_t groups, char *out) -> char * {
+  for (size_t i = 0; i < groups; i++, in += 3, out += 4) {
+    const uint32_t v = in[0] << 16 | in[1] << 8 | in[2];
+    memcpy(out, tables.pairs[v >> 12].data(), 2);
+    memcpy(out + 2, tables.pairs[v & 0xFFF].data(), 2);
+  }
+  return out;
+}
+
+/**
+ * @brief encode the last 1 or 2 bytes with padding
+ */
+auto EncodeBase64Tail(const uchar *in, size_t size, char *out) -> char * {
+  uint32_t v = in[0] << 16;
+  if (size > 1) v |= in[1] << 8;
+  out[0] = kBase64Chars[(v >> 18) & 0x3F];
+  out[1] = kBase64Chars[(v >> 12) & 0x3F];
+  out[2] = size > 1 ? kBase64Chars[(v >> 6) & 0x3F] : '=';
+  out[3] = '=';
+  return out + 4;
+}
+
+/**
+ * @brief decoder state, carried over the lines of the armor
+ *
+ */
+struct Base64Decoder {
+  uint32_t acc = 0;  ///<
+  int count = 0;     ///< characters in acc
+  int padding = 0;   ///<
+
+  auto Feed(const Base64Tables &tables, const char *in, size_t size,
+            QByteArray &out) -> bool {
+    for (size_t i = 0; i < size; i++) {
+      if (in[i] == '=') {
+        padding++;
+        continue;
+      }
+
+      const auto v = tables.values[static_cast<uchar>(in[i])];
+      if (v == kBase64Space) continue;
+      if (v == kBase64Invalid || padding > 0) return false;
+
+      acc = acc << 6 | static_cast<uint32_t>(v);
+      if (++count == 4) {
+        const char bytes[3] = {static_cast<char>(acc >> 16),
+                               static_cast<char>(acc >> 8),
+                               static_cast<char>(acc)};
+        out.append(bytes, 3);
+        acc = 0;
+        count = 0;
+      }
+    }
+    return true;
+  }
+
+  auto Finish(QByteArray &out) -> bool {
+    if (count == 2) out.append(static_cast<char>(acc >> 4));
+    if (count == 3) {
+      out.append(static_cast<char>(acc >> 10));
+      out.append(static_cast<char>(acc >> 2));
+    }
+    return count != 1;
+  }
+};
+
+}  // namespace
+
+auto CRC24(const char *data, size_t size) -> uint32_t {
+  const auto &table = GetBase64Tables().crc24;
+  auto crc = kCRC24Init;
+  for (size_t i = 0; i < size; i++) {
+    const auto index = ((crc >> 16) ^ static_cast<uchar>(data[i])) & 0xFF;
+    crc = ((crc << 8) ^ table[index]) & 0xFFFFFF;
+  }
+  return crc;
+}
+
+auto ArmorBuffer(const GFBuffer &binary, const QString &type) -> GFBuffer {
+  const auto &tables = GetBase64Tables();
+  const auto *in = reinterpret_cast<const uchar *>(binary.Data());
+  const auto size = binary.Size();
+
+  const auto begin = QString("-----BEGIN PGP %1-----\n\n").arg(type).toLatin1();
+  const auto end = QString("-----END PGP %1-----\n").arg(type).toLatin1();
+  const auto body_size = (size + 2) / 3 * 4;
+  const auto lines = (body_size + kArmorLineLength - 1) / kArmorLineLength;
+
+  // the checksum line is "=XXXX\n"
+  GFBuffer out;
+  out.Resize(static_cast<ssize_t>(begin.size() + body_size + lines + 6 +
+                                  end.size()));
+  auto *p = out.MutableData();
+  memcpy(p, begin.constData(), begin.size());
+  p += begin.size();
+
+  for (size_t i = 0; i < size; i += kArmorLineBytes) {
+    const auto line_size = std::min(kArmorLineBytes, size - i);
+    p = EncodeBase64Groups(tables, in + i, line_size / 3, p);
+    if (line_size % 3 != 0) {
+      p = EncodeBase64Tail(in + i + line_size / 3 * 3, line_size % 3, p);
+    }
+    *p++ = '\n';
+  }
+
+  const auto crc = CRC24(binary.Data(), size);
+  const uchar crc_bytes[3] = {static_cast<uchar>(crc >> 16),
+                              static_cast<uchar>(crc >> 8),
+                              static_cast<uchar>(crc)};
+  *p++ = '=';
+  p = EncodeBase64Groups(tables, crc_bytes, 1, p);
+  *p++ = '\n';
+
+  memcpy(p, end.constData(), end.size());
+  return out;
+}
+
+auto DearmorBuffer(const GFBuffer &armored)
+    -> std::tuple<bool, QString, GFBuffer> {
+  const auto text = QByteArray::fromRawData(
+      armored.Data(), static_cast<qsizetype>(armored.Size()));
+
+  const QByteArray begin_tag = "-----BEGIN PGP ";
+  const auto begin = text.indexOf(begin_tag);
+  if (begin < 0) return {false, {}, {}};
+
+  const auto type_begin = begin + begin_tag.size();
+  const auto type_end = text.indexOf("-----", type_begin);
+  auto pos = text.indexOf('\n', type_begin);
+  if (type_end < 0 || pos < 0 || type_end > pos) return {false, {}, {}};
+  const auto type =
+      QString::fromLatin1(text.mid(type_begin, type_end - type_begin));
+
+  // the text of a clear signed message is not base64
+  if (type == "SIGNED MESSAGE") return {false, type, {}};
+
+  auto next_line = [&](qsizetype &from) -> QByteArray {
+    if (from < 0 || from >= text.size()) return {};
+    auto end = text.indexOf('\n', from);
+    if (end < 0) end = text.size();
+    auto line = QByteArray::fromRawData(text.constData() + from, end - from);
+    from = end + 1;
+    return line;
+  };
+
+  // armor headers end with an empty line
+  pos++;
+  for (;;) {
+    if (pos >= text.size()) return {false, type, {}};
+    const auto line = next_line(pos).trimmed();
+    if (line.isEmpty()) break;
+    if (!line.contains(':')) return {false, type, {}};
+  }
+
+  const auto &tables = GetBase64Tables();
+  const auto end_tag = QString("-----END PGP %1-----").arg(type).toLatin1();
+
+  QByteArray out;
+  out.reserve(static_cast<qsizetype>((text.size() - pos) / 4 * 3));
+  Base64Decoder decoder;
+  QByteArray checksum;
+
+  for (;;) {
+    if (pos >= text.size()) return {false, type, {}};
+    // body lines are decoded in place, the decoder skips white space
+    const auto line = next_line(pos);
+    if (line.startsWith("-----")) {
+      if (!line.startsWith(end_tag)) return {false, type, {}};
+      break;
+    }
+
+    // the checksum is the last line before the end, if any
+    if (line.startsWith('=')) {
+      checksum = line.trimmed().mid(1);
+      if (checksum.size() != 4) return {false, type, {}};
+      continue;
+    }
+    if (!checksum.isEmpty()) return {false, type, {}};
+    if (!decoder.Feed(tables, line.constData(), line.size(), out)) {
+      return {false, type, {}};
+    }
+  }
+  if (!decoder.Finish(out)) return {false, type, {}};
+
+  if (!checksum.isEmpty()) {
+    QByteArray crc_bytes;
+    Base64Decoder crc_decoder;
+    if (!crc_decoder.Feed(tables, checksum.constData(), checksum.size(),
+                          crc_bytes) ||
+        crc_bytes.size() != 3) {
+      return {false, type, {}};
+    }
+    const auto crc = static_cast<uchar>(crc_bytes[0]) << 16 |
+                     static_cast<uchar>(crc_bytes[1]) << 8 |
+                     static_cast<uchar>(crc_bytes[2]);
+    if (static_cast<uint32_t>(crc) != CRC24(out.constData(), out.size())) {
+      return {false, type, {}};
+    }
+  }
+
+  return {true, type, GFBuffer(std::move(out))};
+}
+
+}  // namespace GpgFrontend
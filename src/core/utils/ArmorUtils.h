@@ -0,0 +1,64 @@
+/**
+ * Copyright (C) 2021 Saturneric <eric@bktus.com>
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric <eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+#pragma once
+
+#include "core/model/GFBuffer.h"
+
+namespace GpgFrontend {
+
+/**
+ * @brief CRC-24 checksum of OpenPGP ASCII armor (RFC 4880, section 6.1)
+ *
+ * @param data
+ * @param size
+ * @return uint32_t
+ */
+auto GPGFRONTEND_CORE_EXPORT CRC24(const char *data, size_t size) -> uint32_t;
+
+/**
+ * @brief wrap binary OpenPGP data into ASCII armor, the same way gpg does:
+ * no headers, lines of 64 characters and a CRC-24 checksum
+ *
+ * @param binary
+ * @param type the block type, e.g. "MESSAGE" or "SIGNATURE"
+ * @return GFBuffer
+ */
+auto GPGFRONTEND_CORE_EXPORT ArmorBuffer(const GFBuffer &binary,
+                                         const QString &type) -> GFBuffer;
+
+/**
+ * @brief decode the first ASCII armored block of a buffer, the armor
+ * headers are skipped and the checksum is verified if present
+ *
+ * @param armored
+ * @return std::tuple<bool, QString, GFBuffer> success, block type and data
+ */
+auto GPGFRONTEND_CORE_EXPORT DearmorBuffer(const GFBuffer &armored)
+    -> std::tuple<bool, QString, GFBuffer>;
+
+}  // namespace GpgFrontend
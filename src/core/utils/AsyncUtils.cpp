@@ -28,6 +28,7 @@
 
 #include "AsyncUtils.h"
 
+#include "core/function/CoreSignalStation.h"
 #include "core/module/ModuleManager.h"
 #include "core/thread/Task.h"
 #include "core/thread/TaskRunnerGetter.h"
@@ -36,6 +37,28 @@
 
 namespace GpgFrontend {
 
+/**
+ * @brief run an operation unless the current task is cancelled already.
+ * Once cancelled, an operation fails in many ways (aborted gpgme operation,
+ * closed data exchanger...), all of them are reported as GPG_ERR_CANCELED.
+ *
+ * @param runnable
+ * @param data_object
+ */
+template <typename Runnable>
+auto RunCancellable(const Runnable& runnable,
+                    const DataObjectPtr& data_object) {
+  using Error = decltype(runnable(data_object));
+  const auto cancelled = static_cast<Error>(GPG_ERR_CANCELED);
+
+  auto* task = Thread::Task::Current();
+  if (task != nullptr && task->IsCancelled()) return cancelled;
+
+  auto err = runnable(data_object);
+  if (task != nullptr && task->IsCancelled()) return cancelled;
+  return err;
+}
+
 auto RunGpgOperaAsync(const GpgOperaRunnable& runnable,
                       const GpgOperationCallback& callback,
                       const QString& operation, const QString& minial_version)
@@ -59,7 +82,9 @@ auto RunGpgOperaAsync(const GpgOperaRunnable& runnable,
               operation,
               [=](const DataObjectPtr& data_object) -> int {
                 auto custom_data_object = TransferParams();
-                auto err = runnable(custom_data_object);
+                auto err = RunCancellable(runnable, custom_data_object);
+                emit CoreSignalStation::GetInstance()
+                    ->SignalGpgOperationFinished();
                 data_object->Swap({err, custom_data_object});
                 return 0;
               },
@@ -92,7 +117,8 @@ auto RunGpgOperaSync(const GpgOperaRunnable& runnable, const QString& operation,
   }
 
   auto data_object = TransferParams();
-  auto err = runnable(data_object);
+  auto err = RunCancellable(runnable, data_object);
+  emit CoreSignalStation::GetInstance()->SignalGpgOperationFinished();
   return {err, data_object};
 }
 
@@ -106,7 +132,7 @@ auto RunIOOperaAsync(const OperaRunnable& runnable,
               operation,
               [=](const DataObjectPtr& data_object) -> int {
                 auto custom_data_object = TransferParams();
-                GpgError err = runnable(custom_data_object);
+                GpgError err = RunCancellable(runnable, custom_data_object);
 
                 data_object->Swap({err, custom_data_object});
                 return 0;
@@ -134,7 +160,7 @@ auto RunOperaAsync(const OperaRunnable& runnable,
               operation,
               [=](const DataObjectPtr& data_object) -> int {
                 auto custom_data_object = TransferParams();
-                GpgError err = runnable(custom_data_object);
+                GpgError err = RunCancellable(runnable, custom_data_object);
 
                 data_object->Swap({err, custom_data_object});
                 return 0;
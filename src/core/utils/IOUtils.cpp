@@ -28,22 +28,161 @@
 
 #include "IOUtils.h"
 
+#include <openssl/evp.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+
 #include "core/GpgModel.h"
+#include "core/thread/Task.h"
 #include "core/utils/FilesystemUtils.h"
 
 namespace GpgFrontend {
 
-auto GetFileChecksum(const QString& file_name,
-                     QCryptographicHash::Algorithm hashAlgorithm)
-    -> QByteArray {
-  QFile f(file_name);
-  if (f.open(QFile::ReadOnly)) {
-    QCryptographicHash hash(hashAlgorithm);
-    if (hash.addData(&f)) {
-      return hash.result();
+constexpr qint64 kHashBlockSize = 1024 * 1024;
+constexpr size_t kHashBlockSlots = 4;
+constexpr qint64 kHashParallelThreshold = 8 * 1024 * 1024;
+
+using EVPMDCtxPtr = std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)>;
+
+auto HashCancelled() -> bool {
+  auto* task = Thread::Task::Current();
+  return task != nullptr && task->IsCancelled();
+}
+
+auto UpdateDigests(QFile& file, std::vector<EVPMDCtxPtr>& ctxs,
+                   const GFHashReadCb& on_read) -> bool {
+  QByteArray block(kHashBlockSize, Qt::Uninitialized);
+  for (;;) {
+    if (HashCancelled()) return false;
+
+    const auto size = file.read(block.data(), block.size());
+    if (size <= 0) return size == 0;
+
+    for (auto& ctx : ctxs) EVP_DigestUpdate(ctx.get(), block.constData(), size);
+    if (on_read) on_read(size);
+  }
+}
+
+auto UpdateDigestsParallel(QFile& file, std::vector<EVPMDCtxPtr>& ctxs,
+                           const GFHashReadCb& on_read) -> bool {
+  struct Block {
+    QByteArray data = QByteArray(kHashBlockSize, Qt::Uninitialized);
+    qint64 size = 0;
+  };
+  std::array<Block, kHashBlockSlots> slots;
+
+  // block k goes to slot k % kHashBlockSlots, the reader overwrites a slot
+  // once every digest has consumed the block in it
+  std::mutex lock;
+  std::condition_variable cv;
+  size_t produced = 0;
+  bool done = false;
+  std::vector<size_t> consumed(ctxs.size(), 0);
+
+  auto digest = [&](size_t i) {
+    for (size_t k = 0;; k++) {
+      {
+        std::unique_lock<std::mutex> l(lock);
+        cv.wait(l, [&]() { return produced > k || done; });
+        if (produced <= k) return;
+      }
+
+      const auto& block = slots[k % kHashBlockSlots];
+      EVP_DigestUpdate(ctxs[i].get(), block.data.constData(), block.size);
+
+      {
+        std::lock_guard<std::mutex> l(lock);
+        consumed[i] = k + 1;
+      }
+      cv.notify_all();
+    }
+  };
+
+  std::vector<std::unique_ptr<QThread>> threads;
+  for (size_t i = 0; i < ctxs.size(); i++) {
+    threads.emplace_back(QThread::create(digest, i));
+    threads.back()->start();
+  }
+
+  auto ret = true;
+  for (size_t k = 0;; k++) {
+    {
+      std::unique_lock<std::mutex> l(lock);
+      cv.wait(l, [&]() {
+        return k < kHashBlockSlots ||
+               *std::min_element(consumed.begin(), consumed.end()) >
+                   k - kHashBlockSlots;
+      });
+    }
+
+    if (HashCancelled()) {
+      ret = false;
+      break;
+    }
+
+    auto& block = slots[k % kHashBlockSlots];
+    block.size = file.read(block.data.data(), block.data.size());
+    if (block.size <= 0) {
+      ret = block.size == 0;
+      break;
+    }
+
+    {
+      std::lock_guard<std::mutex> l(lock);
+      produced = k + 1;
+    }
+    cv.notify_all();
+    if (on_read) on_read(block.size);
+  }
+
+  {
+    std::lock_guard<std::mutex> l(lock);
+    done = true;
+  }
+  cv.notify_all();
+  for (auto& thread : threads) thread->wait();
+  return ret;
+}
+
+auto CalculateFileDigests(const QString& file_path, const QStringList& algos,
+                          bool parallel, const GFHashReadCb& on_read)
+    -> std::tuple<bool, QList<QByteArray>> {
+  QFile file(file_path);
+  if (!file.open(QIODevice::ReadOnly)) {
+    GF_CORE_LOG_ERROR("failed to open file: {}", file_path);
+    return {false, {}};
+  }
+
+  std::vector<EVPMDCtxPtr> ctxs;
+  for (const auto& algo : algos) {
+    const auto* md = EVP_get_digestbyname(algo.toLatin1().constData());
+    auto ctx = EVPMDCtxPtr(EVP_MD_CTX_new(), &EVP_MD_CTX_free);
+    if (md == nullptr || ctx == nullptr ||
+        EVP_DigestInit_ex(ctx.get(), md, nullptr) != 1) {
+      GF_CORE_LOG_ERROR("unsupported digest algorithm: {}", algo);
+      return {false, {}};
     }
+    ctxs.push_back(std::move(ctx));
+  }
+
+  const auto ret =
+      parallel && ctxs.size() > 1 && file.size() >= kHashParallelThreshold
+          ? UpdateDigestsParallel(file, ctxs, on_read)
+          : UpdateDigests(file, ctxs, on_read);
+  if (!ret) return {false, {}};
+
+  QList<QByteArray> digests;
+  for (auto& ctx : ctxs) {
+    QByteArray digest(EVP_MAX_MD_SIZE, Qt::Uninitialized);
+    unsigned int size = 0;
+    EVP_DigestFinal_ex(ctx.get(), reinterpret_cast<uint8_t*>(digest.data()),
+                       &size);
+    digest.resize(static_cast<int>(size));
+    digests.append(digest);
   }
-  return {};
+  return {true, digests};
 }
 
 auto ReadFile(const QString& file_name, QByteArray& data) -> bool {
@@ -68,64 +207,173 @@ auto WriteFile(const QString& file_name, const QByteArray& data) -> bool {
   return true;
 }
 
+namespace {
+
+/**
+ * @brief write the bytes as they are, without copying them into a QByteArray
+ *
+ * @param file_name
+ * @param data
+ * @return true
+ * @return false
+ */
+auto WriteFileRaw(const QString& file_name, const GFBuffer& data) -> bool {
+  QFile file(file_name);
+  if (!file.open(QIODevice::WriteOnly)) {
+    GF_CORE_LOG_ERROR("failed to open file for writing: {}", file_name);
+    return false;
+  }
+  const auto written =
+      file.write(data.Data(), static_cast<qint64>(data.Size()));
+  file.close();
+  return written == static_cast<qint64>(data.Size());
+}
+
+}  // namespace
+
 auto ReadFileGFBuffer(const QString& file_name) -> std::tuple<bool, GFBuffer> {
-  QByteArray byte_data;
-  const bool res = ReadFile(file_name, byte_data);
+  QFile file(file_name);
+  if (!file.open(QIODevice::ReadOnly)) {
+    GF_CORE_LOG_ERROR("failed to open file: {}", file_name);
+    return {false, {}};
+  }
+
+  // straight into the pooled storage, no QByteArray in between
+  GFBuffer buffer;
+  buffer.Resize(static_cast<ssize_t>(file.size()));
+  const auto read =
+      file.read(buffer.MutableData(), static_cast<qint64>(buffer.Size()));
+  file.close();
+  if (read < 0) return {false, {}};
 
-  return {res, GFBuffer(byte_data)};
+  buffer.Resize(static_cast<ssize_t>(read));
+  return {true, buffer};
 }
 
 auto WriteFileGFBuffer(const QString& file_name, GFBuffer data) -> bool {
-  return WriteFile(file_name, data.ConvertToQByteArray());
+  return WriteFileRaw(file_name, data);
+}
+
+const QStringList kHashAlgos = {"MD5", "SHA1", "SHA256"};
+
+void WriteFileHashInfo(QTextStream& ss, const QString& name,
+                       const QFileInfo& info,
+                       const QList<QByteArray>& digests) {
+  ss << "# " << QCoreApplication::tr("File Hash Information") << Qt::endl;
+  ss << "- " << QCoreApplication::tr("Filename") << QCoreApplication::tr(": ")
+     << name << Qt::endl;
+
+  // read all data
+  ss << "- " << QCoreApplication::tr("File Size") << "(bytes)"
+     << QCoreApplication::tr(": ") << QString::number(info.size())
+     << Qt::endl;
+
+  ss << "- " << QCoreApplication::tr("File Size") << QCoreApplication::tr(": ")
+     << GetHumanFriendlyFileSize(info.size()) << Qt::endl;
+
+  for (int i = 0; i < kHashAlgos.size() && i < digests.size(); i++) {
+    ss << "- " << kHashAlgos[i] << QCoreApplication::tr(": ")
+       << digests[i].toHex() << Qt::endl;
+  }
+
+  ss << Qt::endl;
+}
+
+void WriteHashError(QTextStream& ss, const QString& name) {
+  ss << "# " << QCoreApplication::tr("Error: cannot read target file")
+     << Qt::endl;
+  ss << "- " << QCoreApplication::tr("Filename") << QCoreApplication::tr(": ")
+     << name << Qt::endl;
+}
+
+auto CalculateDirectoryHash(const QString& dir_path) -> QString {
+  QStringList files;
+  QDirIterator it(dir_path, QDir::Files | QDir::Hidden | QDir::NoSymLinks,
+                  QDirIterator::Subdirectories);
+  while (it.hasNext()) files.append(it.next());
+  files.sort();
+
+  auto* task = Thread::Task::Current();
+  const auto total = task != nullptr ? GetDirectorySize(dir_path) : 0;
+  std::atomic<qint64> processed = 0;
+  auto on_read = [&](qint64 size) {
+    auto done = processed += size;
+    if (task != nullptr) task->ReportProgress(done, total);
+  };
+
+  // files are hashed in parallel, the digests of one file sequentially
+  std::vector<std::tuple<bool, QList<QByteArray>>> results(files.size());
+  std::atomic_size_t next = 0;
+  auto worker = [&]() {
+    for (auto i = next++; i < results.size(); i = next++) {
+      results[i] = CalculateFileDigests(files[i], kHashAlgos, false, on_read);
+    }
+  };
+
+  const auto workers = std::min(QThread::idealThreadCount(),
+                                static_cast<int>(files.size()));
+  std::vector<std::unique_ptr<QThread>> threads;
+  for (int i = 1; i < workers; i++) {
+    threads.emplace_back(QThread::create([&]() {
+      if (task != nullptr) {
+        task->RunOnBehalf(worker);
+      } else {
+        worker();
+      }
+    }));
+    threads.back()->start();
+  }
+  worker();
+  for (auto& thread : threads) thread->wait();
+
+  QString buffer;
+  QTextStream ss(&buffer);
+  const auto base_dir = QDir(dir_path);
+
+  ss << "# " << QCoreApplication::tr("Directory Hash Information") << Qt::endl;
+  ss << "- " << QCoreApplication::tr("Directory") << QCoreApplication::tr(": ")
+     << QFileInfo(dir_path).fileName() << Qt::endl;
+  ss << "- " << QCoreApplication::tr("Files") << QCoreApplication::tr(": ")
+     << QString::number(files.size()) << Qt::endl;
+  ss << Qt::endl;
+
+  for (size_t i = 0; i < results.size(); i++) {
+    const auto& [ret, digests] = results[i];
+    const auto name = base_dir.relativeFilePath(files[i]);
+    if (ret) {
+      WriteFileHashInfo(ss, name, QFileInfo(files[i]), digests);
+    } else {
+      WriteHashError(ss, name);
+    }
+  }
+
+  return ss.readAll();
 }
 
 auto CalculateHash(const QString& file_path) -> QString {
   // Returns empty QByteArray() on failure.
   QFileInfo const info(file_path);
+  if (info.isDir()) return CalculateDirectoryHash(file_path);
+
   QString buffer;
   QTextStream ss(&buffer);
 
   if (info.isFile() && info.isReadable()) {
-    ss << "# " << QCoreApplication::tr("File Hash Information") << Qt::endl;
-    ss << "- " << QCoreApplication::tr("Filename") << QCoreApplication::tr(": ")
-       << info.fileName() << Qt::endl;
-
-    // read all data
-    ss << "- " << QCoreApplication::tr("File Size") << "(bytes)"
-       << QCoreApplication::tr(": ") << QString::number(info.size())
-       << Qt::endl;
-
-    ss << "- " << QCoreApplication::tr("File Size")
-       << QCoreApplication::tr(": ") << GetHumanFriendlyFileSize(info.size())
-       << Qt::endl;
-
-    // md5
-    ss << "- "
-       << "MD5" << QCoreApplication::tr(": ")
-       << GetFileChecksum(file_path, QCryptographicHash::Md5).toHex()
-       << Qt::endl;
-
-    // sha1
-    ss << "- "
-       << "SHA1" << QCoreApplication::tr(": ")
-       << GetFileChecksum(file_path, QCryptographicHash::Sha1).toHex()
-       << Qt::endl;
-
-    // sha1
-    ss << "- "
-       << "SHA256" << QCoreApplication::tr(": ")
-       << GetFileChecksum(file_path, QCryptographicHash::Sha256).toHex()
-       << Qt::endl;
-
-    ss << Qt::endl;
+    auto* task = Thread::Task::Current();
+    qint64 processed = 0;
+    auto [ret, digests] = CalculateFileDigests(
+        file_path, kHashAlgos, true, [&](qint64 size) {
+          processed += size;
+          if (task != nullptr) task->ReportProgress(processed, info.size());
+        });
 
-  } else {
-    ss << "# " << QCoreApplication::tr("Error: cannot read target file")
-       << Qt::endl;
-    ss << "- " << QCoreApplication::tr("Filename") << QCoreApplication::tr(": ")
-       << info.fileName() << Qt::endl;
+    if (ret) {
+      WriteFileHashInfo(ss, info.fileName(), info, digests);
+      return ss.readAll();
+    }
   }
 
+  WriteHashError(ss, info.fileName());
   return ss.readAll();
 }
 
@@ -143,7 +391,7 @@ auto CreateTempFileAndWriteData(const QString& data) -> QString {
 
 auto CreateTempFileAndWriteData(const GFBuffer& data) -> QString {
   auto temp_file = GetTempFilePath();
-  WriteFile(temp_file, data.ConvertToQByteArray());
+  WriteFileRaw(temp_file, data);
   return temp_file;
 }
 
@@ -180,4 +428,15 @@ auto GetFullExtension(const QString& path) -> QString {
   return filename.mid(dot_index);
 }
 
+auto GetDirectorySize(const QString& path) -> qint64 {
+  qint64 size = 0;
+  QDirIterator it(path, QDir::Files | QDir::Hidden | QDir::NoSymLinks,
+                  QDirIterator::Subdirectories);
+  while (it.hasNext()) {
+    it.next();
+    size += it.fileInfo().size();
+  }
+  return size;
+}
+
 }  // namespace GpgFrontend
\ No newline at end of file
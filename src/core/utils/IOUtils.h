@@ -75,12 +75,29 @@ auto GPGFRONTEND_CORE_EXPORT WriteFile(const QString &file_name,
                                        const QByteArray &data) -> bool;
 
 /**
- * calculate the hash of a file
+ * calculate the hash of a file, or of every file below a directory
  * @param file_path
  * @return
  */
 auto GPGFRONTEND_CORE_EXPORT CalculateHash(const QString &file_path) -> QString;
 
+using GFHashReadCb = std::function<void(qint64)>;
+
+/**
+ * @brief compute several digests of a file while reading it only once. For
+ * large files every digest is updated on its own thread.
+ *
+ * @param file_path
+ * @param algos OpenSSL digest names, e.g. "MD5", "SHA1", "SHA256"
+ * @param parallel allow to update the digests in parallel
+ * @param on_read receives the number of bytes of each block read
+ * @return std::tuple<bool, QList<QByteArray>> the digests in order of algos
+ */
+auto GPGFRONTEND_CORE_EXPORT CalculateFileDigests(
+    const QString &file_path, const QStringList &algos, bool parallel = true,
+    const GFHashReadCb &on_read = nullptr)
+    -> std::tuple<bool, QList<QByteArray>>;
+
 /**
  * @brief
  *
@@ -136,4 +153,12 @@ auto GPGFRONTEND_CORE_EXPORT TargetFilePreCheck(const QString &path, bool read)
  */
 auto GPGFRONTEND_CORE_EXPORT GetFullExtension(QString path) -> QString;
 
+/**
+ * @brief total size of the regular files below a directory
+ *
+ * @param path
+ * @return qint64
+ */
+auto GPGFRONTEND_CORE_EXPORT GetDirectorySize(const QString &path) -> qint64;
+
 }  // namespace GpgFrontend
@@ -28,6 +28,7 @@
 
 #include "GpgCoreTest.h"
 
+#include "core/function/GlobalSettingStation.h"
 #include "core/function/gpg/GpgKeyImportExporter.h"
 #include "core/utils/IOUtils.h"
 #include "core/utils/MemoryUtils.h"
@@ -37,4 +38,29 @@ namespace GpgFrontend::Test {
 void GpgCoreTest::TearDown() {}
 
 void GpgCoreTest::SetUp() {}
+
+ScopedSettings::ScopedSettings(
+    std::initializer_list<std::pair<QString, QVariant>> values) {
+  for (const auto& value : values) Set(value.first, value.second);
+}
+
+ScopedSettings::~ScopedSettings() {
+  auto settings = GlobalSettingStation::GetInstance().GetSettings();
+  for (auto it = saved_.cbegin(); it != saved_.cend(); ++it) {
+    if (it.value().isValid()) {
+      settings.setValue(it.key(), it.value());
+    } else {
+      settings.remove(it.key());
+    }
+  }
+  settings.sync();
+}
+
+void ScopedSettings::Set(const QString& key, const QVariant& value) {
+  auto settings = GlobalSettingStation::GetInstance().GetSettings();
+  if (!saved_.contains(key)) saved_[key] = settings.value(key);
+  settings.setValue(key, value);
+  settings.sync();
+}
+
 }  // namespace GpgFrontend::Test
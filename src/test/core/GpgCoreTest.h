@@ -41,4 +41,33 @@ class GpgCoreTest : public ::testing::Test {
   void TearDown() override;
 };
 
+/**
+ * @brief changes global settings for a test and restores them when it
+ * leaves the scope, also on a failed assertion
+ *
+ */
+class ScopedSettings {
+ public:
+  ScopedSettings() = default;
+
+  ScopedSettings(std::initializer_list<std::pair<QString, QVariant>> values);
+
+  ~ScopedSettings();
+
+  ScopedSettings(const ScopedSettings&) = delete;
+
+  auto operator=(const ScopedSettings&) -> ScopedSettings& = delete;
+
+  /**
+   * @brief
+   *
+   * @param key
+   * @param value
+   */
+  void Set(const QString& key, const QVariant& value);
+
+ private:
+  QMap<QString, QVariant> saved_;  ///< invalid if the key was not set
+};
+
 }  // namespace GpgFrontend::Test
\ No newline at end of file
@@ -26,15 +26,21 @@
  *
  */
 
+#include <set>
+#include <thread>
+
 #include "GpgCoreTest.h"
 #include "core/GpgModel.h"
 #include "core/function/gpg/GpgBasicOperator.h"
+#include "core/function/gpg/GpgContext.h"
 #include "core/function/gpg/GpgKeyGetter.h"
 #include "core/function/result_analyse/GpgDecryptResultAnalyse.h"
 #include "core/model/GpgDecryptResult.h"
 #include "core/model/GpgEncryptResult.h"
 #include "core/model/GpgSignResult.h"
 #include "core/model/GpgVerifyResult.h"
+#include "core/thread/Task.h"
+#include "core/utils/ArmorUtils.h"
 #include "core/utils/GpgUtils.h"
 
 namespace GpgFrontend::Test {
@@ -69,6 +75,138 @@ TEST_F(GpgCoreTest, CoreEncryptDecrTest) {
   ASSERT_EQ(decr_out_buffer, buffer);
 }
 
+TEST_F(GpgCoreTest, CoreEncryptSessionTest) {
+  auto key_ids = std::make_unique<KeyIdArgsList>(
+      KeyIdArgsList{"E87C6A2D8D95C818DE93B3AE6A2764F8298DEB29"});
+  auto [err, session] =
+      GpgBasicOperator::GetInstance().OpenEncryptSession(key_ids, true);
+  ASSERT_EQ(CheckGpgError(err), GPG_ERR_NO_ERROR);
+  ASSERT_NE(session, nullptr);
+  ASSERT_EQ(session->Recipients().size(), 1);
+
+  // per message latency of the session against one-shot encryption
+  constexpr int kMessages = 200;
+  const auto keys = session->Recipients();
+  QList<GFBuffer> outputs;
+
+  QElapsedTimer timer;
+  timer.start();
+  for (int i = 0; i < kMessages; i++) {
+    auto [err_0, out] =
+        session->Encrypt(GFBuffer(QString("Hello GpgFrontend! %1").arg(i)));
+    ASSERT_EQ(CheckGpgError(err_0), GPG_ERR_NO_ERROR);
+    outputs.append(out);
+  }
+  const auto session_ns = timer.nsecsElapsed() / kMessages;
+
+  timer.restart();
+  for (int i = 0; i < kMessages; i++) {
+    auto [err_0, data_object] = GpgBasicOperator::GetInstance().EncryptSync(
+        keys, GFBuffer(QString("Hello GpgFrontend! %1").arg(i)), true);
+    ASSERT_EQ(CheckGpgError(err_0), GPG_ERR_NO_ERROR);
+  }
+  const auto oneshot_ns = timer.nsecsElapsed() / kMessages;
+  GF_TEST_LOG_INFO("encrypt latency per message, session: {} us, sync: {} us",
+                   session_ns / 1000, oneshot_ns / 1000);
+
+  session.reset();
+  for (int i = 0; i < kMessages; i += 50) {
+    auto [err_0, data_object] =
+        GpgBasicOperator::GetInstance().DecryptSync(outputs[i]);
+    ASSERT_EQ(CheckGpgError(err_0), GPG_ERR_NO_ERROR);
+    ASSERT_EQ(ExtractParams<GFBuffer>(data_object, 1),
+              GFBuffer(QString("Hello GpgFrontend! %1").arg(i)));
+  }
+}
+
+TEST_F(GpgCoreTest, CoreEncryptSessionOutlivesTaskTest) {
+  auto key_ids = std::make_unique<KeyIdArgsList>(
+      KeyIdArgsList{"E87C6A2D8D95C818DE93B3AE6A2764F8298DEB29"});
+
+  // more sessions than pooled contexts, opened by a task which is gone
+  // before they are used
+  std::vector<GpgEncryptSessionPtr> sessions;
+  auto task = std::make_unique<Thread::Task>("session_test");
+  task->RunOnBehalf([&]() {
+    for (int i = 0; i <= GpgContext::GetInstance().ContextPoolSize(); i++) {
+      auto [err, session] =
+          GpgBasicOperator::GetInstance().OpenEncryptSession(key_ids, true);
+      ASSERT_EQ(CheckGpgError(err), GPG_ERR_NO_ERROR);
+      sessions.push_back(std::move(session));
+    }
+  });
+  task->Cancel();
+  task.reset();
+  ASSERT_EQ(static_cast<int>(sessions.size()),
+            GpgContext::GetInstance().ContextPoolSize() + 1);
+
+  // pooled operations still get a context
+  auto [err_0, data_object] = GpgBasicOperator::GetInstance().EncryptSync(
+      sessions.front()->Recipients(), GFBuffer(QString("pooled")), true);
+  ASSERT_EQ(CheckGpgError(err_0), GPG_ERR_NO_ERROR);
+
+  for (auto& session : sessions) {
+    auto [err, out] = session->Encrypt(GFBuffer(QString("Hello GpgFrontend!")));
+    ASSERT_EQ(CheckGpgError(err), GPG_ERR_NO_ERROR);
+
+    auto [err_1, data_object_1] =
+        GpgBasicOperator::GetInstance().DecryptSync(out);
+    ASSERT_EQ(CheckGpgError(err_1), GPG_ERR_NO_ERROR);
+    ASSERT_EQ(ExtractParams<GFBuffer>(data_object_1, 1),
+              GFBuffer(QString("Hello GpgFrontend!")));
+  }
+  sessions.clear();
+}
+
+TEST_F(GpgCoreTest, CoreEncryptSessionBadKeyTest) {
+  auto key_ids = std::make_unique<KeyIdArgsList>(
+      KeyIdArgsList{"E87C6A2D8D95C818DE93B3AE6A2764F8298DEB29",
+                    "0000000000000000000000000000000000000000"});
+  auto [err, session] =
+      GpgBasicOperator::GetInstance().OpenEncryptSession(key_ids, false);
+  ASSERT_EQ(CheckGpgError2ErrCode(err), GPG_ERR_UNUSABLE_PUBKEY);
+  ASSERT_EQ(session, nullptr);
+}
+
+TEST_F(GpgCoreTest, CoreDecryptSinkTest) {
+  auto encrypt_key = GpgKeyGetter::GetInstance().GetPubkey(
+      "E87C6A2D8D95C818DE93B3AE6A2764F8298DEB29");
+  auto buffer = GFBuffer(QByteArray("Hello GpgFrontend!").repeated(64 * 1024));
+
+  auto [err, data_object] =
+      GpgBasicOperator::GetInstance().EncryptSync({encrypt_key}, buffer, true);
+  ASSERT_EQ(CheckGpgError(err), GPG_ERR_NO_ERROR);
+  auto encr_out_buffer = ExtractParams<GFBuffer>(data_object, 1);
+
+  // the plaintext arrives in bounded pieces
+  QByteArray plain_text;
+  size_t max_piece = 0;
+  auto [err_0, data_object_0] = GpgBasicOperator::GetInstance().DecryptSync(
+      encr_out_buffer, [&](const char* data, size_t size) {
+        max_piece = std::max(max_piece, size);
+        plain_text.append(data, static_cast<qsizetype>(size));
+        return true;
+      });
+  ASSERT_EQ(CheckGpgError(err_0), GPG_ERR_NO_ERROR);
+  ASSERT_TRUE((data_object_0->Check<GpgDecryptResult>()));
+  ASSERT_EQ(GFBuffer(plain_text), buffer);
+  ASSERT_LE(max_piece, 64 * 1024);
+
+  QBuffer device;
+  ASSERT_TRUE(device.open(QIODevice::WriteOnly));
+  auto [err_1, data_object_1] =
+      GpgBasicOperator::GetInstance().DecryptVerifySync(
+          encr_out_buffer, MakeGpgDataSink(&device));
+  ASSERT_EQ(CheckGpgError(err_1), GPG_ERR_NO_ERROR);
+  ASSERT_TRUE((data_object_1->Check<GpgDecryptResult, GpgVerifyResult>()));
+  ASSERT_EQ(GFBuffer(device.data()), buffer);
+
+  // a failing sink fails the operation
+  auto [err_2, data_object_2] = GpgBasicOperator::GetInstance().DecryptSync(
+      encr_out_buffer, [](const char*, size_t) { return false; });
+  ASSERT_NE(CheckGpgError(err_2), GPG_ERR_NO_ERROR);
+}
+
 TEST_F(GpgCoreTest, CoreEncryptSymmetricDecrTest) {
   auto encrypt_text = GFBuffer(QString("Hello GpgFrontend!"));
   auto [err, data_object] =
@@ -199,6 +337,113 @@ TEST_F(GpgCoreTest, CoreSignVerifyDetachTest) {
             "467F14220CE8DCF780CF4BAD8465C55B25C9B7D1");
 }
 
+TEST_F(GpgCoreTest, CoreArmorCodecTest) {
+  ASSERT_EQ(CRC24(nullptr, 0), 0xB704CEU);
+
+  QByteArray data;
+  for (int i = 0; i < 200; i++) {
+    auto armored = ArmorBuffer(GFBuffer(data), "MESSAGE");
+    ASSERT_TRUE(armored.ConvertToQByteArray().startsWith(
+        "-----BEGIN PGP MESSAGE-----\n\n"));
+
+    auto [succ, type, decoded] = DearmorBuffer(armored);
+    ASSERT_TRUE(succ);
+    ASSERT_EQ(type, "MESSAGE");
+    ASSERT_EQ(decoded, GFBuffer(data));
+    data.append(static_cast<char>(i * 37));
+  }
+
+  // a corrupted body fails the checksum
+  auto armored = ArmorBuffer(GFBuffer(data), "MESSAGE").ConvertToQByteArray();
+  armored[40] = armored[40] == 'A' ? 'B' : 'A';
+  ASSERT_FALSE(std::get<0>(DearmorBuffer(GFBuffer(armored))));
+}
+
+TEST_F(GpgCoreTest, CoreInProcessArmorTest) {
+  auto encrypt_key = GpgKeyGetter::GetInstance().GetPubkey(
+      "E87C6A2D8D95C818DE93B3AE6A2764F8298DEB29");
+  auto sign_key = GpgKeyGetter::GetInstance().GetPubkey(
+      "467F14220CE8DCF780CF4BAD8465C55B25C9B7D1");
+  auto buffer = GFBuffer(QByteArray("Hello GpgFrontend!").repeated(4096));
+
+  // the armor of gpg decodes and encodes again to something gpg reads
+  auto [err, data_object] =
+      GpgBasicOperator::GetInstance().EncryptSync({encrypt_key}, buffer, true);
+  ASSERT_EQ(CheckGpgError(err), GPG_ERR_NO_ERROR);
+  auto gpg_out_buffer = ExtractParams<GFBuffer>(data_object, 1);
+  auto [succ, type, binary] = DearmorBuffer(gpg_out_buffer);
+  ASSERT_TRUE(succ);
+  ASSERT_EQ(type, "MESSAGE");
+
+  auto [err_0, data_object_0] = GpgBasicOperator::GetInstance().DecryptSync(
+      ArmorBuffer(binary, "MESSAGE"));
+  ASSERT_EQ(CheckGpgError(err_0), GPG_ERR_NO_ERROR);
+  ASSERT_EQ(ExtractParams<GFBuffer>(data_object_0, 1), buffer);
+
+  // outputs armored in process are read by gpg
+  ScopedSettings settings{{"gnupg/inprocess_armor", true}};
+  auto [err_1, data_object_1] =
+      GpgBasicOperator::GetInstance().EncryptSync({encrypt_key}, buffer, true);
+  auto [err_2, data_object_2] = GpgBasicOperator::GetInstance().SignSync(
+      {sign_key}, buffer, GPGME_SIG_MODE_DETACH, true);
+
+  ASSERT_EQ(CheckGpgError(err_1), GPG_ERR_NO_ERROR);
+  auto encr_out_buffer = ExtractParams<GFBuffer>(data_object_1, 1);
+  ASSERT_TRUE(encr_out_buffer.ConvertToQByteArray().startsWith(
+      "-----BEGIN PGP MESSAGE-----"));
+
+  ASSERT_EQ(CheckGpgError(err_2), GPG_ERR_NO_ERROR);
+  auto sign_out_buffer = ExtractParams<GFBuffer>(data_object_2, 1);
+  ASSERT_TRUE(sign_out_buffer.ConvertToQByteArray().startsWith(
+      "-----BEGIN PGP SIGNATURE-----"));
+
+  auto [err_3, data_object_3] =
+      GpgBasicOperator::GetInstance().VerifySync(buffer, sign_out_buffer);
+  ASSERT_EQ(CheckGpgError(err_3), GPG_ERR_NO_ERROR);
+  auto verify_result = ExtractParams<GpgVerifyResult>(data_object_3, 0);
+  ASSERT_FALSE(verify_result.GetSignature().empty());
+
+  // and decoded in process again, as is the armor of gpg
+  for (const auto& armored : {encr_out_buffer, gpg_out_buffer}) {
+    auto [err_4, data_object_4] =
+        GpgBasicOperator::GetInstance().DecryptSync(armored);
+    ASSERT_EQ(CheckGpgError(err_4), GPG_ERR_NO_ERROR);
+    ASSERT_EQ(ExtractParams<GFBuffer>(data_object_4, 1), buffer);
+  }
+
+  // text around the message is left to gpg, it is not dropped here
+  auto surrounded = GFBuffer(QByteArray("Hello\n\n") +
+                             encr_out_buffer.ConvertToQByteArray() +
+                             QByteArray("\nGpgFrontend\n"));
+  auto [err_5, data_object_5] =
+      GpgBasicOperator::GetInstance().DecryptSync(surrounded);
+  ASSERT_EQ(CheckGpgError(err_5), GPG_ERR_NO_ERROR);
+  ASSERT_EQ(ExtractParams<GFBuffer>(data_object_5, 1), buffer);
+}
+
+TEST_F(GpgCoreTest, CoreInProcessArmorSessionTest) {
+  ScopedSettings settings{{"gnupg/inprocess_armor", true}};
+
+  auto key_ids = std::make_unique<KeyIdArgsList>(
+      KeyIdArgsList{"E87C6A2D8D95C818DE93B3AE6A2764F8298DEB29"});
+  auto [err, session] =
+      GpgBasicOperator::GetInstance().OpenEncryptSession(key_ids, true);
+  ASSERT_EQ(CheckGpgError(err), GPG_ERR_NO_ERROR);
+
+  for (int i = 0; i < 4; i++) {
+    auto buffer = GFBuffer(QByteArray("Hello GpgFrontend!").repeated(i * 97));
+    auto [err_0, out] = session->Encrypt(buffer);
+    ASSERT_EQ(CheckGpgError(err_0), GPG_ERR_NO_ERROR);
+    ASSERT_TRUE(
+        out.ConvertToQByteArray().startsWith("-----BEGIN PGP MESSAGE-----"));
+
+    auto [err_1, data_object] =
+        GpgBasicOperator::GetInstance().DecryptSync(out);
+    ASSERT_EQ(CheckGpgError(err_1), GPG_ERR_NO_ERROR);
+    ASSERT_EQ(ExtractParams<GFBuffer>(data_object, 1), buffer);
+  }
+}
+
 TEST_F(GpgCoreTest, CoreSignVerifyClearTest) {
   auto sign_key = GpgKeyGetter::GetInstance().GetPubkey(
       "467F14220CE8DCF780CF4BAD8465C55B25C9B7D1");
@@ -263,4 +508,68 @@ TEST_F(GpgCoreTest, CoreEncryptSignDecrVerifyTest) {
             "8933EB283A18995F45D61DAC021D89771B680FFB");
 }
 
+TEST_F(GpgCoreTest, CoreContextPoolTest) {
+  auto& ctx = GpgContext::GetInstance();
+  const auto pool_size = ctx.ContextPoolSize();
+  ASSERT_GE(pool_size, 1);
+
+  std::vector<GpgContextHolder> holders;
+  std::set<gpgme_ctx_t> distinct;
+  for (int i = 0; i < pool_size; i++) {
+    auto holder = ctx.AcquireContext(true);
+    ASSERT_NE(holder.get(), nullptr);
+    ASSERT_EQ(gpgme_get_armor(holder.get()), 1);
+    ASSERT_NE(holder.get(), ctx.DefaultContext());
+    distinct.insert(holder.get());
+    holders.push_back(std::move(holder));
+  }
+  ASSERT_EQ(distinct.size(), static_cast<size_t>(pool_size));
+
+  // a returned context is handed out again instead of creating a new one
+  auto* returned = holders.back().get();
+  holders.pop_back();
+  auto again = ctx.AcquireContext(true);
+  ASSERT_EQ(again.get(), returned);
+
+  auto binary = ctx.AcquireContext(false);
+  ASSERT_NE(binary.get(), nullptr);
+  ASSERT_EQ(gpgme_get_armor(binary.get()), 0);
+}
+
+TEST_F(GpgCoreTest, CoreContextPoolOutlivedTest) {
+  GpgContextInitArgs args;
+  args.test_mode = true;
+  args.offline_mode = true;
+  args.db_path = GpgContext::GetInstance().GetDatabasePath();
+
+  // the holder goes back to a pool its context is already gone from
+  auto ctx = std::make_unique<GpgContext>(args, kGpgFrontendDefaultChannel);
+  ASSERT_TRUE(ctx->Good());
+  auto holder = ctx->AcquireContext(true);
+  ASSERT_NE(holder.get(), nullptr);
+
+  ctx.reset();
+  ASSERT_EQ(gpgme_get_armor(holder.get()), 1);
+  holder.reset();
+}
+
+TEST_F(GpgCoreTest, CoreContextPoolConcurrentEncryptTest) {
+  auto encrypt_key = GpgKeyGetter::GetInstance().GetPubkey(
+      "E87C6A2D8D95C818DE93B3AE6A2764F8298DEB29");
+  auto buffer = GFBuffer(QString("Hello GpgFrontend!"));
+
+  std::vector<std::thread> workers;
+  std::atomic_int succeeded = 0;
+  for (int i = 0; i < 8; i++) {
+    workers.emplace_back([&, i]() {
+      auto [err, data_object] = GpgBasicOperator::GetInstance().EncryptSync(
+          {encrypt_key}, buffer, i % 2 == 0);
+      if (CheckGpgError(err) == GPG_ERR_NO_ERROR) succeeded++;
+    });
+  }
+  for (auto& worker : workers) worker.join();
+
+  ASSERT_EQ(succeeded.load(), 8);
+}
+
 }  // namespace GpgFrontend::Test
@@ -0,0 +1,108 @@
+/**
+ * Copyright (C) 2021 Saturneric <eric@bktus.com>
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric <eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <array>
+#include <cstring>
+
+#include "GpgCoreTest.h"
+#include "core/model/GFBuffer.h"
+#include "core/model/GpgData.h"
+
+namespace GpgFrontend::Test {
+
+TEST_F(GpgCoreTest, CoreBufferShareAndDetachTest) {
+  GFBuffer buffer;
+  buffer.Reserve(4096);
+  const auto* storage = buffer.Data();
+  for (int i = 0; i < 256; i++) buffer.Append("0123456789abcdef", 16);
+
+  // appending within the reserved capacity never reallocates
+  ASSERT_EQ(buffer.Size(), 4096U);
+  ASSERT_EQ(buffer.Data(), storage);
+
+  // copies and views share the storage until one of them writes
+  auto copy = buffer;
+  auto view = buffer.Slice(16, 32);
+  ASSERT_EQ(copy.Data(), storage);
+  ASSERT_EQ(view.Data(), storage + 16);
+  ASSERT_EQ(view.ConvertToQByteArray(), QByteArray("0123456789abcdef"
+                                                   "0123456789abcdef"));
+
+  copy.Append("!", 1);
+  ASSERT_NE(copy.Data(), storage);
+  ASSERT_EQ(buffer.Size(), 4096U);
+  ASSERT_EQ(copy.Size(), 4097U);
+
+  // the view outlives the buffer it was taken from
+  buffer = GFBuffer();
+  ASSERT_EQ(view.Size(), 32U);
+  ASSERT_EQ(memcmp(view.Data(), "0123456789abcdef", 16), 0);
+  ASSERT_TRUE(view.Slice(64, 8).Empty());
+
+  auto moved = std::move(copy);
+  ASSERT_TRUE(copy.Empty());
+  ASSERT_EQ(moved.Size(), 4097U);
+  ASSERT_EQ(moved.Data()[moved.Size()], '\0');
+}
+
+TEST_F(GpgCoreTest, CoreBufferShrinkSharedTest) {
+  GFBuffer buffer;
+  for (int i = 0; i < 256; i++) buffer.Append("0123456789abcdef", 16);
+
+  // shrinking detaches from the copy and the view, which keep their bytes
+  auto copy = buffer;
+  auto view = buffer.Slice(4080, 16);
+  buffer.Resize(20);
+  ASSERT_EQ(buffer.Size(), 20U);
+  ASSERT_EQ(buffer.Data()[20], '\0');
+  ASSERT_EQ(memcmp(buffer.Data(), "0123456789abcdef0123", 20), 0);
+  ASSERT_EQ(copy.Size(), 4096U);
+  ASSERT_EQ(memcmp(view.Data(), "0123456789abcdef", 16), 0);
+
+  // growing again after the detach zero fills
+  buffer.Resize(32);
+  ASSERT_EQ(buffer.Size(), 32U);
+  ASSERT_EQ(buffer.Data()[20], '\0');
+  ASSERT_EQ(buffer.Data()[31], '\0');
+
+  auto shared = copy;
+  copy.Resize(0);
+  ASSERT_TRUE(copy.Empty());
+  ASSERT_EQ(shared.Size(), 4096U);
+}
+
+TEST_F(GpgCoreTest, CoreBufferViewGpgDataTest) {
+  auto buffer = GFBuffer(QString("header:payload"));
+  GpgData data_in(buffer.Slice(7, 7));
+
+  std::array<char, 16> read{};
+  ASSERT_EQ(gpgme_data_read(data_in, read.data(), read.size()), 7);
+  ASSERT_EQ(QByteArray(read.data(), 7), QByteArray("payload"));
+}
+
+}  // namespace GpgFrontend::Test
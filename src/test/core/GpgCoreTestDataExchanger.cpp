@@ -0,0 +1,118 @@
+/**
+ * Copyright (C) 2021 Saturneric <eric@bktus.com>
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric <eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <array>
+#include <chrono>
+#include <thread>
+
+#include "GpgCoreTest.h"
+#include "core/model/GFDataExchanger.h"
+
+namespace GpgFrontend::Test {
+
+TEST_F(GpgCoreTest, CoreDataExchangerRoundTripTest) {
+  // a tiny capacity forces the ring buffer to wrap on almost every call
+  GFDataExchanger ex(7);
+
+  std::vector<std::byte> input(100000);
+  for (size_t i = 0; i < input.size(); i++) {
+    input[i] = static_cast<std::byte>(i % 251);
+  }
+
+  std::thread producer([&]() {
+    const auto written = ex.Write(input.data(), input.size());
+    EXPECT_EQ(written, static_cast<ssize_t>(input.size()));
+
+    // a failed write must not leave the reader waiting
+    if (written != static_cast<ssize_t>(input.size())) {
+      ex.Close();
+      return;
+    }
+    ex.CloseWrite();
+  });
+
+  std::vector<std::byte> output;
+  std::array<std::byte, 13> buffer;
+  ssize_t ret = 0;
+  while ((ret = ex.Read(buffer.data(), buffer.size())) > 0) {
+    output.insert(output.end(), buffer.begin(), buffer.begin() + ret);
+  }
+  producer.join();
+
+  ASSERT_EQ(input, output);
+  ASSERT_EQ(ex.Write(input.data(), input.size()), -1);
+}
+
+TEST_F(GpgCoreTest, CoreDataExchangerCloseTest) {
+  GFDataExchanger ex(16);
+
+  // a blocked reader fails instead of seeing the end of stream
+  std::thread reader([&]() {
+    std::array<std::byte, 8> buffer;
+    EXPECT_EQ(ex.Read(buffer.data(), buffer.size()), -1);
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ex.Close();
+  reader.join();
+
+  std::array<std::byte, 8> buffer{};
+  ASSERT_TRUE(ex.IsAborted());
+  ASSERT_EQ(ex.Write(buffer.data(), buffer.size()), -1);
+  ASSERT_EQ(ex.Read(buffer.data(), buffer.size()), -1);
+}
+
+TEST_F(GpgCoreTest, CoreDataExchangerThroughputTest) {
+  constexpr size_t kTotalSize = 64 * 1024 * 1024;
+  GFDataExchanger ex(1024 * 1024);
+
+  const auto start = std::chrono::steady_clock::now();
+  std::thread producer([&]() {
+    std::vector<std::byte> chunk(64 * 1024);
+    for (size_t sent = 0; sent < kTotalSize; sent += chunk.size()) {
+      if (ex.Write(chunk.data(), chunk.size()) < 0) return;
+    }
+    ex.CloseWrite();
+  });
+
+  size_t total = 0;
+  std::vector<std::byte> buffer(32 * 1024);
+  ssize_t ret = 0;
+  while ((ret = ex.Read(buffer.data(), buffer.size())) > 0) total += ret;
+  producer.join();
+
+  const auto seconds = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+  GF_TEST_LOG_INFO("gf data exchanger throughput: {:.1f} MB/s",
+                   static_cast<double>(total) / 1024 / 1024 / seconds);
+
+  ASSERT_EQ(total, kTotalSize);
+}
+
+}  // namespace GpgFrontend::Test
@@ -26,4 +26,213 @@
  *
  */
 
+#include <map>
+#include <thread>
+
 #include "GpgCoreTest.h"
+#include "core/function/ArchiveFileOperator.h"
+#include "core/function/gpg/GpgFileOpera.h"
+#include "core/utils/GpgUtils.h"
+#include "core/utils/IOUtils.h"
+
+namespace GpgFrontend::Test {
+
+namespace {
+
+using DirectoryContents = QMap<QString, QByteArray>;
+
+/**
+ * @brief a new directory with the files, the names start with a slash
+ *
+ */
+auto WriteDirectory(const DirectoryContents& contents) -> QString {
+  auto dir_path = GetTempFilePath();
+  for (auto it = contents.cbegin(); it != contents.cend(); ++it) {
+    const auto path = dir_path + it.key();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    WriteFile(path, it.value());
+  }
+  return dir_path;
+}
+
+/**
+ * @brief whether the directory holds the files, and their contents
+ *
+ */
+auto IsDirectoryHolding(const QString& dir_path,
+                        const DirectoryContents& contents) -> bool {
+  for (auto it = contents.cbegin(); it != contents.cend(); ++it) {
+    QByteArray data;
+    if (!ReadFile(dir_path + it.key(), data) || data != it.value()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+struct DirectoryArchive {
+  GpgError err = GPG_ERR_GENERAL;  ///<
+  QString encrypted_path;          ///< the output of gpg
+  QByteArray archive;              ///< what gpg has encrypted
+};
+
+/**
+ * @brief encrypt the directory symmetrically, and decrypt the output to
+ * get the archive itself
+ *
+ */
+auto ArchiveDirectory(const QString& dir_path) -> DirectoryArchive {
+  DirectoryArchive result;
+  result.encrypted_path = GetTempFilePath();
+  result.err = std::get<0>(
+      GpgFileOpera::GetInstance().EncryptDerectorySymmetricSync(
+          dir_path, false, result.encrypted_path));
+  if (CheckGpgError(result.err) != GPG_ERR_NO_ERROR) return result;
+
+  auto archive_path = GetTempFilePath();
+  result.err = std::get<0>(GpgFileOpera::GetInstance().DecryptFileSync(
+      result.encrypted_path, archive_path));
+  if (CheckGpgError(result.err) != GPG_ERR_NO_ERROR) return result;
+
+  if (!ReadFile(archive_path, result.archive)) result.err = GPG_ERR_GENERAL;
+  return result;
+}
+
+}  // namespace
+
+TEST_F(GpgCoreTest, CoreDirectoryArchiveFilterTest) {
+  const auto content = QByteArray(1024 * 1024, 'A');
+  const DirectoryContents contents = {
+      {"/a.txt", content}, {"/b.txt", content}, {"/sub/c.txt", content}};
+  auto dir_path = WriteDirectory(contents);
+
+  ScopedSettings settings;
+  std::map<QString, qint64> archive_sizes;
+
+  for (const auto* filter : {"none", "zstd"}) {
+    settings.Set("gnupg/archive_filter", filter);
+
+    auto result = ArchiveDirectory(dir_path);
+    ASSERT_EQ(CheckGpgError(result.err), GPG_ERR_NO_ERROR);
+    archive_sizes[filter] = result.archive.size();
+
+    if (QString(filter) == "zstd" &&
+        !result.archive.startsWith("\x28\xb5\x2f\xfd")) {
+      GTEST_SKIP() << "libarchive is built without zstd";
+    }
+
+    // and the archive is extracted again whatever its filter is
+    auto target_path = GetTempFilePath();
+    ASSERT_TRUE(QDir().mkpath(target_path));
+
+    QEventLoop loop;
+    GpgError err = GPG_ERR_GENERAL;
+    GpgFileOpera::GetInstance().DecryptArchive(
+        result.encrypted_path, target_path,
+        [&](GpgError decrypt_err, const DataObjectPtr&) {
+          err = decrypt_err;
+          loop.quit();
+        });
+    loop.exec();
+    ASSERT_EQ(CheckGpgError(err), GPG_ERR_NO_ERROR);
+
+    // the extraction ends a little after gpg is done with the archive
+    QElapsedTimer timer;
+    timer.start();
+    while (!IsDirectoryHolding(target_path, contents) &&
+           timer.elapsed() < 30000) {
+      QThread::msleep(10);
+    }
+    ASSERT_TRUE(IsDirectoryHolding(target_path, contents));
+  }
+
+  ASSERT_LT(archive_sizes["zstd"], archive_sizes["none"]);
+}
+
+TEST_F(GpgCoreTest, CoreDirectoryArchivePrefetchTest) {
+  DirectoryContents contents;
+  for (int i = 0; i < 200; i++) {
+    contents[QString("/sub/%1.txt").arg(i)] =
+        QString("file-%1;").arg(i).toLatin1().repeated(64 * i + 1);
+  }
+  contents["/large.bin"] = QByteArray("large;").repeated(1024 * 1024);
+  auto dir_path = WriteDirectory(contents);
+
+  // a small budget makes the workers wait for the writer
+  ScopedSettings settings{{"gnupg/archive_prefetch_budget", 1},
+                          {"gnupg/archive_prefetch_workers", 3}};
+
+  auto result = ArchiveDirectory(dir_path);
+  ASSERT_EQ(CheckGpgError(result.err), GPG_ERR_NO_ERROR);
+  for (const auto& content : contents) {
+    ASSERT_TRUE(result.archive.contains(content));
+  }
+}
+
+TEST_F(GpgCoreTest, CoreDirectoryArchiveExtractTest) {
+  DirectoryContents contents;
+  for (int i = 0; i < 300; i++) {
+    auto name = QString(i % 2 == 0 ? "/sub/%1.txt" : "/sub/deep/%1.txt").arg(i);
+    contents[name] = QString("entry-%1;").arg(i).toLatin1().repeated(16 * i);
+  }
+  // larger than a write-behind entry, extracted on the reading thread
+  contents["/large.bin"] = QByteArray("large;").repeated(1024 * 1024);
+
+  auto result = ArchiveDirectory(WriteDirectory(contents));
+  ASSERT_EQ(CheckGpgError(result.err), GPG_ERR_NO_ERROR);
+  const auto& archive = result.archive;
+
+  // a small budget makes the reader wait for the workers
+  ScopedSettings settings{{"gnupg/archive_extract_budget", 1},
+                          {"gnupg/archive_read_buffer_size", 64}};
+
+  auto target_path = GetTempFilePath();
+  ASSERT_TRUE(QDir().mkpath(target_path));
+
+  auto ex = std::make_shared<GFDataExchanger>(1024 * 1024);
+  QEventLoop loop;
+  GFError extract_err = -1;
+  ArchiveFileOperator::ExtractArchiveFromDataExchanger(
+      ex, target_path, [&](GFError err, const DataObjectPtr&) {
+        extract_err = err;
+        loop.quit();
+      });
+
+  std::thread writer([&]() {
+    ex->Write(reinterpret_cast<const std::byte*>(archive.constData()),
+              archive.size());
+    ex->CloseWrite();
+  });
+  loop.exec();
+  writer.join();
+  ASSERT_EQ(extract_err, 0);
+  ASSERT_TRUE(IsDirectoryHolding(target_path, contents));
+}
+
+TEST_F(GpgCoreTest, CoreDirectoryArchiveExtractErrorTest) {
+  auto target_path = GetTempFilePath();
+  ASSERT_TRUE(QDir().mkpath(target_path));
+
+  // more than the exchanger holds, the writer must not block after the
+  // reader gave up
+  auto garbage = QByteArray("not an archive;").repeated(512 * 1024);
+  auto ex = std::make_shared<GFDataExchanger>(1024 * 1024);
+  QEventLoop loop;
+  GFError extract_err = 0;
+  ArchiveFileOperator::ExtractArchiveFromDataExchanger(
+      ex, target_path, [&](GFError err, const DataObjectPtr&) {
+        extract_err = err;
+        loop.quit();
+      });
+
+  std::thread writer([&]() {
+    ex->Write(reinterpret_cast<const std::byte*>(garbage.constData()),
+              garbage.size());
+    ex->CloseWrite();
+  });
+  loop.exec();
+  writer.join();
+  ASSERT_NE(extract_err, 0);
+}
+
+}  // namespace GpgFrontend::Test
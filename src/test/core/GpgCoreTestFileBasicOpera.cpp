@@ -26,14 +26,18 @@
  *
  */
 
+#include <thread>
+
 #include "GpgCoreTest.h"
 #include "core/GpgModel.h"
 #include "core/function/gpg/GpgFileOpera.h"
 #include "core/function/gpg/GpgKeyGetter.h"
 #include "core/model/GpgDecryptResult.h"
 #include "core/model/GpgEncryptResult.h"
+#include "core/model/GpgFileBatchResult.h"
 #include "core/model/GpgSignResult.h"
 #include "core/model/GpgVerifyResult.h"
+#include "core/thread/Task.h"
 #include "core/utils/GpgUtils.h"
 #include "core/utils/IOUtils.h"
 
@@ -102,6 +106,165 @@ TEST_F(GpgCoreTest, CoreFileEncryptDecrBinaryTest) {
   ASSERT_EQ(buffer, out_buffer);
 }
 
+TEST_F(GpgCoreTest, CoreFileMappedInputTest) {
+  auto buffer = GFBuffer(QByteArray(64 * 1024 * 1024, 'G'));
+  auto input_file = CreateTempFileAndWriteData(buffer);
+
+  for (const auto map : {false, true}) {
+    GpgData data_in(input_file, true, map);
+    ASSERT_EQ(data_in.IsMapped(), map);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    size_t total = 0;
+    std::array<char, 64 * 1024> read_buffer;
+    ssize_t ret = 0;
+    while ((ret = gpgme_data_read(data_in, read_buffer.data(),
+                                  read_buffer.size())) > 0) {
+      total += ret;
+    }
+
+    const auto seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+    GF_TEST_LOG_INFO("gpg data input throughput, mapped: {}, {:.1f} MB/s", map,
+                     static_cast<double>(total) / 1024 / 1024 / seconds);
+
+    ASSERT_EQ(total, buffer.Size());
+  }
+
+  // empty files cannot be mapped and fall back to the stream
+  GpgData empty_data_in(CreateTempFileAndWriteData(GFBuffer()), true, true);
+  ASSERT_FALSE(empty_data_in.IsMapped());
+}
+
+TEST_F(GpgCoreTest, CoreFileProgressTest) {
+  auto buffer = GFBuffer(QByteArray(4 * 1024 * 1024, 'P'));
+  auto input_file = CreateTempFileAndWriteData(buffer);
+
+  for (const auto map : {false, true}) {
+    GpgData data_in(input_file, true, map);
+
+    qint64 last_reported = 0;
+    data_in.SetProgressCb(
+        [&last_reported](qint64 processed) { last_reported = processed; });
+
+    std::array<char, 64 * 1024> read_buffer;
+    while (gpgme_data_read(data_in, read_buffer.data(), read_buffer.size()) >
+           0) {
+    }
+
+    ASSERT_EQ(data_in.ProcessedBytes(), static_cast<qint64>(buffer.Size()));
+    ASSERT_EQ(last_reported, static_cast<qint64>(buffer.Size()));
+  }
+
+  // a finished operation is reported exactly once, whatever the interval
+  Thread::Task task("progress_test");
+  int emitted = 0;
+  qint64 last_processed = 0;
+  QObject::connect(&task, &Thread::Task::SignalTaskProgress,
+                   [&](qint64 processed, qint64, double) {
+                     emitted++;
+                     last_processed = processed;
+                   });
+
+  for (int i = 0; i <= 100; i++) task.ReportProgress(i, 100);
+  task.ReportProgress(100, 100);
+
+  ASSERT_EQ(emitted, 1);
+  ASSERT_EQ(last_processed, 100);
+}
+
+TEST_F(GpgCoreTest, CoreFileCancelTest) {
+  auto encrypt_key = GpgKeyGetter::GetInstance().GetPubkey(
+      "E87C6A2D8D95C818DE93B3AE6A2764F8298DEB29");
+
+  auto buffer = GFBuffer(QByteArray(16 * 1024 * 1024, 'C'));
+  auto input_file = CreateTempFileAndWriteData(buffer);
+  auto output_file = GetTempFilePath();
+
+  // once the interval has passed, the first block read is reported at once
+  // and cancels the operation from the thread running it
+  Thread::Task task("cancel_test");
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(Thread::kTaskProgressInterval));
+  QObject::connect(
+      &task, &Thread::Task::SignalTaskProgress, &task,
+      [&task](qint64 processed, qint64 total, double) {
+        if (processed < total) task.Cancel();
+      },
+      Qt::DirectConnection);
+
+  GpgError err = GPG_ERR_NO_ERROR;
+  task.RunOnBehalf([&]() {
+    std::tie(err, std::ignore) = GpgFileOpera::GetInstance().EncryptFileSync(
+        {encrypt_key}, input_file, false, output_file);
+  });
+  ASSERT_TRUE(task.IsCancelled());
+
+  ASSERT_EQ(CheckGpgError2ErrCode(err), GPG_ERR_CANCELED);
+  ASSERT_FALSE(QFile::exists(output_file));
+
+  // a cancelled task doesn't start further operations
+  task.RunOnBehalf([&]() {
+    std::tie(err, std::ignore) = GpgFileOpera::GetInstance().EncryptFileSync(
+        {encrypt_key}, input_file, false, output_file);
+  });
+  ASSERT_EQ(CheckGpgError2ErrCode(err), GPG_ERR_CANCELED);
+  ASSERT_FALSE(QFile::exists(output_file));
+}
+
+TEST_F(GpgCoreTest, CoreFileDigestsTest) {
+  const QStringList algos = {"MD5", "SHA1", "SHA256"};
+  const std::array<QCryptographicHash::Algorithm, 3> qt_algos = {
+      QCryptographicHash::Md5, QCryptographicHash::Sha1,
+      QCryptographicHash::Sha256};
+
+  // the large file goes through the parallel digests
+  for (const auto size : {1000, 64 * 1024 * 1024 + 17}) {
+    QByteArray data(size, Qt::Uninitialized);
+    for (int i = 0; i < size; i++) data[i] = static_cast<char>(i % 253);
+    auto input_file = CreateTempFileAndWriteData(GFBuffer(data));
+
+    for (const auto parallel : {false, true}) {
+      const auto start = std::chrono::steady_clock::now();
+      auto [ret, digests] = CalculateFileDigests(input_file, algos, parallel);
+      const auto seconds = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+      GF_TEST_LOG_INFO("file digests, size: {}, parallel: {}, {:.1f} MB/s",
+                       size, parallel,
+                       static_cast<double>(size) / 1024 / 1024 / seconds);
+
+      ASSERT_TRUE(ret);
+      ASSERT_EQ(digests.size(), algos.size());
+      for (size_t i = 0; i < qt_algos.size(); i++) {
+        ASSERT_EQ(digests[static_cast<int>(i)],
+                  QCryptographicHash::hash(data, qt_algos[i]));
+      }
+    }
+  }
+
+  auto [ret, digests] = CalculateFileDigests(
+      CreateTempFileAndWriteData(GFBuffer()), {"NO_SUCH_DIGEST"});
+  ASSERT_FALSE(ret);
+
+  // every file below a directory is listed
+  auto dir_path = GetTempFilePath();
+  ASSERT_TRUE(QDir().mkpath(dir_path + "/sub"));
+  WriteFile(dir_path + "/a.txt", "GpgFrontend");
+  WriteFile(dir_path + "/sub/b.txt", "Directory Hash");
+
+  auto info = CalculateHash(dir_path);
+  ASSERT_TRUE(info.contains("sub/b.txt"));
+  ASSERT_TRUE(info.contains(QString::fromLatin1(
+      QCryptographicHash::hash("GpgFrontend", QCryptographicHash::Sha256)
+          .toHex())));
+  ASSERT_TRUE(info.contains(QString::fromLatin1(
+      QCryptographicHash::hash("Directory Hash", QCryptographicHash::Sha256)
+          .toHex())));
+}
+
 TEST_F(GpgCoreTest, CoreFileEncryptSymmetricDecrTest) {
   auto buffer = GFBuffer(QString("Hello GpgFrontend!"));
   auto input_file = CreateTempFileAndWriteData(buffer);
@@ -300,4 +463,54 @@ TEST_F(GpgCoreTest, CoreFileEncryptSignDecrVerifyBinaryTest) {
   ASSERT_EQ(buffer, out_buffer);
 }
 
+TEST_F(GpgCoreTest, CoreFileBatchEncryptDecrTest) {
+  auto encrypt_key = GpgKeyGetter::GetInstance().GetPubkey(
+      "E87C6A2D8D95C818DE93B3AE6A2764F8298DEB29");
+
+  std::vector<GFBuffer> buffers;
+  GpgFilePathPairs encrypt_files;
+  GpgFilePathPairs decrypt_files;
+  for (int i = 0; i < 16; i++) {
+    buffers.emplace_back(QString("Hello GpgFrontend! %1").arg(i));
+    auto encrypted_file = GetTempFilePath();
+    encrypt_files.emplace_back(CreateTempFileAndWriteData(buffers.back()),
+                               encrypted_file);
+    decrypt_files.emplace_back(encrypted_file, GetTempFilePath());
+  }
+
+  auto [err, data_object] = GpgFileOpera::GetInstance().EncryptFilesSync(
+      {encrypt_key}, encrypt_files, false);
+
+  ASSERT_EQ(CheckGpgError(err), GPG_ERR_NO_ERROR);
+  ASSERT_TRUE((data_object->Check<GpgFileBatchResult>()));
+  auto result = ExtractParams<GpgFileBatchResult>(data_object, 0);
+  ASSERT_EQ(result.entries.size(), encrypt_files.size());
+  ASSERT_EQ(result.succeeded, encrypt_files.size());
+  ASSERT_EQ(result.failed, 0U);
+  ASSERT_GE(result.workers, 1);
+
+  // one broken input must not stop the rest of the batch
+  decrypt_files.emplace_back(
+      CreateTempFileAndWriteData(GFBuffer(QString("not encrypted"))),
+      GetTempFilePath());
+
+  auto [err_0, data_object_0] =
+      GpgFileOpera::GetInstance().DecryptFilesSync(decrypt_files);
+
+  ASSERT_NE(CheckGpgError(err_0), GPG_ERR_NO_ERROR);
+  auto decr_result = ExtractParams<GpgFileBatchResult>(data_object_0, 0);
+  ASSERT_EQ(decr_result.succeeded, buffers.size());
+  ASSERT_EQ(decr_result.failed, 1U);
+
+  for (size_t i = 0; i < buffers.size(); i++) {
+    const auto& entry = decr_result.entries[i];
+    ASSERT_EQ(CheckGpgError(entry.err), GPG_ERR_NO_ERROR);
+    ASSERT_TRUE((entry.data_object->Check<GpgDecryptResult>()));
+
+    const auto [read_success, out_buffer] = ReadFileGFBuffer(entry.out_path);
+    ASSERT_TRUE(read_success);
+    ASSERT_EQ(buffers[i], out_buffer);
+  }
+}
+
 }  // namespace GpgFrontend::Test
@@ -31,9 +31,13 @@
 #include "GpgCoreTest.h"
 #include "core/function/gpg/GpgContext.h"
 #include "core/function/gpg/GpgKeyGetter.h"
+#include "core/function/gpg/GpgKeyMetadataStore.h"
+#include "core/model/GFDataExchanger.h"
 #include "core/model/GpgData.h"
 #include "core/model/GpgKey.h"
+#include "core/model/GpgKeySummaryTable.h"
 #include "core/utils/GpgUtils.h"
+#include "core/utils/IOUtils.h"
 
 namespace GpgFrontend::Test {
 
@@ -54,6 +58,42 @@ TEST_F(GpgCoreTest, GpgDataTest) {
   ASSERT_EQ(out_buffer.Size(), 64);
 }
 
+TEST_F(GpgCoreTest, GpgDataExchangerReleaseTest) {
+  const auto data_buff = QByteArray("Hello GpgFrontend!");
+
+  // the reader sees the end of the stream once the data is released
+  auto ex = std::make_shared<GFDataExchanger>(64);
+  {
+    GpgData data(ex);
+    ASSERT_EQ(gpgme_data_write(data, data_buff.constData(), data_buff.size()),
+              data_buff.size());
+  }
+  std::array<std::byte, 64> buffer{};
+  ASSERT_EQ(ex->Read(buffer.data(), buffer.size()), data_buff.size());
+  ASSERT_EQ(ex->Read(buffer.data(), buffer.size()), 0);
+
+  // and the data may hold the last reference to the exchanger
+  auto w_ex = std::weak_ptr<GFDataExchanger>(ex);
+  {
+    GpgData data(std::move(ex));
+    ASSERT_EQ(gpgme_data_write(data, data_buff.constData(), data_buff.size()),
+              data_buff.size());
+  }
+  ASSERT_TRUE(w_ex.expired());
+}
+
+TEST_F(GpgCoreTest, GpgDataSizeHintTest) {
+  auto data_buff = QByteArray(
+      "cqEh8fyKWtmiXrW2zzlszJVGJrpXDDpzgP7ZELGxhfZYFi8rMrSVKDwrpFZBSWMG");
+
+  GpgData data(GpgDataSizeHint{16});
+  ASSERT_EQ(gpgme_data_write(data, data_buff.constData(), 32), 32);
+  ASSERT_EQ(gpgme_data_write(data, data_buff.constData() + 32, 32), 32);
+
+  auto out_buffer = data.Read2GFBuffer();
+  ASSERT_EQ(out_buffer, GFBuffer(data_buff));
+}
+
 TEST_F(GpgCoreTest, GpgKeyTest) {
   auto key = GpgKeyGetter::GetInstance(kGpgFrontendDefaultChannel)
                  .GetKey("9490795B78F8AFE9F93BD09281704859182661FB");
@@ -161,7 +201,7 @@ TEST_F(GpgCoreTest, GpgUIDTest) {
 
 TEST_F(GpgCoreTest, GpgKeySignatureTest) {
   auto key = GpgKeyGetter::GetInstance(kGpgFrontendDefaultChannel)
-                 .GetKey("9490795B78F8AFE9F93BD09281704859182661FB");
+                 .GetKeyDetail("9490795B78F8AFE9F93BD09281704859182661FB");
   auto uids = key.GetUIDs();
   ASSERT_EQ(uids->size(), 1);
   auto& uid = uids->front();
@@ -183,6 +223,69 @@ TEST_F(GpgCoreTest, GpgKeySignatureTest) {
             "GpgFrontendTest <gpgfrontend@gpgfrontend.pub>");
 }
 
+TEST_F(GpgCoreTest, GpgKeyViewTest) {
+  auto key = GpgKeyGetter::GetInstance(kGpgFrontendDefaultChannel)
+                 .GetKeyDetail("9490795B78F8AFE9F93BD09281704859182661FB");
+  ASSERT_TRUE(key.IsGood());
+
+  // the views walk the same nodes as the copied out lists
+  auto sub_keys = key.GetSubKeys();
+  auto sub_key_view = key.GetSubKeyView();
+  ASSERT_EQ(sub_key_view.Size(), sub_keys->size());
+  ASSERT_TRUE(std::equal(sub_key_view.begin(), sub_key_view.end(),
+                         sub_keys->begin()));
+  ASSERT_EQ(sub_key_view.Front().GetID(), "81704859182661FB");
+
+  auto uid_view = key.GetUIDView();
+  ASSERT_EQ(uid_view.Size(), 1);
+  auto uid = uid_view.Front();
+  ASSERT_EQ(uid.GetUID(), "GpgFrontendTest <gpgfrontend@gpgfrontend.pub>");
+
+  auto signature_view = uid.GetSignatureView();
+  ASSERT_EQ(signature_view.Size(), uid.GetSignatures()->size());
+  for (const auto& signature : signature_view) {
+    ASSERT_EQ(signature.GetKeyID(), "81704859182661FB");
+  }
+  ASSERT_EQ(uid.GetTofuInfoView().Size(), uid.GetTofuInfos()->size());
+}
+
+TEST_F(GpgCoreTest, GpgKeyViewBenchmarkTest) {
+  auto keys = GpgKeyGetter::GetInstance(kGpgFrontendDefaultChannel).FetchKey();
+  ASSERT_FALSE(keys->empty());
+
+  // what a listing of a keyring of that many keys walks per key, the test
+  // keyring is cycled through to reach it
+  constexpr int kKeys = 10000;
+
+  QElapsedTimer timer;
+  timer.start();
+  size_t copied = 0;
+  for (int i = 0; i < kKeys;) {
+    for (auto it = keys->begin(); it != keys->end() && i < kKeys; ++it, i++) {
+      auto subkeys = it->GetSubKeys();
+      for (const auto& subkey : *subkeys) copied += subkey.IsCardKey();
+      copied += it->GetUIDs()->size();
+    }
+  }
+  const auto copied_us = timer.nsecsElapsed() / 1000;
+
+  timer.restart();
+  size_t viewed = 0;
+  for (int i = 0; i < kKeys;) {
+    for (auto it = keys->begin(); it != keys->end() && i < kKeys; ++it, i++) {
+      for (const auto& subkey : it->GetSubKeyView()) {
+        viewed += subkey.IsCardKey();
+      }
+      viewed += it->GetUIDView().Size();
+    }
+  }
+  const auto viewed_us = timer.nsecsElapsed() / 1000;
+
+  ASSERT_EQ(viewed, copied);
+  GF_TEST_LOG_INFO("walking {} keys, copied out: {} us, views: {} us", kKeys,
+                   copied_us, viewed_us);
+}
+
 TEST_F(GpgCoreTest, GpgKeyGetterTest) {
   auto key = GpgKeyGetter::GetInstance(kGpgFrontendDefaultChannel)
                  .GetKey("9490795B78F8AFE9F93BD09281704859182661FB");
@@ -193,4 +296,183 @@ TEST_F(GpgCoreTest, GpgKeyGetterTest) {
   ASSERT_TRUE(find(keys->begin(), keys->end(), key) != keys->end());
 }
 
+TEST_F(GpgCoreTest, GpgKeyGetterDetailTest) {
+  auto& getter = GpgKeyGetter::GetInstance(kGpgFrontendDefaultChannel);
+  ASSERT_TRUE(getter.FlushKeyCache());
+
+  // the listing leaves the certifications out
+  auto key = getter.GetKey("9490795B78F8AFE9F93BD09281704859182661FB");
+  ASSERT_TRUE(key.IsGood());
+  ASSERT_FALSE(key.IsHasDetail());
+  ASSERT_TRUE(key.GetUIDs()->front().GetSignatures()->empty());
+
+  // a private key keeps its secret parts along with the signatures
+  auto detail = getter.GetKeyDetail(key.GetId());
+  ASSERT_TRUE(detail.IsHasDetail());
+  ASSERT_TRUE(detail.IsPrivateKey());
+  ASSERT_TRUE(detail.IsHasMasterKey());
+  ASSERT_EQ(detail.GetFingerprint(), key.GetFingerprint());
+  ASSERT_EQ(detail.GetUIDs()->front().GetSignatures()->size(), 1);
+}
+
+TEST_F(GpgCoreTest, GpgKeyGetterIndexTest) {
+  auto& getter = GpgKeyGetter::GetInstance(kGpgFrontendDefaultChannel);
+  ASSERT_TRUE(getter.FlushKeyCache());
+
+  const auto fpr = QString("9490795B78F8AFE9F93BD09281704859182661FB");
+
+  // keys from the cache are summaries, gpgme_get_key lists the details
+  for (const auto& query :
+       {QString("2B36803235B5E25B"), QString("0x2b36803235b5e25b"),
+        QString("35B5E25B"), QString("182661FB")}) {
+    auto key = getter.GetKey(query);
+    ASSERT_TRUE(key.IsGood());
+    ASSERT_FALSE(key.IsHasDetail());
+    ASSERT_EQ(key.GetFingerprint(), fpr);
+  }
+
+  auto sub_key = getter.GetKey(fpr).GetSubKeys()->back();
+  auto key = getter.GetKey(sub_key.GetFingerprint());
+  ASSERT_FALSE(key.IsHasDetail());
+  ASSERT_EQ(key.GetFingerprint(), fpr);
+}
+
+TEST_F(GpgCoreTest, GpgKeyGetterSearchTest) {
+  auto& getter = GpgKeyGetter::GetInstance(kGpgFrontendDefaultChannel);
+  ASSERT_TRUE(getter.FlushKeyCache());
+
+  const auto fpr = QString("9490795B78F8AFE9F93BD09281704859182661FB");
+
+  for (const auto& keyword :
+       {QString("GpgFrontendTest"), QString("gpgfrontend.pub"),
+        QString("2b36803235"), QString("82661f"), QString("fb")}) {
+    ASSERT_TRUE(getter.SearchKeys(keyword).contains(fpr));
+  }
+
+  // the end of the key id followed by the subkey fingerprint
+  ASSERT_TRUE(getter.SearchKeys("182661fb50d37e8f").isEmpty());
+  ASSERT_TRUE(getter.SearchKeys("no such keyword").isEmpty());
+
+  // the index follows the targeted refreshes
+  auto changes = getter.RefreshKeys({fpr});
+  ASSERT_TRUE(changes.Contains(fpr));
+  ASSERT_TRUE(getter.SearchKeys("82661f").contains(fpr));
+}
+
+TEST_F(GpgCoreTest, GpgKeyMetadataStoreTest) {
+  auto& getter = GpgKeyGetter::GetInstance(kGpgFrontendDefaultChannel);
+  // a file of its own, the one of the channel is left alone
+  GpgKeyMetadataStore store(kGpgFrontendDefaultChannel, GetTempFilePath());
+  auto keys = getter.FetchKey();
+
+  ASSERT_TRUE(store.Save(store.GetKeyDatabaseStamp(), *keys));
+  ASSERT_TRUE(store.IsValid());
+
+  auto metadata_list = store.Load();
+  ASSERT_TRUE(metadata_list.has_value());
+  ASSERT_EQ(metadata_list->size(), keys->size());
+
+  auto it = std::find_if(
+      metadata_list->begin(), metadata_list->end(), [](const auto& m) {
+        return m.fingerprint == "9490795B78F8AFE9F93BD09281704859182661FB";
+      });
+  ASSERT_TRUE(it != metadata_list->end());
+  ASSERT_EQ(it->id, "81704859182661FB");
+  ASSERT_EQ(it->email, "gpgfrontend@gpgfrontend.pub");
+  ASSERT_TRUE(it->Has(GpgKeyMetadata::kPrivateKey));
+  ASSERT_FALSE(it->Has(GpgKeyMetadata::kRevoked));
+
+  // a stamp of another state of the key database is rejected
+  ASSERT_TRUE(store.Save("outdated", *keys));
+  ASSERT_FALSE(store.IsValid());
+  ASSERT_FALSE(store.Load().has_value());
+
+  ASSERT_TRUE(store.Save(store.GetKeyDatabaseStamp(), *keys));
+  store.Remove();
+  ASSERT_FALSE(store.IsValid());
+
+  // a burst of saves is written once in the background, the latest one
+  store.SaveLater("outdated", keys);
+  store.SaveLater(store.GetKeyDatabaseStamp(), keys);
+  for (int i = 0; i < 50 && !store.IsValid(); i++) QThread::msleep(100);
+  ASSERT_TRUE(store.IsValid());
+
+  // and a removal drops the pending one
+  store.Remove();
+  store.SaveLater(store.GetKeyDatabaseStamp(), keys);
+  store.Remove();
+  QThread::msleep(1000);
+  ASSERT_FALSE(store.IsValid());
+}
+
+TEST_F(GpgCoreTest, GpgKeyGetterSnapshotTest) {
+  auto& getter = GpgKeyGetter::GetInstance(kGpgFrontendDefaultChannel);
+
+  // readers share the same snapshot until the cache changes
+  auto keys = getter.FetchKey();
+  ASSERT_EQ(keys.get(), getter.FetchKey().get());
+
+  const auto size = keys->size();
+  ASSERT_TRUE(getter.FlushKeyCache());
+
+  auto flushed = getter.FetchKey();
+  ASSERT_NE(keys.get(), flushed.get());
+  ASSERT_EQ(keys->size(), size);
+  ASSERT_EQ(flushed->size(), size);
+
+  auto changes =
+      getter.RefreshKeys({"9490795B78F8AFE9F93BD09281704859182661FB"});
+  ASSERT_TRUE(changes.Contains("9490795B78F8AFE9F93BD09281704859182661FB"));
+  ASSERT_NE(flushed.get(), getter.FetchKey().get());
+  ASSERT_EQ(flushed->size(), size);
+}
+
+TEST_F(GpgCoreTest, GpgKeySummaryTableTest) {
+  auto& getter = GpgKeyGetter::GetInstance(kGpgFrontendDefaultChannel);
+  auto keys = getter.FetchKey();
+
+  // one table per snapshot
+  auto summary = getter.GetKeySummary(keys);
+  ASSERT_EQ(summary.get(), getter.GetKeySummary(keys).get());
+  ASSERT_EQ(summary->Size(), static_cast<int>(keys->size()));
+
+  const auto row = summary->IndexOf("9490795B78F8AFE9F93BD09281704859182661FB");
+  ASSERT_GE(row, 0);
+  ASSERT_EQ(summary->IndexOf("no such key"), -1);
+
+  const auto& key = summary->GetKey(row);
+  ASSERT_EQ(summary->GetId(row), key.GetId());
+  ASSERT_EQ(summary->GetName(row), key.GetName());
+  ASSERT_EQ(summary->GetEmail(row), "gpgfrontend@gpgfrontend.pub");
+  ASSERT_EQ(summary->GetOwnerTrustLevel(row), key.GetOwnerTrustLevel());
+  ASSERT_EQ(summary->GetCreateTime(row),
+            key.GetCreateTime().toSecsSinceEpoch());
+  ASSERT_TRUE(summary->Has(row, GpgKeyMetadata::kPrivateKey));
+
+  auto metadata = summary->GetMetadata(row);
+  auto expected = GpgKeyMetadata::FromKey(key);
+  ASSERT_EQ(metadata.fingerprint, expected.fingerprint);
+  ASSERT_EQ(metadata.algo, expected.algo);
+  ASSERT_EQ(metadata.expire_time, expected.expire_time);
+  ASSERT_EQ(metadata.flags, expected.flags);
+
+  // every row once, ordered by the column
+  auto rows = summary->SortedRows(GpgKeySummaryTable::kName,
+                                  Qt::AscendingOrder);
+  ASSERT_EQ(rows.size(), summary->Size());
+  ASSERT_EQ(QSet<int>(rows.begin(), rows.end()).size(), summary->Size());
+  for (int i = 1; i < rows.size(); i++) {
+    ASSERT_LE(summary->GetName(rows[i - 1])
+                  .compare(summary->GetName(rows[i]), Qt::CaseInsensitive),
+              0);
+  }
+
+  rows = summary->SortedRows(GpgKeySummaryTable::kCreateTime,
+                             Qt::DescendingOrder);
+  for (int i = 1; i < rows.size(); i++) {
+    ASSERT_GE(summary->GetCreateTime(rows[i - 1]),
+              summary->GetCreateTime(rows[i]));
+  }
+}
+
 }  // namespace GpgFrontend::Test
\ No newline at end of file
@@ -499,4 +499,90 @@ TEST_F(GpgCoreTest, GenerateKeyED25519BRAINPOOLP256R1Test) {
   GpgKeyOpera::GetInstance(kGpgFrontendDefaultChannel).DeleteKey(fpr);
 }
 
+TEST_F(GpgCoreTest, RefreshKeysTest) {
+  auto& getter = GpgKeyGetter::GetInstance(kGpgFrontendDefaultChannel);
+  ASSERT_TRUE(getter.FlushKeyCache());
+
+  auto keygen_info = SecureCreateSharedObject<GenKeyInfo>();
+  keygen_info->SetName("foo_refresh");
+  keygen_info->SetEmail("refresh_bar@gpgfrontend.bktus.com");
+  keygen_info->SetAlgo(std::get<1>(keygen_info->GetSupportedKeyAlgo()[3]));
+  keygen_info->SetAllowCertification(true);
+  keygen_info->SetAllowSigning(true);
+  keygen_info->SetNonExpired(true);
+  keygen_info->SetNonPassPhrase(true);
+
+  auto [err, data_object] = GpgKeyOpera::GetInstance(kGpgFrontendDefaultChannel)
+                                .GenerateKeySync(keygen_info);
+  ASSERT_EQ(CheckGpgError(err), GPG_ERR_NO_ERROR);
+  auto fpr = ExtractParams<GpgGenerateKeyResult>(data_object, 0)
+                 .GetFingerprint();
+
+  // the new key is patched into the cache, nothing else is touched
+  auto changes = getter.RefreshKeys({fpr});
+  ASSERT_EQ(changes.added, QStringList{fpr});
+  ASSERT_TRUE(changes.updated.isEmpty());
+  ASSERT_TRUE(changes.removed.isEmpty());
+  ASSERT_EQ(getter.FetchKey()->back().GetFingerprint(), fpr);
+
+  changes = getter.RefreshKeys({fpr});
+  ASSERT_EQ(changes.updated, QStringList{fpr});
+
+  GpgKeyOpera::GetInstance(kGpgFrontendDefaultChannel).DeleteKey(fpr);
+
+  // a key id of the deleted key is enough to drop it from the cache
+  changes = getter.RefreshKeys({fpr.right(16)});
+  ASSERT_EQ(changes.removed, QStringList{fpr});
+  ASSERT_TRUE(changes.added.isEmpty());
+  ASSERT_TRUE(changes.updated.isEmpty());
+
+  for (const auto& key : *getter.FetchKey()) {
+    ASSERT_NE(key.GetFingerprint(), fpr);
+  }
+}
+
+TEST_F(GpgCoreTest, ReconcileKeysTest) {
+  auto& getter = GpgKeyGetter::GetInstance(kGpgFrontendDefaultChannel);
+  ASSERT_TRUE(getter.FlushKeyCache());
+
+  // nothing changed since the listing
+  auto snapshot = getter.FetchKey();
+  ASSERT_TRUE(getter.ReconcileKeys().Empty());
+  ASSERT_EQ(getter.FetchKey().get(), snapshot.get());
+
+  auto keygen_info = SecureCreateSharedObject<GenKeyInfo>();
+  keygen_info->SetName("foo_reconcile");
+  keygen_info->SetEmail("reconcile_bar@gpgfrontend.bktus.com");
+  keygen_info->SetAlgo(std::get<1>(keygen_info->GetSupportedKeyAlgo()[3]));
+  keygen_info->SetAllowCertification(true);
+  keygen_info->SetAllowSigning(true);
+  keygen_info->SetNonExpired(true);
+  keygen_info->SetNonPassPhrase(true);
+
+  auto [err, data_object] = GpgKeyOpera::GetInstance(kGpgFrontendDefaultChannel)
+                                .GenerateKeySync(keygen_info);
+  ASSERT_EQ(CheckGpgError(err), GPG_ERR_NO_ERROR);
+  auto fpr = ExtractParams<GpgGenerateKeyResult>(data_object, 0)
+                 .GetFingerprint();
+
+  // a key the cache was not told about is found without knowing its id
+  auto changes = getter.ReconcileKeys();
+  ASSERT_EQ(changes.added, QStringList{fpr});
+  ASSERT_TRUE(changes.updated.isEmpty());
+  ASSERT_TRUE(changes.removed.isEmpty());
+
+  // the keygrip of the secret key file finds the key as well
+  auto key = getter.GetKey(fpr);
+  auto keygrip = key.GetSubKeys()->front().GetKeyGrip();
+  ASSERT_FALSE(keygrip.isEmpty());
+  ASSERT_EQ(getter.GetKey("&" + keygrip).GetFingerprint(), fpr);
+
+  GpgKeyOpera::GetInstance(kGpgFrontendDefaultChannel).DeleteKey(fpr);
+
+  changes = getter.ReconcileKeys();
+  ASSERT_EQ(changes.removed, QStringList{fpr});
+  ASSERT_TRUE(changes.added.isEmpty());
+  ASSERT_TRUE(changes.updated.isEmpty());
+}
+
 }  // namespace GpgFrontend::Test
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include "core/function/gpg/GpgKeyGetter.h"
 #include "ui/widgets/InfoBoardWidget.h"
 
 namespace GpgFrontend {
@@ -65,6 +66,19 @@ class UISignalStation : public QObject {
    */
   void SignalKeyDatabaseRefreshDone();
 
+  /**
+   * @brief list only the given keys again instead of the whole keyring
+   *
+   * @param key_ids key ids or fingerprints
+   */
+  void SignalKeyDatabaseRefreshKeys(QStringList key_ids);
+
+  /**
+   * @brief emit after a targeted refresh, with the keys it touched
+   *
+   */
+  void SignalKeyDatabaseChanged(const GpgKeyCacheChanges& changes);
+
   /**
    * @brief
    *
@@ -32,12 +32,15 @@
 
 #include "core/GpgConstants.h"
 #include "core/function/CoreSignalStation.h"
+#include "core/function/gpg/GpgContext.h"
 #include "core/function/gpg/GpgKeyGetter.h"
+#include "core/model/DataObject.h"
 #include "core/model/GpgImportInformation.h"
 #include "core/module/ModuleManager.h"
 #include "core/thread/Task.h"
 #include "core/thread/TaskRunnerGetter.h"
 #include "core/typedef/GpgTypedef.h"
+#include "core/utils/AsyncUtils.h"
 #include "core/utils/GpgUtils.h"
 #include "core/utils/IOUtils.h"
 #include "thread/KeyServerImportTask.h"
@@ -45,6 +48,7 @@
 #include "ui/dialog/WaitingDialog.h"
 #include "ui/dialog/gnupg/GnuPGControllerDialog.h"
 #include "ui/dialog/import_export/KeyServerImportDialog.h"
+#include "ui/function/KeyDatabaseWatcher.h"
 #include "ui/struct/CacheObject.h"
 #include "ui/struct/SettingsObject.h"
 #include "ui/struct/settings/KeyServerSO.h"
@@ -157,6 +161,9 @@ CommonUtils::CommonUtils() : QWidget(nullptr) {
   connect(CoreSignalStation::GetInstance(),
           &CoreSignalStation::SignalBadGnupgEnv, this,
           &CommonUtils::SignalBadGnupgEnv);
+  connect(CoreSignalStation::GetInstance(),
+          &CoreSignalStation::SignalGoodGnupgEnv, this,
+          &CommonUtils::SlotWatchKeyDatabase);
   connect(this, &CommonUtils::SignalKeyStatusUpdated,
           UISignalStation::GetInstance(),
           &UISignalStation::SignalKeyDatabaseRefresh);
@@ -170,6 +177,9 @@ CommonUtils::CommonUtils() : QWidget(nullptr) {
   connect(UISignalStation::GetInstance(),
           &UISignalStation::SignalKeyDatabaseRefresh, this,
           &CommonUtils::slot_update_key_status);
+  connect(UISignalStation::GetInstance(),
+          &UISignalStation::SignalKeyDatabaseRefreshKeys, this,
+          &CommonUtils::slot_refresh_keys);
 
   connect(this, &CommonUtils::SignalRestartApplication,
           UISignalStation::GetInstance(),
@@ -221,6 +231,16 @@ CommonUtils::CommonUtils() : QWidget(nullptr) {
 void CommonUtils::WaitForOpera(QWidget *parent,
                                const QString &waiting_dialog_title,
                                const OperaWaitingCb &opera) {
+  WaitForOperaTask(parent, waiting_dialog_title,
+                   [&opera](const OperaWaitingHd &op_hd) {
+                     opera(op_hd);
+                     return Thread::Task::TaskHandler(nullptr);
+                   });
+}
+
+void CommonUtils::WaitForOperaTask(QWidget *parent,
+                                   const QString &waiting_dialog_title,
+                                   const OperaWaitingTaskCb &opera) {
   QEventLoop looper;
   QPointer<WaitingDialog> const dialog =
       new WaitingDialog(waiting_dialog_title, parent);
@@ -229,7 +249,7 @@ void CommonUtils::WaitForOpera(QWidget *parent,
   dialog->show();
 
   QTimer::singleShot(64, parent, [=]() {
-    opera([dialog]() {
+    auto handler = opera([dialog]() {
       if (dialog != nullptr) {
         GF_UI_LOG_DEBUG("called operating waiting cb, dialog: {}",
                         static_cast<void *>(dialog));
@@ -237,11 +257,52 @@ void CommonUtils::WaitForOpera(QWidget *parent,
         dialog->accept();
       }
     });
+
+    auto *task = handler.GetTask();
+    if (task != nullptr && dialog != nullptr) {
+      connect(task, &Thread::Task::SignalTaskProgress, dialog,
+              &WaitingDialog::SlotUpdateProgress);
+
+      // the callback of the operation still runs and closes the dialog
+      dialog->SetCancelable(true);
+      connect(dialog, &WaitingDialog::SignalCancel, dialog,
+              [handler]() mutable { handler.Cancel(); });
+    }
   });
 
   looper.exec();
 }
 
+void CommonUtils::WaitForTextOpera(QWidget *parent,
+                                   const QString &waiting_dialog_title,
+                                   const QString &text,
+                                   const OperaWaitingTextCb &opera) {
+  auto p_parent = QPointer<QWidget>(parent);
+  WaitForOpera(
+      parent, waiting_dialog_title,
+      [p_parent, text, opera](const OperaWaitingHd &op_hd) {
+        // encoding a large text takes long, keep it off the UI thread
+        RunOperaAsync(
+            [text](const DataObjectPtr &data_object) -> GFError {
+              data_object->Swap({GFBuffer(text)});
+              return 0;
+            },
+            [p_parent, op_hd, opera](GFError,
+                                     const DataObjectPtr &data_object) {
+              if (data_object == nullptr || !data_object->Check<GFBuffer>()) {
+                GF_UI_LOG_ERROR("cannot encode the text of the operation");
+                op_hd();
+                QMessageBox::critical(
+                    p_parent, tr("Failure"),
+                    tr("The text could not be prepared for the operation."));
+                return;
+              }
+              opera(op_hd, ExtractParams<GFBuffer>(data_object, 0));
+            },
+            "encode_text_utf8");
+      });
+}
+
 void CommonUtils::RaiseMessageBox(QWidget *parent, GpgError err) {
   GpgErrorDesc desc = DescribeGpgErrCode(err);
   GpgErrorCode err_code = CheckGpgError2ErrCode(err);
@@ -269,7 +330,10 @@ void CommonUtils::RaiseFailureMessageBox(QWidget *parent, GpgError err) {
 void CommonUtils::SlotImportKeys(QWidget *parent, const QString &in_buffer) {
   auto info =
       GpgKeyImportExporter::GetInstance().ImportKey(GFBuffer(in_buffer));
-  emit SignalKeyStatusUpdated();
+  if (info != nullptr) {
+    emit UISignalStation::GetInstance()->SignalKeyDatabaseRefreshKeys(
+        info->GetImportedKeyFprs());
+  }
 
   (new KeyImportDetailDialog(info, parent));
 }
@@ -483,12 +547,107 @@ void CommonUtils::slot_update_key_status() {
       "update_key_database_task");
   connect(refresh_task, &Thread::Task::SignalTaskEnd, this,
           &CommonUtils::SignalKeyDatabaseRefreshDone);
+  // what is written from now on is seen by the watcher, only the trustdb
+  // the listing itself may update is taken as known afterwards
+  if (key_database_watcher_ != nullptr) key_database_watcher_->SlotRebase();
+  connect(refresh_task, &Thread::Task::SignalTaskEnd, this, [this]() {
+    if (key_database_watcher_ != nullptr) {
+      key_database_watcher_->SlotRebaseTrustDB();
+    }
+  });
 
   // post the task to the default task runner
   Thread::TaskRunnerGetter::GetInstance().GetTaskRunner()->PostTask(
       refresh_task);
 }
 
+void CommonUtils::slot_refresh_keys(const QStringList &key_ids) {
+  // our own write is done, take the state of now as known rather than the
+  // one after the refresh, so a write made meanwhile by another process is
+  // still reported
+  if (key_database_watcher_ != nullptr) key_database_watcher_->SlotRebase();
+  refresh_keys(key_ids);
+}
+
+void CommonUtils::refresh_keys(const QStringList &key_ids) {
+  if (key_ids.isEmpty()) return;
+
+  const KeyIdArgsList ids(key_ids.begin(), key_ids.end());
+  RunOperaAsync(
+      [ids](const DataObjectPtr &data_object) -> GFError {
+        GpgKeyCacheChanges changes;
+        // patch the key cache of all GpgKeyGetter Intances.
+        for (const auto &channel_id : GpgKeyGetter::GetAllChannelId()) {
+          auto channel_changes =
+              GpgKeyGetter::GetInstance(channel_id).RefreshKeys(ids);
+          if (channel_id == kGpgFrontendDefaultChannel) {
+            changes = channel_changes;
+          }
+        }
+        data_object->Swap({changes});
+        return 0;
+      },
+      [this](GFError, const DataObjectPtr &data_object) {
+        // the listing itself may have updated the trustdb
+        if (key_database_watcher_ != nullptr) {
+          key_database_watcher_->SlotRebaseTrustDB();
+        }
+
+        if (data_object == nullptr ||
+            !data_object->Check<GpgKeyCacheChanges>()) {
+          return;
+        }
+
+        auto changes = ExtractParams<GpgKeyCacheChanges>(data_object, 0);
+        if (changes.Empty()) return;
+        emit UISignalStation::GetInstance()->SignalKeyDatabaseChanged(changes);
+      },
+      "refresh_keys_task");
+}
+
+void CommonUtils::slot_reconcile_keys() {
+  RunOperaAsync(
+      [](const DataObjectPtr &data_object) -> GFError {
+        // only the key database of the default channel is watched
+        auto changes = GpgKeyGetter::GetInstance().ReconcileKeys();
+        data_object->Swap({changes});
+        return 0;
+      },
+      [this](GFError, const DataObjectPtr &data_object) {
+        // gpg may have touched the trustdb while listing
+        if (key_database_watcher_ != nullptr) {
+          key_database_watcher_->SlotRebaseTrustDB();
+        }
+
+        if (data_object == nullptr ||
+            !data_object->Check<GpgKeyCacheChanges>()) {
+          return;
+        }
+
+        auto changes = ExtractParams<GpgKeyCacheChanges>(data_object, 0);
+        if (changes.Empty()) return;
+        emit UISignalStation::GetInstance()->SignalKeyDatabaseChanged(changes);
+      },
+      "reconcile_keys_task");
+}
+
+void CommonUtils::SlotWatchKeyDatabase() {
+  // the core may be initialized again with another key database
+  delete key_database_watcher_;
+
+  key_database_watcher_ = new KeyDatabaseWatcher(
+      GpgContext::GetInstance().GetDatabasePath(), this);
+  connect(key_database_watcher_, &KeyDatabaseWatcher::SignalSecretKeysChanged,
+          this, &CommonUtils::refresh_keys);
+  connect(key_database_watcher_, &KeyDatabaseWatcher::SignalKeyringChanged,
+          this, &CommonUtils::slot_reconcile_keys);
+
+  // the trustdb updates done by our own operations aren't news
+  connect(CoreSignalStation::GetInstance(),
+          &CoreSignalStation::SignalGpgOperationFinished,
+          key_database_watcher_, &KeyDatabaseWatcher::SlotRebaseTrustDB);
+}
+
 void CommonUtils::slot_update_key_from_server_finished(
     bool success, QString err_msg, QByteArray buffer,
     std::shared_ptr<GpgImportInformation> info) {
@@ -498,8 +657,9 @@ void CommonUtils::slot_update_key_from_server_finished(
     return;
   }
 
-  // refresh the key database
-  emit UISignalStation::GetInstance()->SignalKeyDatabaseRefresh();
+  // refresh the imported keys
+  emit UISignalStation::GetInstance()->SignalKeyDatabaseRefreshKeys(
+      info->GetImportedKeyFprs());
 
   // show details
   (new KeyImportDetailDialog(std::move(info), this))->exec();
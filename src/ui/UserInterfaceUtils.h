@@ -29,6 +29,7 @@
 #pragma once
 
 #include "core/function/result_analyse/GpgVerifyResultAnalyse.h"
+#include "core/model/GFBuffer.h"
 #include "core/model/GpgKey.h"
 #include "core/thread/Task.h"
 #include "core/typedef/GpgTypedef.h"
@@ -42,9 +43,14 @@ namespace GpgFrontend::UI {
 
 class InfoBoardWidget;
 class TextEdit;
+class KeyDatabaseWatcher;
 
 using OperaWaitingHd = std::function<void()>;
 using OperaWaitingCb = const std::function<void(OperaWaitingHd)>;
+using OperaWaitingTaskCb =
+    const std::function<Thread::Task::TaskHandler(OperaWaitingHd)>;
+using OperaWaitingTextCb =
+    const std::function<void(OperaWaitingHd, const GFBuffer&)>;
 
 /**
  * @brief
@@ -145,6 +151,24 @@ class CommonUtils : public QWidget {
   static void WaitForOpera(QWidget* parent, const QString&,
                            const OperaWaitingCb&);
 
+  /**
+   * @brief same as WaitForOpera, but the waiting dialog also shows the
+   * progress reported by the task returned from the operation
+   *
+   * @param parent
+   */
+  static void WaitForOperaTask(QWidget* parent, const QString&,
+                               const OperaWaitingTaskCb&);
+
+  /**
+   * @brief same as WaitForOpera, the text is encoded to UTF-8 on a worker
+   * thread first and the operation gets the encoded buffer
+   *
+   * @param parent
+   */
+  static void WaitForTextOpera(QWidget* parent, const QString&,
+                               const QString& text, const OperaWaitingTextCb&);
+
   /**
    * @brief
    *
@@ -280,6 +304,13 @@ class CommonUtils : public QWidget {
    */
   void SlotRestartApplication(int);
 
+  /**
+   * @brief watch the key database of the default channel for changes made
+   * by other processes
+   *
+   */
+  void SlotWatchKeyDatabase();
+
  private slots:
 
   /**
@@ -288,6 +319,19 @@ class CommonUtils : public QWidget {
    */
   void slot_update_key_status();
 
+  /**
+   * @brief after a write of this process, take the key database as known
+   * and refresh the keys it changed
+   *
+   */
+  void slot_refresh_keys(const QStringList& key_ids);
+
+  /**
+   * @brief list all the keys again and tell which of them changed
+   *
+   */
+  void slot_reconcile_keys();
+
   /**
    * @brief
    *
@@ -298,6 +342,13 @@ class CommonUtils : public QWidget {
  private:
   static std::unique_ptr<CommonUtils> instance_;  ///<
   bool application_need_to_restart_at_once_ = false;
+  KeyDatabaseWatcher* key_database_watcher_ = nullptr;  ///<
+
+  /**
+   * @brief list only the given keys again and tell what changed
+   *
+   */
+  void refresh_keys(const QStringList& key_ids);
 };
 
 }  // namespace GpgFrontend::UI
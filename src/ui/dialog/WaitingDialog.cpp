@@ -33,14 +33,23 @@
 namespace GpgFrontend::UI {
 
 WaitingDialog::WaitingDialog(const QString& title, QWidget* parent)
-    : GeneralDialog("WaitingDialog", parent) {
-  auto* pb = new QProgressBar();
-  pb->setRange(0, 0);
-  pb->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
-  pb->setTextVisible(false);
+    : GeneralDialog("WaitingDialog", parent), title_(title) {
+  pb_ = new QProgressBar();
+  pb_->setRange(0, 0);
+  pb_->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
+  pb_->setTextVisible(false);
+
+  cancel_button_ = new QPushButton(tr("Cancel"));
+  cancel_button_->setVisible(false);
+  connect(cancel_button_, &QPushButton::clicked, this, [=]() {
+    cancel_button_->setEnabled(false);
+    this->setWindowTitle(tr("Cancelling..."));
+    emit SignalCancel();
+  });
 
   auto* layout = new QVBoxLayout();
-  layout->addWidget(pb);
+  layout->addWidget(pb_);
+  layout->addWidget(cancel_button_, 0, Qt::AlignRight);
   this->setLayout(layout);
 
   this->setModal(true);
@@ -54,4 +63,29 @@ WaitingDialog::WaitingDialog(const QString& title, QWidget* parent)
   this->show();
 }
 
+void WaitingDialog::SetCancelable(bool cancelable) {
+  cancel_button_->setVisible(cancelable);
+  this->setFixedSize(240, cancelable ? 80 : 42);
+}
+
+void WaitingDialog::SlotUpdateProgress(qint64 processed, qint64 total,
+                                       double speed) {
+  const auto speed_text =
+      QLocale().formattedDataSize(static_cast<qint64>(speed)) + "/s";
+
+  // keep the title once the user asked to cancel
+  if (!cancel_button_->isEnabled()) return;
+
+  // unknown total, keep the busy indicator and show the speed only
+  if (total <= 0) {
+    this->setWindowTitle(title_ + " (" + speed_text + ")");
+    return;
+  }
+
+  pb_->setRange(0, 1000);
+  pb_->setValue(static_cast<int>(std::min(processed, total) * 1000 / total));
+  pb_->setFormat(QString("%p% (%1)").arg(speed_text));
+  pb_->setTextVisible(true);
+}
+
 }  // namespace GpgFrontend::UI
@@ -47,6 +47,38 @@ class WaitingDialog : public GeneralDialog {
    * @param parent
    */
   WaitingDialog(const QString& title, QWidget* parent);
+
+  /**
+   * @brief show a cancel button which emits SignalCancel
+   *
+   * @param cancelable
+   */
+  void SetCancelable(bool cancelable);
+
+ signals:
+
+  /**
+   * @brief the user asked to cancel the operation
+   *
+   */
+  void SignalCancel();
+
+ public slots:
+
+  /**
+   * @brief show the progress reported by a task, see
+   * Thread::Task::SignalTaskProgress
+   *
+   * @param processed
+   * @param total
+   * @param speed
+   */
+  void SlotUpdateProgress(qint64 processed, qint64 total, double speed);
+
+ private:
+  QProgressBar* pb_;             ///<
+  QPushButton* cancel_button_;  ///<
+  QString title_;               ///<
 };
 
 }  // namespace GpgFrontend::UI
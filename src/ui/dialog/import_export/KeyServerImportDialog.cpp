@@ -33,6 +33,7 @@
 #include "core/GpgModel.h"
 #include "core/function/GlobalSettingStation.h"
 #include "core/function/gpg/GpgKeyImportExporter.h"
+#include "core/model/GpgImportInformation.h"
 #include "ui/UISignalStation.h"
 #include "ui/struct/SettingsObject.h"
 #include "ui/struct/settings/KeyServerSO.h"
@@ -116,10 +117,6 @@ KeyServerImportDialog::KeyServerImportDialog(QWidget* parent)
   this->setModal(true);
 
   movePosition2CenterOfParent();
-
-  connect(this, &KeyServerImportDialog::SignalKeyImported,
-          UISignalStation::GetInstance(),
-          &UISignalStation::SignalKeyDatabaseRefresh);
 }
 
 auto KeyServerImportDialog::create_combo_box() -> QComboBox* {
@@ -418,8 +415,12 @@ void KeyServerImportDialog::slot_import_finished(
 
   set_message(tr("Key Imported"), false);
 
-  // refresh the key database
+  // refresh the imported keys
   emit SignalKeyImported();
+  if (info != nullptr) {
+    emit UISignalStation::GetInstance()->SignalKeyDatabaseRefreshKeys(
+        info->GetImportedKeyFprs());
+  }
 
   // show details
   (new KeyImportDetailDialog(std::move(info), this))->exec();
@@ -292,7 +292,7 @@ void SubkeyGenerateDialog::slot_key_gen_accept() {
          gen_key_info = this->gen_key_info_](const OperaWaitingHd& hd) {
           GpgKeyOpera::GetInstance().GenerateSubkey(
               key, gen_key_info,
-              [this, hd](GpgError err, const DataObjectPtr&) {
+              [this, hd, key](GpgError err, const DataObjectPtr&) {
                 // stop showing waiting dialog
                 hd();
 
@@ -305,7 +305,7 @@ void SubkeyGenerateDialog::slot_key_gen_accept() {
                 CommonUtils::RaiseMessageBox(this, err);
                 if (CheckGpgError(err) == GPG_ERR_NO_ERROR) {
                   emit UISignalStation::GetInstance()
-                      ->SignalKeyDatabaseRefresh();
+                      ->SignalKeyDatabaseRefreshKeys({key.GetFingerprint()});
                 }
               });
         });
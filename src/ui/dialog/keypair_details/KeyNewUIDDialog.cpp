@@ -69,9 +69,10 @@ KeyNewUIDDialog::KeyNewUIDDialog(const KeyId& key_id, QWidget* parent)
   this->setAttribute(Qt::WA_DeleteOnClose, true);
   this->setModal(true);
 
-  connect(this, &KeyNewUIDDialog::SignalUIDCreated,
-          UISignalStation::GetInstance(),
-          &UISignalStation::SignalKeyDatabaseRefresh);
+  connect(this, &KeyNewUIDDialog::SignalUIDCreated, this, [=]() {
+    emit UISignalStation::GetInstance()->SignalKeyDatabaseRefreshKeys(
+        {m_key_.GetFingerprint()});
+  });
 }
 
 void KeyNewUIDDialog::slot_create_new_uid() {
@@ -157,6 +157,11 @@ KeyPairDetailTab::KeyPairDetailTab(const QString& key_id, QWidget* parent)
   connect(UISignalStation::GetInstance(),
           &UISignalStation::SignalKeyDatabaseRefreshDone, this,
           &KeyPairDetailTab::slot_refresh_key);
+  connect(UISignalStation::GetInstance(),
+          &UISignalStation::SignalKeyDatabaseChanged, this,
+          [=](const GpgKeyCacheChanges& changes) {
+            if (changes.Contains(key_.GetFingerprint())) slot_refresh_key();
+          });
 
   slot_refresh_key_info();
   setAttribute(Qt::WA_DeleteOnClose, true);
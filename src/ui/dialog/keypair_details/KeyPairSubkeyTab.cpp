@@ -128,6 +128,13 @@ KeyPairSubkeyTab::KeyPairSubkeyTab(const QString& key_id, QWidget* parent)
   connect(UISignalStation::GetInstance(),
           &UISignalStation::SignalKeyDatabaseRefreshDone, this,
           &KeyPairSubkeyTab::slot_refresh_subkey_list);
+  connect(UISignalStation::GetInstance(),
+          &UISignalStation::SignalKeyDatabaseChanged, this,
+          [=](const GpgKeyCacheChanges& changes) {
+            if (!changes.Contains(key_.GetFingerprint())) return;
+            slot_refresh_key_info();
+            slot_refresh_subkey_list();
+          });
 
   base_layout->setContentsMargins(0, 0, 0, 0);
 
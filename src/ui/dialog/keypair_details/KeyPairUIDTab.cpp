@@ -38,7 +38,8 @@
 namespace GpgFrontend::UI {
 
 KeyPairUIDTab::KeyPairUIDTab(const QString& key_id, QWidget* parent)
-    : QWidget(parent), m_key_(GpgKeyGetter::GetInstance().GetKey(key_id)) {
+    : QWidget(parent),
+      m_key_(GpgKeyGetter::GetInstance().GetKeyDetail(key_id)) {
   create_uid_list();
   create_sign_list();
   create_manage_uid_menu();
@@ -107,10 +108,17 @@ KeyPairUIDTab::KeyPairUIDTab(const QString& key_id, QWidget* parent)
   connect(UISignalStation::GetInstance(),
           &UISignalStation::SignalKeyDatabaseRefreshDone, this,
           &KeyPairUIDTab::slot_refresh_key);
+  connect(UISignalStation::GetInstance(),
+          &UISignalStation::SignalKeyDatabaseChanged, this,
+          [=](const GpgKeyCacheChanges& changes) {
+            if (changes.Contains(m_key_.GetFingerprint())) slot_refresh_key();
+          });
 
-  connect(this, &KeyPairUIDTab::SignalUpdateUIDInfo,
-          UISignalStation::GetInstance(),
-          &UISignalStation::SignalKeyDatabaseRefresh);
+  // only this key needs to be listed again
+  connect(this, &KeyPairUIDTab::SignalUpdateUIDInfo, this, [=]() {
+    emit UISignalStation::GetInstance()->SignalKeyDatabaseRefreshKeys(
+        {m_key_.GetFingerprint()});
+  });
 
   setLayout(vbox_layout);
   setAttribute(Qt::WA_DeleteOnClose, true);
@@ -574,8 +582,9 @@ void KeyPairUIDTab::slot_del_sign() {
   }
 }
 void KeyPairUIDTab::slot_refresh_key() {
-  // refresh the key
-  GpgKey refreshed_key = GpgKeyGetter::GetInstance().GetKey(m_key_.GetId());
+  // refresh the key, signatures and tofu information are listed on demand
+  GpgKey refreshed_key =
+      GpgKeyGetter::GetInstance().GetKeyDetail(m_key_.GetId());
   std::swap(this->m_key_, refreshed_key);
 
   this->slot_refresh_uid_list();
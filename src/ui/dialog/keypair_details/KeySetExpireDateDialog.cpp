@@ -122,9 +122,11 @@ void KeySetExpireDateDialog::init() {
           &KeySetExpireDateDialog::slot_non_expired_checked);
   connect(ui_->button_box_, &QDialogButtonBox::accepted, this,
           &KeySetExpireDateDialog::slot_confirm);
-  connect(this, &KeySetExpireDateDialog::SignalKeyExpireDateUpdated,
-          UISignalStation::GetInstance(),
-          &UISignalStation::SignalKeyDatabaseRefresh);
+  connect(this, &KeySetExpireDateDialog::SignalKeyExpireDateUpdated, this,
+          [=]() {
+            emit UISignalStation::GetInstance()->SignalKeyDatabaseRefreshKeys(
+                {m_key_.GetFingerprint()});
+          });
 
   if (m_key_.GetExpireTime().toSecsSinceEpoch() == 0) {
     ui_->noExpirationCheckBox->setCheckState(Qt::Checked);
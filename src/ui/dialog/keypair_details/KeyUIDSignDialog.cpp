@@ -92,9 +92,10 @@ KeyUIDSignDialog::KeyUIDSignDialog(const GpgKey& key, UIDArgsListPtr uid,
 
   setAttribute(Qt::WA_DeleteOnClose, true);
 
-  connect(this, &KeyUIDSignDialog::SignalKeyUIDSignUpdate,
-          UISignalStation::GetInstance(),
-          &UISignalStation::SignalKeyDatabaseRefresh);
+  connect(this, &KeyUIDSignDialog::SignalKeyUIDSignUpdate, this, [=]() {
+    emit UISignalStation::GetInstance()->SignalKeyDatabaseRefreshKeys(
+        {m_key_.GetFingerprint()});
+  });
 }
 
 void KeyUIDSignDialog::slot_sign_key(bool clicked) {
@@ -0,0 +1,168 @@
+/**
+ * Copyright (C) 2021 Saturneric <eric@bktus.com>
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric <eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include "KeyDatabaseWatcher.h"
+
+namespace GpgFrontend::UI {
+
+// gpg, gpg-agent and keyboxd often write several times for one change
+constexpr int kKeyDatabaseQuietPeriod = 1000;
+
+constexpr auto kSecretKeysDir = "private-keys-v1.d";
+
+// the files any key or its uids are stored in
+const std::initializer_list<const char*> kKeyringFiles = {
+    "pubring.kbx",
+    "pubring.gpg",
+    "public-keys.d/pubring.db",
+    "public-keys.d/pubring.db-wal",
+};
+
+// gpg also rewrites it while running operations of this process
+const std::initializer_list<const char*> kTrustDBFiles = {
+    "trustdb.gpg",
+};
+
+KeyDatabaseWatcher::KeyDatabaseWatcher(QString db_path, QObject* parent)
+    : QObject(parent),
+      db_path_(std::move(db_path)),
+      watcher_(new QFileSystemWatcher(this)),
+      debounce_timer_(new QTimer(this)) {
+  debounce_timer_->setSingleShot(true);
+  debounce_timer_->setInterval(kKeyDatabaseQuietPeriod);
+
+  connect(watcher_, &QFileSystemWatcher::fileChanged, this,
+          &KeyDatabaseWatcher::slot_path_changed);
+  connect(watcher_, &QFileSystemWatcher::directoryChanged, this,
+          &KeyDatabaseWatcher::slot_path_changed);
+  connect(debounce_timer_, &QTimer::timeout, this,
+          &KeyDatabaseWatcher::slot_check);
+
+  watch_paths();
+  SlotRebase();
+  GF_UI_LOG_DEBUG("watching key database: {}", db_path_);
+}
+
+void KeyDatabaseWatcher::SlotRebase() {
+  keyring_state_ = read_files_state(kKeyringFiles);
+  trustdb_state_ = read_files_state(kTrustDBFiles);
+  secret_key_files_ = read_secret_key_files();
+}
+
+void KeyDatabaseWatcher::SlotRebaseTrustDB() {
+  trustdb_state_ = read_files_state(kTrustDBFiles);
+}
+
+void KeyDatabaseWatcher::slot_path_changed() {
+  watch_paths();
+  debounce_timer_->start();
+}
+
+void KeyDatabaseWatcher::slot_check() {
+  auto secret_key_files = read_secret_key_files();
+
+  // neither a keyring nor a trustdb write can be mapped to the keys it
+  // touched, so list every key, which covers the secret keys too
+  if (read_files_state(kKeyringFiles) != keyring_state_ ||
+      read_files_state(kTrustDBFiles) != trustdb_state_) {
+    SlotRebase();
+    GF_UI_LOG_DEBUG("keyring changed outside, database: {}", db_path_);
+    emit SignalKeyringChanged();
+    return;
+  }
+
+  QStringList patterns;
+  for (auto it = secret_key_files.cbegin(); it != secret_key_files.cend();
+       ++it) {
+    if (secret_key_files_.value(it.key(), -1) != it.value()) {
+      patterns.append("&" + it.key());
+    }
+  }
+  for (auto it = secret_key_files_.cbegin(); it != secret_key_files_.cend();
+       ++it) {
+    if (!secret_key_files.contains(it.key())) patterns.append("&" + it.key());
+  }
+
+  secret_key_files_ = secret_key_files;
+  if (patterns.isEmpty()) return;
+
+  GF_UI_LOG_DEBUG("secret keys changed outside, keygrips: {}",
+                  patterns.size());
+  emit SignalSecretKeysChanged(patterns);
+}
+
+void KeyDatabaseWatcher::watch_paths() {
+  QStringList paths;
+  paths.append(db_path_);
+
+  const QDir db_dir(db_path_);
+  paths.append(db_dir.filePath(kSecretKeysDir));
+  paths.append(db_dir.filePath("public-keys.d"));
+  for (const auto& files : {kKeyringFiles, kTrustDBFiles}) {
+    for (const auto* file : files) paths.append(db_dir.filePath(file));
+  }
+
+  const auto watched = watcher_->files() + watcher_->directories();
+  for (const auto& path : paths) {
+    if (!watched.contains(path) && QFileInfo::exists(path)) {
+      watcher_->addPath(path);
+    }
+  }
+}
+
+auto KeyDatabaseWatcher::read_files_state(
+    const std::initializer_list<const char*>& files) const -> QByteArray {
+  QByteArray state;
+  const QDir db_dir(db_path_);
+  for (const auto* file : files) {
+    QFileInfo info(db_dir.filePath(file));
+    state.append(QString("%1:%2:%3;")
+                     .arg(file)
+                     .arg(info.exists() ? info.size() : -1)
+                     .arg(info.exists()
+                              ? info.lastModified().toMSecsSinceEpoch()
+                              : -1)
+                     .toUtf8());
+  }
+  return state;
+}
+
+auto KeyDatabaseWatcher::read_secret_key_files() const
+    -> QHash<QString, qint64> {
+  QHash<QString, qint64> files;
+
+  const QDir dir(QDir(db_path_).filePath(kSecretKeysDir));
+  for (const auto& info :
+       dir.entryInfoList({"*.key"}, QDir::Files | QDir::NoDotAndDotDot)) {
+    files.insert(info.completeBaseName().toUpper(),
+                 info.lastModified().toMSecsSinceEpoch());
+  }
+  return files;
+}
+
+}  // namespace GpgFrontend::UI
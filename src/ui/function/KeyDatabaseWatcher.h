@@ -0,0 +1,133 @@
+/**
+ * Copyright (C) 2021 Saturneric <eric@bktus.com>
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric <eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#pragma once
+
+#include "GpgFrontendUI.h"
+
+namespace GpgFrontend::UI {
+
+/**
+ * @brief watches the key database for changes made by other processes,
+ * a burst of writes is reported once after it settles.
+ *
+ * Only a change of the secret key files can be mapped to the keys it
+ * touched. A keyring or trustdb write is reported as a whole and every key
+ * is listed again, even when only the trustdb changed: gpgme has no way to
+ * ask for the validities alone.
+ *
+ */
+class KeyDatabaseWatcher : public QObject {
+  Q_OBJECT
+ public:
+  /**
+   * @brief Construct a new Key Database Watcher object
+   *
+   * @param db_path the gnupg home directory
+   * @param parent
+   */
+  explicit KeyDatabaseWatcher(QString db_path, QObject* parent = nullptr);
+
+ signals:
+  /**
+   * @brief only secret key files changed
+   *
+   * @param patterns keygrips of the changed files, prefixed with "&"
+   */
+  void SignalSecretKeysChanged(QStringList patterns);
+
+  /**
+   * @brief the keyring or the trustdb changed, any key may be affected and
+   * all of them have to be listed again
+   *
+   */
+  void SignalKeyringChanged();
+
+ public slots:
+  /**
+   * @brief take the current state of the files as known, once a write of
+   * this process is done and before its keys are listed again, so a write
+   * made meanwhile by another process is still reported
+   *
+   */
+  void SlotRebase();
+
+  /**
+   * @brief take the current trustdb as known, after a gpg operation of this
+   * process which may have written it. a change made by another process
+   * meanwhile is only seen with its next write.
+   *
+   */
+  void SlotRebaseTrustDB();
+
+ private slots:
+  /**
+   * @brief restart the quiet period on every write
+   *
+   */
+  void slot_path_changed();
+
+  /**
+   * @brief compare the files with the known state
+   *
+   */
+  void slot_check();
+
+ private:
+  QString db_path_;                          ///<
+  QFileSystemWatcher* watcher_;              ///<
+  QTimer* debounce_timer_;                   ///<
+  QByteArray keyring_state_;                 ///< size and mtime of the files
+  QByteArray trustdb_state_;                 ///< size and mtime of the trustdb
+  QHash<QString, qint64> secret_key_files_;  ///< file name to mtime
+
+  /**
+   * @brief add the paths which exist now, files replaced by a rename drop
+   * out of the watcher
+   *
+   */
+  void watch_paths();
+
+  /**
+   * @brief
+   *
+   * @param files relative to the database directory
+   * @return QByteArray size and mtime of the files
+   */
+  [[nodiscard]] auto read_files_state(
+      const std::initializer_list<const char*>& files) const -> QByteArray;
+
+  /**
+   * @brief
+   *
+   * @return QHash<QString, qint64>
+   */
+  [[nodiscard]] auto read_secret_key_files() const -> QHash<QString, qint64>;
+};
+
+}  // namespace GpgFrontend::UI
@@ -85,8 +85,9 @@ auto SetOwnerTrustLevel::Exec(const QString& key_id) -> bool {
       return false;
     }
 
-    // update key database and refresh ui
-    emit UISignalStation::GetInstance()->SignalKeyDatabaseRefresh();
+    // update the key and refresh ui
+    emit UISignalStation::GetInstance()->SignalKeyDatabaseRefreshKeys(
+        {key.GetFingerprint()});
     return true;
   }
 
@@ -344,8 +344,11 @@ void KeyMgmt::delete_keys_with_warning(KeyIdArgsListPtr uidList) {
       QMessageBox::No | QMessageBox::Yes);
 
   if (ret == QMessageBox::Yes) {
+    const QStringList key_ids(uidList->begin(), uidList->end());
     GpgKeyOpera::GetInstance().DeleteKeys(std::move(uidList));
-    emit SignalKeyStatusUpdated();
+
+    // the deleted keys are dropped from the cache
+    emit UISignalStation::GetInstance()->SignalKeyDatabaseRefreshKeys(key_ids);
   }
 }
 
@@ -594,7 +597,8 @@ void KeyMgmt::SlotImportKeyPackage() {
               auto info = ExtractParams<GpgImportInformation>(data_obj, 0);
               if (err >= 0) {
                 emit SignalStatusBarChanged(tr("key(s) imported"));
-                emit SignalKeyStatusUpdated();
+                emit UISignalStation::GetInstance()
+                    ->SignalKeyDatabaseRefreshKeys(info.GetImportedKeyFprs());
 
                 auto* dialog = new KeyImportDetailDialog(
                     SecureCreateSharedObject<GpgImportInformation>(info), this);
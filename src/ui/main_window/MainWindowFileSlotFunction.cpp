@@ -87,14 +87,20 @@ void MainWindow::SlotFileEncrypt(const QString& path) {
         QMessageBox::Ok | QMessageBox::Cancel);
     if (ret == QMessageBox::Cancel) return;
 
-    CommonUtils::WaitForOpera(
+    CommonUtils::WaitForOperaTask(
         this, tr("Symmetrically Encrypting"), [=](const OperaWaitingHd& op_hd) {
-          GpgFileOpera::GetInstance().EncryptFileSymmetric(
+          return GpgFileOpera::GetInstance().EncryptFileSymmetric(
               path, !non_ascii_at_file_operation, out_path,
               [=](GpgError err, const DataObjectPtr& data_obj) {
                 // stop waiting
                 op_hd();
 
+                // cancelled by the user, partial outputs are removed
+                if (CheckGpgError2ErrCode(err) == GPG_ERR_CANCELED) {
+                  this->slot_refresh_current_file_view();
+                  return;
+                }
+
                 if (CheckGpgError(err) == GPG_ERR_USER_1 ||
                     data_obj == nullptr ||
                     !data_obj->Check<GpgEncryptResult>()) {
@@ -131,15 +137,21 @@ void MainWindow::SlotFileEncrypt(const QString& path) {
     }
   }
 
-  CommonUtils::WaitForOpera(
+  CommonUtils::WaitForOperaTask(
       this, tr("Encrypting"), [=](const OperaWaitingHd& op_hd) {
-        GpgFileOpera::GetInstance().EncryptFile(
+        return GpgFileOpera::GetInstance().EncryptFile(
             {p_keys->begin(), p_keys->end()}, path,
             !non_ascii_at_file_operation, out_path,
             [=](GpgError err, const DataObjectPtr& data_obj) {
               // stop waiting
               op_hd();
 
+              // cancelled by the user, partial outputs are removed
+              if (CheckGpgError2ErrCode(err) == GPG_ERR_CANCELED) {
+                this->slot_refresh_current_file_view();
+                return;
+              }
+
               if (CheckGpgError(err) == GPG_ERR_USER_1 || data_obj == nullptr ||
                   !data_obj->Check<GpgEncryptResult>()) {
                 QMessageBox::critical(this, tr("Error"),
@@ -202,15 +214,21 @@ void MainWindow::SlotDirectoryEncrypt(const QString& path) {
         QMessageBox::Ok | QMessageBox::Cancel);
     if (ret == QMessageBox::Cancel) return;
 
-    CommonUtils::WaitForOpera(
+    CommonUtils::WaitForOperaTask(
         this, tr("Archiving & Symmetrically Encrypting"),
         [=](const OperaWaitingHd& op_hd) {
-          GpgFileOpera::GetInstance().EncryptDerectorySymmetric(
+          return GpgFileOpera::GetInstance().EncryptDerectorySymmetric(
               path, !non_ascii_at_file_operation, out_path,
               [=](GpgError err, const DataObjectPtr& data_obj) {
                 // stop waiting
                 op_hd();
 
+                // cancelled by the user, partial outputs are removed
+                if (CheckGpgError2ErrCode(err) == GPG_ERR_CANCELED) {
+                  this->slot_refresh_current_file_view();
+                  return;
+                }
+
                 if (data_obj == nullptr ||
                     !data_obj->Check<GpgEncryptResult>()) {
                   QMessageBox::critical(this, tr("Error"),
@@ -246,15 +264,21 @@ void MainWindow::SlotDirectoryEncrypt(const QString& path) {
     }
   }
 
-  CommonUtils::WaitForOpera(
+  CommonUtils::WaitForOperaTask(
       this, tr("Archiving & Encrypting"), [=](const OperaWaitingHd& op_hd) {
-        GpgFileOpera::GetInstance().EncryptDirectory(
+        return GpgFileOpera::GetInstance().EncryptDirectory(
             {p_keys->begin(), p_keys->end()}, path,
             !non_ascii_at_file_operation, out_path,
             [=](GpgError err, const DataObjectPtr& data_obj) {
               // stop waiting
               op_hd();
 
+              // cancelled by the user, partial outputs are removed
+              if (CheckGpgError2ErrCode(err) == GPG_ERR_CANCELED) {
+                this->slot_refresh_current_file_view();
+                return;
+              }
+
               if (CheckGpgError(err) == GPG_ERR_USER_1 || data_obj == nullptr ||
                   !data_obj->Check<GpgEncryptResult>()) {
                 QMessageBox::critical(this, tr("Error"),
@@ -299,13 +323,19 @@ void MainWindow::SlotFileDecrypt(const QString& path) {
     return;
   }
 
-  CommonUtils::WaitForOpera(
+  CommonUtils::WaitForOperaTask(
       this, tr("Decrypting"), [=](const OperaWaitingHd& op_hd) {
-        GpgFileOpera::GetInstance().DecryptFile(
+        return GpgFileOpera::GetInstance().DecryptFile(
             path, out_path, [=](GpgError err, const DataObjectPtr& data_obj) {
               // stop waiting
               op_hd();
 
+              // cancelled by the user, partial outputs are removed
+              if (CheckGpgError2ErrCode(err) == GPG_ERR_CANCELED) {
+                this->slot_refresh_current_file_view();
+                return;
+              }
+
               if (CheckGpgError(err) == GPG_ERR_USER_1 || data_obj == nullptr ||
                   !data_obj->Check<GpgDecryptResult>()) {
                 QMessageBox::critical(this, tr("Error"),
@@ -349,13 +379,19 @@ void MainWindow::SlotArchiveDecrypt(const QString& path) {
     return;
   }
 
-  CommonUtils::WaitForOpera(
+  CommonUtils::WaitForOperaTask(
       this, tr("Decrypting & Extrating"), [=](const OperaWaitingHd& op_hd) {
-        GpgFileOpera::GetInstance().DecryptArchive(
+        return GpgFileOpera::GetInstance().DecryptArchive(
             path, out_path, [=](GpgError err, const DataObjectPtr& data_obj) {
               // stop waiting
               op_hd();
 
+              // cancelled by the user, partial outputs are removed
+              if (CheckGpgError2ErrCode(err) == GPG_ERR_CANCELED) {
+                this->slot_refresh_current_file_view();
+                return;
+              }
+
               if (CheckGpgError(err) == GPG_ERR_USER_1 || data_obj == nullptr ||
                   !data_obj->Check<GpgDecryptResult>()) {
                 QMessageBox::critical(this, tr("Error"),
@@ -422,14 +458,20 @@ void MainWindow::SlotFileSign(const QString& path) {
     if (ret == QMessageBox::Cancel) return;
   }
 
-  CommonUtils::WaitForOpera(
+  CommonUtils::WaitForOperaTask(
       this, tr("Signing"), [=](const OperaWaitingHd& op_hd) {
-        GpgFileOpera::GetInstance().SignFile(
+        return GpgFileOpera::GetInstance().SignFile(
             {keys->begin(), keys->end()}, path, !non_ascii_at_file_operation,
             sig_file_path, [=](GpgError err, const DataObjectPtr& data_obj) {
               // stop waiting
               op_hd();
 
+              // cancelled by the user, partial outputs are removed
+              if (CheckGpgError2ErrCode(err) == GPG_ERR_CANCELED) {
+                this->slot_refresh_current_file_view();
+                return;
+              }
+
               if (CheckGpgError(err) == GPG_ERR_USER_1 || data_obj == nullptr ||
                   !data_obj->Check<GpgSignResult>()) {
                 QMessageBox::critical(this, tr("Error"),
@@ -496,14 +538,20 @@ void MainWindow::SlotFileVerify(const QString& path) {
   GF_UI_LOG_DEBUG("verification data file path: {}", data_file_path);
   GF_UI_LOG_DEBUG("verification signature file path: {}", sign_file_path);
 
-  CommonUtils::WaitForOpera(
+  CommonUtils::WaitForOperaTask(
       this, tr("Verifying"), [=](const OperaWaitingHd& op_hd) {
-        GpgFileOpera::GetInstance().VerifyFile(
+        return GpgFileOpera::GetInstance().VerifyFile(
             data_file_path, sign_file_path,
             [=](GpgError err, const DataObjectPtr& data_obj) {
               // stop waiting
               op_hd();
 
+              // cancelled by the user, partial outputs are removed
+              if (CheckGpgError2ErrCode(err) == GPG_ERR_CANCELED) {
+                this->slot_refresh_current_file_view();
+                return;
+              }
+
               if (CheckGpgError(err) == GPG_ERR_USER_1 || data_obj == nullptr ||
                   !data_obj->Check<GpgVerifyResult>()) {
                 QMessageBox::critical(this, tr("Error"),
@@ -599,9 +647,9 @@ void MainWindow::SlotFileEncryptSign(const QString& path) {
   auto signer_key_ids = signers_picker->GetCheckedSigners();
   auto p_signer_keys = GpgKeyGetter::GetInstance().GetKeys(signer_key_ids);
 
-  CommonUtils::WaitForOpera(
+  CommonUtils::WaitForOperaTask(
       this, tr("Encrypting and Signing"), [=](const OperaWaitingHd& op_hd) {
-        GpgFileOpera::GetInstance().EncryptSignFile(
+        return GpgFileOpera::GetInstance().EncryptSignFile(
             {p_keys->begin(), p_keys->end()},
             {p_signer_keys->begin(), p_signer_keys->end()}, path,
             !non_ascii_at_file_operation, out_path,
@@ -609,6 +657,12 @@ void MainWindow::SlotFileEncryptSign(const QString& path) {
               // stop waiting
               op_hd();
 
+              // cancelled by the user, partial outputs are removed
+              if (CheckGpgError2ErrCode(err) == GPG_ERR_CANCELED) {
+                this->slot_refresh_current_file_view();
+                return;
+              }
+
               if (CheckGpgError(err) == GPG_ERR_USER_1 || data_obj == nullptr ||
                   !data_obj->Check<GpgEncryptResult, GpgSignResult>()) {
                 QMessageBox::critical(this, tr("Error"),
@@ -702,10 +756,10 @@ void MainWindow::SlotDirectoryEncryptSign(const QString& path) {
   auto signer_key_ids = signers_picker->GetCheckedSigners();
   auto p_signer_keys = GpgKeyGetter::GetInstance().GetKeys(signer_key_ids);
 
-  CommonUtils::WaitForOpera(
+  CommonUtils::WaitForOperaTask(
       this, tr("Archiving & Encrypting & Signing"),
       [=](const OperaWaitingHd& op_hd) {
-        GpgFileOpera::GetInstance().EncryptSignDirectory(
+        return GpgFileOpera::GetInstance().EncryptSignDirectory(
             {p_keys->begin(), p_keys->end()},
             {p_signer_keys->begin(), p_signer_keys->end()}, path,
             !non_ascii_at_file_operation, out_path,
@@ -713,6 +767,12 @@ void MainWindow::SlotDirectoryEncryptSign(const QString& path) {
               // stop waiting
               op_hd();
 
+              // cancelled by the user, partial outputs are removed
+              if (CheckGpgError2ErrCode(err) == GPG_ERR_CANCELED) {
+                this->slot_refresh_current_file_view();
+                return;
+              }
+
               if (CheckGpgError(err) == GPG_ERR_USER_1 || data_obj == nullptr ||
                   !data_obj->Check<GpgEncryptResult, GpgSignResult>()) {
                 QMessageBox::critical(this, tr("Error"),
@@ -764,13 +824,19 @@ void MainWindow::SlotFileDecryptVerify(const QString& path) {
     if (ret == QMessageBox::Cancel) return;
   }
 
-  CommonUtils::WaitForOpera(
+  CommonUtils::WaitForOperaTask(
       this, tr("Decrypting and Verifying"), [=](const OperaWaitingHd& op_hd) {
-        GpgFileOpera::GetInstance().DecryptVerifyFile(
+        return GpgFileOpera::GetInstance().DecryptVerifyFile(
             path, out_path, [=](GpgError err, const DataObjectPtr& data_obj) {
               // stop waiting
               op_hd();
 
+              // cancelled by the user, partial outputs are removed
+              if (CheckGpgError2ErrCode(err) == GPG_ERR_CANCELED) {
+                this->slot_refresh_current_file_view();
+                return;
+              }
+
               if (CheckGpgError(err) == GPG_ERR_USER_1 || data_obj == nullptr ||
                   !data_obj->Check<GpgDecryptResult, GpgVerifyResult>()) {
                 QMessageBox::critical(this, tr("Error"),
@@ -835,14 +901,20 @@ void MainWindow::SlotArchiveDecryptVerify(const QString& path) {
     if (ret == QMessageBox::Cancel) return;
   }
 
-  CommonUtils::WaitForOpera(
+  CommonUtils::WaitForOperaTask(
       this, tr("Decrypting & Verifying & Extracting"),
       [=](const OperaWaitingHd& op_hd) {
-        GpgFileOpera::GetInstance().DecryptVerifyArchive(
+        return GpgFileOpera::GetInstance().DecryptVerifyArchive(
             path, out_path, [=](GpgError err, const DataObjectPtr& data_obj) {
               // stop waiting
               op_hd();
 
+              // cancelled by the user, partial outputs are removed
+              if (CheckGpgError2ErrCode(err) == GPG_ERR_CANCELED) {
+                this->slot_refresh_current_file_view();
+                return;
+              }
+
               if (CheckGpgError(err) == GPG_ERR_USER_1 || data_obj == nullptr ||
                   !data_obj->Check<GpgDecryptResult, GpgVerifyResult>()) {
                 QMessageBox::critical(this, tr("Error"),
@@ -58,10 +58,10 @@ void MainWindow::SlotEncrypt() {
 
     if (ret == QMessageBox::Cancel) return;
 
-    auto buffer = GFBuffer(edit_->CurTextPage()->GetTextPage()->toPlainText());
-    CommonUtils::WaitForOpera(
-        this, tr("Symmetrically Encrypting"),
-        [this, buffer](const OperaWaitingHd& op_hd) {
+    auto text = edit_->CurTextPage()->GetTextPage()->toPlainText();
+    CommonUtils::WaitForTextOpera(
+        this, tr("Symmetrically Encrypting"), text,
+        [this](const OperaWaitingHd& op_hd, const GFBuffer& buffer) {
           GpgFrontend::GpgBasicOperator::GetInstance().EncryptSymmetric(
               buffer, true,
               [this, op_hd](GpgError err, const DataObjectPtr& data_obj) {
@@ -84,7 +84,7 @@ void MainWindow::SlotEncrypt() {
                 process_result_analyse(edit_, info_board_, result_analyse);
 
                 if (CheckGpgError(err) == GPG_ERR_NO_ERROR) {
-                  edit_->SlotFillTextEditWithText(buffer.ConvertToQByteArray());
+                  edit_->SlotFillTextEditWithText(buffer);
                 }
                 info_board_->ResetOptionActionsMenu();
               });
@@ -106,10 +106,10 @@ void MainWindow::SlotEncrypt() {
     }
   }
 
-  auto buffer = GFBuffer(edit_->CurTextPage()->GetTextPage()->toPlainText());
-  CommonUtils::WaitForOpera(
-      this, tr("Encrypting"),
-      [this, keys, buffer](const OperaWaitingHd& op_hd) {
+  auto text = edit_->CurTextPage()->GetTextPage()->toPlainText();
+  CommonUtils::WaitForTextOpera(
+      this, tr("Encrypting"), text,
+      [this, keys](const OperaWaitingHd& op_hd, const GFBuffer& buffer) {
         GpgFrontend::GpgBasicOperator::GetInstance().Encrypt(
             {keys->begin(), keys->end()}, buffer, true,
             [this, op_hd](GpgError err, const DataObjectPtr& data_obj) {
@@ -131,7 +131,7 @@ void MainWindow::SlotEncrypt() {
               process_result_analyse(edit_, info_board_, result_analyse);
 
               if (CheckGpgError(err) == GPG_ERR_NO_ERROR) {
-                edit_->SlotFillTextEditWithText(buffer.ConvertToQByteArray());
+                edit_->SlotFillTextEditWithText(buffer);
               }
               info_board_->ResetOptionActionsMenu();
             });
@@ -163,9 +163,10 @@ void MainWindow::SlotSign() {
   }
 
   // set input buffer
-  auto buffer = GFBuffer(edit_->CurTextPage()->GetTextPage()->toPlainText());
-  CommonUtils::WaitForOpera(
-      this, tr("Signing"), [this, keys, buffer](const OperaWaitingHd& hd) {
+  auto text = edit_->CurTextPage()->GetTextPage()->toPlainText();
+  CommonUtils::WaitForTextOpera(
+      this, tr("Signing"), text,
+      [this, keys](const OperaWaitingHd& hd, const GFBuffer& buffer) {
         GpgFrontend::GpgBasicOperator::GetInstance().Sign(
             {keys->begin(), keys->end()}, buffer, GPGME_SIG_MODE_CLEAR, true,
             [this, hd](GpgError err, const DataObjectPtr& data_obj) {
@@ -185,8 +186,7 @@ void MainWindow::SlotSign() {
               process_result_analyse(edit_, info_board_, result_analyse);
 
               if (CheckGpgError(err) == GPG_ERR_NO_ERROR) {
-                edit_->SlotFillTextEditWithText(
-                    sign_out_buffer.ConvertToQByteArray());
+                edit_->SlotFillTextEditWithText(sign_out_buffer);
               }
             });
       });
@@ -196,10 +196,11 @@ void MainWindow::SlotDecrypt() {
   if (edit_->SlotCurPageTextEdit() == nullptr) return;
 
   // data to transfer into task
-  auto buffer = GFBuffer(edit_->CurTextPage()->GetTextPage()->toPlainText());
+  auto text = edit_->CurTextPage()->GetTextPage()->toPlainText();
 
-  CommonUtils::WaitForOpera(
-      this, tr("Decrypting"), [this, buffer](const OperaWaitingHd& hd) {
+  CommonUtils::WaitForTextOpera(
+      this, tr("Decrypting"), text,
+      [this](const OperaWaitingHd& hd, const GFBuffer& buffer) {
         GpgFrontend::GpgBasicOperator::GetInstance().Decrypt(
             buffer, [this, hd](GpgError err, const DataObjectPtr& data_obj) {
               // stop waiting
@@ -220,8 +221,7 @@ void MainWindow::SlotDecrypt() {
               process_result_analyse(edit_, info_board_, result_analyse);
 
               if (CheckGpgError(err) == GPG_ERR_NO_ERROR) {
-                edit_->SlotFillTextEditWithText(
-                    out_buffer.ConvertToQByteArray());
+                edit_->SlotFillTextEditWithText(out_buffer);
               }
             });
       });
@@ -231,10 +231,11 @@ void MainWindow::SlotVerify() {
   if (edit_->SlotCurPageTextEdit() == nullptr) return;
 
   // set input buffer
-  auto buffer = GFBuffer(edit_->CurTextPage()->GetTextPage()->toPlainText());
+  auto text = edit_->CurTextPage()->GetTextPage()->toPlainText();
 
-  CommonUtils::WaitForOpera(
-      this, tr("Verifying"), [this, buffer](const OperaWaitingHd& hd) {
+  CommonUtils::WaitForTextOpera(
+      this, tr("Verifying"), text,
+      [this](const OperaWaitingHd& hd, const GFBuffer& buffer) {
         GpgFrontend::GpgBasicOperator::GetInstance().Verify(
             buffer, GFBuffer(),
             [this, hd](GpgError err, const DataObjectPtr& data_obj) {
@@ -304,11 +305,12 @@ void MainWindow::SlotEncryptSign() {
   }
 
   // data to transfer into task
-  auto buffer = GFBuffer(edit_->CurTextPage()->GetTextPage()->toPlainText());
+  auto text = edit_->CurTextPage()->GetTextPage()->toPlainText();
 
-  CommonUtils::WaitForOpera(
-      this, tr("Encrypting and Signing"),
-      [this, keys, signer_keys, buffer](const OperaWaitingHd& hd) {
+  CommonUtils::WaitForTextOpera(
+      this, tr("Encrypting and Signing"), text,
+      [this, keys, signer_keys](const OperaWaitingHd& hd,
+                                const GFBuffer& buffer) {
         GpgFrontend::GpgBasicOperator::GetInstance().EncryptSign(
             {keys->begin(), keys->end()},
             {signer_keys->begin(), signer_keys->end()}, buffer, true,
@@ -341,8 +343,7 @@ void MainWindow::SlotEncryptSign() {
                                      sign_result_analyse);
 
               if (CheckGpgError(err) == GPG_ERR_NO_ERROR) {
-                edit_->SlotFillTextEditWithText(
-                    out_buffer.ConvertToQByteArray());
+                edit_->SlotFillTextEditWithText(out_buffer);
               }
             });
       });
@@ -352,11 +353,11 @@ void MainWindow::SlotDecryptVerify() {
   if (edit_->SlotCurPageTextEdit() == nullptr) return;
 
   // data to transfer into task
-  auto buffer = GFBuffer(edit_->CurTextPage()->GetTextPage()->toPlainText());
+  auto text = edit_->CurTextPage()->GetTextPage()->toPlainText();
 
-  CommonUtils::WaitForOpera(
-      this, tr("Decrypting and Verifying"),
-      [this, buffer](const OperaWaitingHd& hd) {
+  CommonUtils::WaitForTextOpera(
+      this, tr("Decrypting and Verifying"), text,
+      [this](const OperaWaitingHd& hd, const GFBuffer& buffer) {
         GpgFrontend::GpgBasicOperator::GetInstance().DecryptVerify(
             buffer, [this, hd](GpgError err, const DataObjectPtr& data_obj) {
               // stop waiting
@@ -388,8 +389,7 @@ void MainWindow::SlotDecryptVerify() {
                                      verify_result_analyse);
 
               if (CheckGpgError(err) == GPG_ERR_NO_ERROR) {
-                edit_->SlotFillTextEditWithText(
-                    out_buffer.ConvertToQByteArray());
+                edit_->SlotFillTextEditWithText(out_buffer);
               }
             });
       });
@@ -378,8 +378,7 @@ void FileTreeView::slot_show_custom_context_menu(const QPoint& point) {
                                        file_info.isWritable());
     action_create_empty_file_->setEnabled(file_info.isDir() &&
                                           file_info.isWritable());
-    action_calculate_hash_->setEnabled(file_info.isFile() &&
-                                       file_info.isReadable());
+    action_calculate_hash_->setEnabled(file_info.isReadable());
   } else {
     action_create_empty_file_->setEnabled(true);
     action_make_directory_->setEnabled(true);
@@ -389,16 +388,18 @@ void FileTreeView::slot_show_custom_context_menu(const QPoint& point) {
 }
 
 void FileTreeView::slot_calculate_hash() {
-  CommonUtils::WaitForOpera(
+  // a directory selection is hashed file by file, in parallel
+  const auto path = this->GetSelectedPath();
+  CommonUtils::WaitForOperaTask(
       this->parentWidget(), tr("Calculating"), [=](const OperaWaitingHd& hd) {
-        RunOperaAsync(
+        return RunOperaAsync(
             [=](const DataObjectPtr& data_object) {
-              data_object->Swap({CalculateHash(this->GetSelectedPath())});
+              data_object->Swap({CalculateHash(path)});
               return 0;
             },
             [hd](int rtn, const DataObjectPtr& data_object) {
               hd();
-              if (rtn < 0 || !data_object->Check<QString>()) {
+              if (rtn != 0 || !data_object->Check<QString>()) {
                 return;
               }
               auto result = ExtractParams<QString>(data_object, 0);
@@ -31,8 +31,11 @@
 #include <cstddef>
 #include <mutex>
 
+#include "core/function/CoreSignalStation.h"
 #include "core/function/GlobalSettingStation.h"
 #include "core/function/gpg/GpgKeyGetter.h"
+#include "core/function/gpg/GpgKeyMetadataStore.h"
+#include "core/model/GpgKeySummaryTable.h"
 #include "ui/UISignalStation.h"
 #include "ui/UserInterfaceUtils.h"
 #include "ui/dialog/import_export/KeyImportDetailDialog.h"
@@ -40,6 +43,17 @@
 
 namespace GpgFrontend::UI {
 
+/**
+ * @brief the rows with a key behind them, the rows shown from the stored
+ * metadata have none until the keys are listed
+ *
+ * @param table
+ * @return int
+ */
+auto KeyTableRowCount(const KeyTable& table) -> int {
+  return static_cast<int>(table.buffered_keys_.size());
+}
+
 KeyList::KeyList(KeyMenuAbility::AbilityType menu_ability, QWidget* parent)
     : QWidget(parent),
       ui_(GpgFrontend::SecureCreateSharedObject<Ui_KeyList>()),
@@ -75,6 +89,12 @@ void KeyList::init() {
   connect(UISignalStation::GetInstance(),
           &UISignalStation::SignalKeyDatabaseRefreshDone, this,
           &KeyList::SlotRefresh);
+  connect(UISignalStation::GetInstance(),
+          &UISignalStation::SignalKeyDatabaseChanged, this,
+          &KeyList::slot_key_database_changed);
+  connect(CoreSignalStation::GetInstance(),
+          &CoreSignalStation::SignalKeyDatabaseLoaded, this,
+          &KeyList::SlotRefresh);
   connect(UISignalStation::GetInstance(), &UISignalStation::SignalUIRefresh,
           this, &KeyList::SlotRefreshUI);
 
@@ -131,7 +151,22 @@ void KeyList::AddListGroupTab(const QString& name, const QString& id,
       QHeaderView::ResizeToContents);
   key_list->verticalHeader()->hide();
   key_list->setShowGrid(false);
-  key_list->sortByColumn(2, Qt::AscendingOrder);
+
+  // KeyTable orders the rows itself, sorting the widget would mix them up
+  // with the buffered keys
+  auto* header = key_list->horizontalHeader();
+  header->setSectionsClickable(true);
+  header->setSortIndicatorShown(true);
+  header->setSortIndicator(2, Qt::AscendingOrder);
+  connect(header, &QHeaderView::sortIndicatorChanged, this, [=]() {
+    // the stored rows wait for the listing, which is ordered anyway
+    if (!GpgKeyGetter::GetInstance().IsKeyCacheLoaded()) return;
+    for (auto& key_table : m_key_tables_) {
+      if (key_table.key_list_ == key_list) {
+        key_table.Refresh(buffered_keys_list_);
+      }
+    }
+  });
   key_list->setSelectionBehavior(QAbstractItemView::SelectRows);
   key_list->setSelectionMode(QAbstractItemView::SingleSelection);
 
@@ -184,6 +219,14 @@ void KeyList::SlotRefresh() {
   ui_->syncButton->setDisabled(true);
 
   emit SignalRefreshStatusBar(tr("Refreshing Key List..."), 3000);
+
+  // the keys are still being listed, or could not be listed. The ui thread
+  // does not wait for them, SignalKeyDatabaseLoaded comes when they are in.
+  if (!GpgKeyGetter::GetInstance().IsKeyCacheLoaded()) {
+    this->slot_refresh_ui();
+    return;
+  }
+
   this->buffered_keys_list_ = GpgKeyGetter::GetInstance().FetchKey();
   this->slot_refresh_ui();
 }
@@ -195,7 +238,7 @@ void KeyList::SlotRefreshUI() {
 
 auto KeyList::GetChecked(const KeyTable& key_table) -> KeyIdArgsListPtr {
   auto ret = std::make_unique<KeyIdArgsList>();
-  for (int i = 0; i < key_table.key_list_->rowCount(); i++) {
+  for (int i = 0; i < KeyTableRowCount(key_table); i++) {
     if (key_table.key_list_->item(i, 0)->checkState() == Qt::Checked) {
       ret->push_back(key_table.buffered_keys_[i].GetId());
     }
@@ -209,7 +252,7 @@ auto KeyList::GetChecked() -> KeyIdArgsListPtr {
   const auto& buffered_keys =
       m_key_tables_[ui_->keyGroupTab->currentIndex()].buffered_keys_;
   auto ret = std::make_unique<KeyIdArgsList>();
-  for (int i = 0; i < key_list->rowCount(); i++) {
+  for (int i = 0; i < static_cast<int>(buffered_keys.size()); i++) {
     if (key_list->item(i, 0)->checkState() == Qt::Checked) {
       ret->push_back(buffered_keys[i].GetId());
     }
@@ -223,7 +266,7 @@ auto KeyList::GetAllPrivateKeys() -> KeyIdArgsListPtr {
   const auto& buffered_keys =
       m_key_tables_[ui_->keyGroupTab->currentIndex()].buffered_keys_;
   auto ret = std::make_unique<KeyIdArgsList>();
-  for (int i = 0; i < key_list->rowCount(); i++) {
+  for (int i = 0; i < static_cast<int>(buffered_keys.size()); i++) {
     if ((key_list->item(i, 1) != nullptr) && buffered_keys[i].IsPrivateKey()) {
       ret->push_back(buffered_keys[i].GetId());
     }
@@ -240,7 +283,7 @@ auto KeyList::GetPrivateChecked() -> KeyIdArgsListPtr {
   const auto& buffered_keys =
       m_key_tables_[ui_->keyGroupTab->currentIndex()].buffered_keys_;
 
-  for (int i = 0; i < key_list->rowCount(); i++) {
+  for (int i = 0; i < static_cast<int>(buffered_keys.size()); i++) {
     if ((key_list->item(i, 0)->checkState() == Qt::Checked) &&
         ((key_list->item(i, 1)) != nullptr)) {
       ret->push_back(buffered_keys[i].GetId());
@@ -252,7 +295,7 @@ auto KeyList::GetPrivateChecked() -> KeyIdArgsListPtr {
 void KeyList::SetChecked(const KeyIdArgsListPtr& keyIds,
                          const KeyTable& key_table) {
   if (!keyIds->empty()) {
-    for (int i = 0; i < key_table.key_list_->rowCount(); i++) {
+    for (int i = 0; i < KeyTableRowCount(key_table); i++) {
       if (std::find(keyIds->begin(), keyIds->end(),
                     key_table.buffered_keys_[i].GetId()) != keyIds->end()) {
         key_table.key_list_->item(i, 0)->setCheckState(Qt::Checked);
@@ -284,7 +327,7 @@ KeyIdArgsListPtr KeyList::GetSelected() {
   const auto& buffered_keys =
       m_key_tables_[ui_->keyGroupTab->currentIndex()].buffered_keys_;
 
-  for (int i = 0; i < key_list->rowCount(); i++) {
+  for (int i = 0; i < static_cast<int>(buffered_keys.size()); i++) {
     if (key_list->item(i, 0)->isSelected()) {
       ret->push_back(buffered_keys[i].GetId());
     }
@@ -417,6 +460,7 @@ void KeyList::slot_double_clicked(const QModelIndex& index) {
   if (ui_->keyGroupTab->size().isEmpty()) return;
   const auto& buffered_keys =
       m_key_tables_[ui_->keyGroupTab->currentIndex()].buffered_keys_;
+  if (index.row() >= static_cast<int>(buffered_keys.size())) return;
   if (m_action_ != nullptr) {
     const auto key =
         GpgKeyGetter::GetInstance().GetKey(buffered_keys[index.row()].GetId());
@@ -434,7 +478,7 @@ auto KeyList::GetSelectedKey() -> QString {
   const auto& buffered_keys =
       m_key_tables_[ui_->keyGroupTab->currentIndex()].buffered_keys_;
 
-  for (int i = 0; i < m_key_list_->rowCount(); i++) {
+  for (int i = 0; i < static_cast<int>(buffered_keys.size()); i++) {
     if (m_key_list_->item(i, 0)->isSelected()) {
       return buffered_keys[i].GetId();
     }
@@ -448,8 +492,14 @@ void KeyList::slot_refresh_ui() {
     std::lock_guard<std::mutex> guard(buffered_key_list_mutex_);
 
     for (auto& key_table : m_key_tables_) {
-      key_table.Refresh(
-          GpgKeyGetter::GetInstance().GetKeysCopy(buffered_keys_list_));
+      key_table.Refresh(buffered_keys_list_);
+    }
+  } else if (!GpgKeyGetter::GetInstance().IsKeyCacheLoaded()) {
+    // what was stored last time, no rows if it is outdated
+    auto metadata_list = GpgKeyMetadataStore::GetInstance().Load().value_or(
+        QList<GpgKeyMetadata>{});
+    for (auto& key_table : m_key_tables_) {
+      key_table.RefreshMetadata(metadata_list);
     }
   }
   emit SignalRefreshStatusBar(tr("Key List Refreshed."), 1000);
@@ -457,10 +507,25 @@ void KeyList::slot_refresh_ui() {
   ui_->syncButton->setDisabled(false);
 }
 
+void KeyList::slot_key_database_changed(const GpgKeyCacheChanges& changes) {
+  GF_UI_LOG_DEBUG("key database changed, added: {}, updated: {}, removed: {}",
+                  changes.added.size(), changes.updated.size(),
+                  changes.removed.size());
+  // the rows are redone as a whole once the keys are listed
+  if (!GpgKeyGetter::GetInstance().IsKeyCacheLoaded()) return;
+  {
+    std::lock_guard<std::mutex> guard(buffered_key_list_mutex_);
+    buffered_keys_list_ = GpgKeyGetter::GetInstance().FetchKey();
+    for (auto& key_table : m_key_tables_) key_table.UpdateKeys(changes);
+  }
+  emit SignalRefreshStatusBar(tr("Key List Refreshed."), 1000);
+}
+
 void KeyList::slot_sync_with_key_server() {
   KeyIdArgsList key_ids;
   {
     std::lock_guard<std::mutex> guard(buffered_key_list_mutex_);
+    if (buffered_keys_list_ == nullptr) return;
     for (const auto& key : *buffered_keys_list_) {
       if (!(key.IsPrivateKey() && key.IsHasMasterKey())) {
         key_ids.push_back(key.GetId());
@@ -539,6 +604,175 @@ void KeyList::check_all() {
   }
 }
 
+/**
+ * @brief whether the keyword is in the stored fields of a key, the keyword
+ * index only exists once the keys are listed
+ *
+ * @param metadata
+ * @param keyword in lower case
+ * @return true
+ * @return false
+ */
+auto IsKeywordInMetadata(const GpgKeyMetadata& metadata,
+                         const QString& keyword) -> bool {
+  for (const auto* field : {&metadata.name, &metadata.email, &metadata.comment,
+                            &metadata.id, &metadata.fingerprint}) {
+    if (field->toLower().contains(keyword)) return true;
+  }
+  return false;
+}
+
+auto IsKeyShownInTable(const KeyTable& table,
+                       const GpgKeySummaryTable& summary, int row) -> bool {
+  // filter by search bar's keyword
+  if (table.ability_ & KeyMenuAbility::SEARCH_BAR &&
+      !table.keyword_.isEmpty()) {
+    if (!table.keyword_matches_.contains(summary.GetFingerprint(row))) {
+      return false;
+    }
+  }
+
+  if (table.filter_ != nullptr && !table.filter_(summary.GetKey(row), table)) {
+    return false;
+  }
+
+  return table.select_type_ != KeyListRow::ONLY_SECRET_KEY ||
+         summary.Has(row, GpgKeyMetadata::kPrivateKey);
+}
+
+/**
+ * @brief the summary column a key table column sorts by, the columns
+ * without one keep the order of the listing
+ *
+ * @param section
+ * @return GpgKeySummaryTable::Column
+ */
+auto GetKeySummaryColumn(int section) -> GpgKeySummaryTable::Column {
+  switch (section) {
+    case 2:
+      return GpgKeySummaryTable::kName;
+    case 3:
+      return GpgKeySummaryTable::kEmail;
+    case 5:
+      return GpgKeySummaryTable::kOwnerTrust;
+    case 6:
+      return GpgKeySummaryTable::kKeyId;
+    case 7:
+      return GpgKeySummaryTable::kFingerprint;
+    default:
+      return GpgKeySummaryTable::kListing;
+  }
+}
+
+/**
+ * @brief compare two rows of a summary table as
+ * GpgKeySummaryTable::SortedRows() does
+ *
+ * @param summary
+ * @param a
+ * @param b
+ * @param column
+ * @return int less than, equal to or greater than zero
+ */
+auto CompareKeyRows(const GpgKeySummaryTable& summary, int a, int b,
+                    GpgKeySummaryTable::Column column) -> int {
+  switch (column) {
+    case GpgKeySummaryTable::kName:
+      return summary.GetName(a).compare(summary.GetName(b),
+                                        Qt::CaseInsensitive);
+    case GpgKeySummaryTable::kEmail:
+      return summary.GetEmail(a).compare(summary.GetEmail(b),
+                                         Qt::CaseInsensitive);
+    case GpgKeySummaryTable::kKeyId:
+      return summary.GetId(a).compare(summary.GetId(b), Qt::CaseInsensitive);
+    case GpgKeySummaryTable::kFingerprint:
+      return summary.GetFingerprint(a).compare(summary.GetFingerprint(b),
+                                               Qt::CaseInsensitive);
+    case GpgKeySummaryTable::kOwnerTrust:
+      return summary.GetOwnerTrustLevel(a) - summary.GetOwnerTrustLevel(b);
+    case GpgKeySummaryTable::kCreateTime:
+      return (summary.GetCreateTime(a) > summary.GetCreateTime(b)) -
+             (summary.GetCreateTime(a) < summary.GetCreateTime(b));
+    case GpgKeySummaryTable::kExpireTime:
+      return (summary.GetExpireTime(a) > summary.GetExpireTime(b)) -
+             (summary.GetExpireTime(a) < summary.GetExpireTime(b));
+    case GpgKeySummaryTable::kListing:
+    default:
+      return 0;
+  }
+}
+
+void SetKeyTableRow(KeyTable& table, int row_index,
+                    const GpgKeyMetadata& key) {
+  auto* key_list = table.key_list_;
+
+  auto* tmp0 = new QTableWidgetItem(QString::number(row_index));
+  tmp0->setFlags(Qt::ItemIsUserCheckable | Qt::ItemIsEnabled |
+                 Qt::ItemIsSelectable);
+  tmp0->setTextAlignment(Qt::AlignCenter);
+  tmp0->setCheckState(Qt::Unchecked);
+  key_list->setItem(row_index, 0, tmp0);
+
+  QString type_str;
+  QTextStream type_steam(&type_str);
+  if (key.Has(GpgKeyMetadata::kPrivateKey)) {
+    type_steam << "pub/sec";
+  } else {
+    type_steam << "pub";
+  }
+
+  if (key.Has(GpgKeyMetadata::kPrivateKey) &&
+      !key.Has(GpgKeyMetadata::kHasMasterKey)) {
+    type_steam << "#";
+  }
+
+  if (key.Has(GpgKeyMetadata::kHasCardKey)) {
+    type_steam << "^";
+  }
+
+  auto* tmp1 = new QTableWidgetItem(type_str);
+  key_list->setItem(row_index, 1, tmp1);
+
+  auto* tmp2 = new QTableWidgetItem(key.name);
+  key_list->setItem(row_index, 2, tmp2);
+  auto* tmp3 = new QTableWidgetItem(key.email);
+  key_list->setItem(row_index, 3, tmp3);
+
+  auto* temp_usage = new QTableWidgetItem(key.GetUsage());
+  temp_usage->setTextAlignment(Qt::AlignCenter);
+  key_list->setItem(row_index, 4, temp_usage);
+
+  auto* temp_validity = new QTableWidgetItem(key.owner_trust);
+  temp_validity->setTextAlignment(Qt::AlignCenter);
+  key_list->setItem(row_index, 5, temp_validity);
+
+  auto* temp_id = new QTableWidgetItem(key.id);
+  temp_id->setTextAlignment(Qt::AlignCenter);
+  key_list->setItem(row_index, 6, temp_id);
+
+  auto* temp_fpr = new QTableWidgetItem(key.fingerprint);
+  temp_fpr->setTextAlignment(Qt::AlignCenter);
+  key_list->setItem(row_index, 7, temp_fpr);
+
+  QFont font = tmp2->font();
+
+  // strike out expired keys
+  if (key.Has(GpgKeyMetadata::kExpired) ||
+      key.Has(GpgKeyMetadata::kRevoked)) {
+    font.setStrikeOut(true);
+  }
+  if (key.Has(GpgKeyMetadata::kPrivateKey)) font.setBold(true);
+
+  tmp0->setFont(font);
+  temp_usage->setFont(font);
+  temp_fpr->setFont(font);
+  temp_validity->setFont(font);
+  tmp1->setFont(font);
+  tmp2->setFont(font);
+  tmp3->setFont(font);
+  temp_id->setFont(font);
+}
+
 KeyIdArgsListPtr& KeyTable::GetChecked() {
   if (checked_key_ids_ == nullptr) {
     checked_key_ids_ = std::make_unique<KeyIdArgsList>();
@@ -558,152 +792,178 @@ void KeyTable::SetChecked(KeyIdArgsListPtr key_ids) {
   checked_key_ids_ = std::move(key_ids);
 }
 
-void KeyTable::Refresh(KeyLinkListPtr m_keys) {
+void KeyTable::Refresh(KeyListSnapshotPtr keys) {
   auto& checked_key_list = GetChecked();
   // while filling the table, sort enabled causes errors
 
   key_list_->setSortingEnabled(false);
   key_list_->clearContents();
 
-  // Optimization for copy
-  KeyLinkListPtr keys = nullptr;
-  if (m_keys == nullptr) {
-    keys = GpgKeyGetter::GetInstance().FetchKey();
-  } else {
-    keys = std::move(m_keys);
+  // the snapshot is shared and immutable, so only pick the rows to show
+  if (keys == nullptr) keys = GpgKeyGetter::GetInstance().FetchKey();
+  update_keyword_matches();
+
+  // rows are taken from the summary of the snapshot, ordered as the header
+  // says since the widget itself does not sort
+  auto summary = GpgKeyGetter::GetInstance().GetKeySummary(keys);
+  const auto* header = key_list_->horizontalHeader();
+  const auto rows =
+      summary->SortedRows(GetKeySummaryColumn(header->sortIndicatorSection()),
+                          header->sortIndicatorOrder());
+
+  QVector<int> shown_rows;
+  shown_rows.reserve(rows.size());
+  for (auto row : rows) {
+    if (IsKeyShownInTable(*this, *summary, row)) shown_rows.push_back(row);
   }
 
-  auto it = keys->begin();
-  int row_count = 0;
+  key_list_->setRowCount(static_cast<int>(shown_rows.size()));
 
-  while (it != keys->end()) {
-    // filter by search bar's keyword
-    if (ability_ & KeyMenuAbility::SEARCH_BAR && !keyword_.isEmpty()) {
-      QStringList infos;
-      infos << it->GetName().toLower() << it->GetEmail().toLower()
-            << it->GetComment().toLower() << it->GetFingerprint().toLower();
+  buffered_keys_.clear();
+  buffered_keys_.reserve(shown_rows.size());
 
-      auto subkeys = it->GetSubKeys();
-      for (const auto& subkey : *subkeys) {
-        infos << subkey.GetFingerprint().toLower() << subkey.GetID().toLower();
-      }
+  int row_index = 0;
+  for (auto row : shown_rows) {
+    SetKeyTableRow(*this, row_index, summary->GetMetadata(row));
+    buffered_keys_.push_back(summary->GetKey(row));
+    ++row_index;
+  }
 
-      if (infos.filter(keyword_.toLower()).isEmpty()) {
-        it = keys->erase(it);
-        continue;
+  if (!checked_key_list->empty()) {
+    for (int i = 0; i < key_list_->rowCount(); i++) {
+      const auto& key_id = summary->GetId(shown_rows[i]);
+      if (std::find(checked_key_list->begin(), checked_key_list->end(),
+                    key_id) != checked_key_list->end()) {
+        key_list_->item(i, 0)->setCheckState(Qt::Checked);
       }
     }
+  }
+}
 
-    if (filter_ != nullptr) {
-      if (!filter_(*it, *this)) {
-        it = keys->erase(it);
+void KeyTable::RefreshMetadata(const QList<GpgKeyMetadata>& metadata_list) {
+  key_list_->setSortingEnabled(false);
+  key_list_->clearContents();
+  buffered_keys_.clear();
+
+  // the other filters need the keys, those tables wait for the listing
+  std::vector<const GpgKeyMetadata*> shown;
+  if (filter_ == nullptr) {
+    const auto filter_by_keyword =
+        (ability_ & KeyMenuAbility::SEARCH_BAR) && !keyword_.isEmpty();
+    for (const auto& metadata : metadata_list) {
+      if (select_type_ == KeyListRow::ONLY_SECRET_KEY &&
+          !metadata.Has(GpgKeyMetadata::kPrivateKey)) {
         continue;
       }
+      if (filter_by_keyword && !IsKeywordInMetadata(metadata, keyword_)) {
+        continue;
+      }
+      shown.push_back(&metadata);
     }
-
-    if (select_type_ == KeyListRow::ONLY_SECRET_KEY && !it->IsPrivateKey()) {
-      it = keys->erase(it);
-      continue;
-    }
-    row_count++;
-    it++;
   }
 
-  key_list_->setRowCount(row_count);
-
-  int row_index = 0;
-  it = keys->begin();
-
-  buffered_keys_.clear();
-
-  while (it != keys->end()) {
-    auto* tmp0 = new QTableWidgetItem(QString::number(row_index));
-    tmp0->setFlags(Qt::ItemIsUserCheckable | Qt::ItemIsEnabled |
-                   Qt::ItemIsSelectable);
-    tmp0->setTextAlignment(Qt::AlignCenter);
-    tmp0->setCheckState(Qt::Unchecked);
-    key_list_->setItem(row_index, 0, tmp0);
-
-    QString type_str;
-    QTextStream type_steam(&type_str);
-    if (it->IsPrivateKey()) {
-      type_steam << "pub/sec";
-    } else {
-      type_steam << "pub";
-    }
+  key_list_->setRowCount(static_cast<int>(shown.size()));
+  for (int row = 0; row < static_cast<int>(shown.size()); row++) {
+    SetKeyTableRow(*this, row, *shown[row]);
+  }
+}
 
-    if (it->IsPrivateKey() && !it->IsHasMasterKey()) {
-      type_steam << "#";
-    }
+void KeyTable::UpdateKeys(const GpgKeyCacheChanges& changes) {
+  // moving rows one by one only pays off for a few keys, once a tenth of
+  // the table changes the rows are redone as a whole
+  const auto changed =
+      changes.added.size() + changes.updated.size() + changes.removed.size();
+  if (changed * 10 > static_cast<qsizetype>(buffered_keys_.size())) {
+    Refresh(GpgKeyGetter::GetInstance().FetchKey());
+    return;
+  }
 
-    if (it->IsHasCardKey()) {
-      type_steam << "^";
+  // while changing the rows, sort enabled causes errors
+  key_list_->setSortingEnabled(false);
+  update_keyword_matches();
+
+  // in the order of the listing an updated key keeps its row, in any other
+  // order it is taken out and put back where it belongs now
+  const auto section = key_list_->horizontalHeader()->sortIndicatorSection();
+  const auto sorted =
+      GetKeySummaryColumn(section) != GpgKeySummaryTable::kListing;
+
+  // the summary was taken when the keys were published, the rows are
+  // filled and placed from it
+  auto& getter = GpgKeyGetter::GetInstance();
+  const auto summary = getter.GetKeySummary(getter.FetchKey());
+
+  const auto removed =
+      QSet<QString>(changes.removed.begin(), changes.removed.end());
+  const auto updated =
+      QSet<QString>(changes.updated.begin(), changes.updated.end());
+
+  QSet<QString> shown;
+  QHash<QString, Qt::CheckState> check_states;
+  for (int row = static_cast<int>(buffered_keys_.size()) - 1; row >= 0;
+       row--) {
+    const auto fpr = buffered_keys_[row].GetFingerprint();
+    const auto is_updated = updated.contains(fpr);
+    if (!is_updated && !removed.contains(fpr)) continue;
+
+    const auto check_state = key_list_->item(row, 0)->checkState();
+    const auto summary_row = is_updated && !sorted ? summary->IndexOf(fpr) : -1;
+    if (summary_row >= 0 && IsKeyShownInTable(*this, *summary, summary_row)) {
+      SetKeyTableRow(*this, row, summary->GetMetadata(summary_row));
+      key_list_->item(row, 0)->setCheckState(check_state);
+      buffered_keys_[row] = summary->GetKey(summary_row);
+      shown.insert(fpr);
+      continue;
     }
 
-    auto* tmp1 = new QTableWidgetItem(type_str);
-    key_list_->setItem(row_index, 1, tmp1);
-
-    auto* tmp2 = new QTableWidgetItem(it->GetName());
-    key_list_->setItem(row_index, 2, tmp2);
-    auto* tmp3 = new QTableWidgetItem(it->GetEmail());
-    key_list_->setItem(row_index, 3, tmp3);
-
-    QString usage;
-    QTextStream usage_steam(&usage);
-
-    if (it->IsHasActualCertificationCapability()) usage_steam << "C";
-    if (it->IsHasActualEncryptionCapability()) usage_steam << "E";
-    if (it->IsHasActualSigningCapability()) usage_steam << "S";
-    if (it->IsHasActualAuthenticationCapability()) usage_steam << "A";
-
-    auto* temp_usage = new QTableWidgetItem(usage);
-    temp_usage->setTextAlignment(Qt::AlignCenter);
-    key_list_->setItem(row_index, 4, temp_usage);
-
-    auto* temp_validity = new QTableWidgetItem(it->GetOwnerTrust());
-    temp_validity->setTextAlignment(Qt::AlignCenter);
-    key_list_->setItem(row_index, 5, temp_validity);
-
-    auto* temp_id = new QTableWidgetItem(it->GetId());
-    temp_id->setTextAlignment(Qt::AlignCenter);
-    key_list_->setItem(row_index, 6, temp_id);
-
-    auto* temp_fpr = new QTableWidgetItem(it->GetFingerprint());
-    temp_fpr->setTextAlignment(Qt::AlignCenter);
-    key_list_->setItem(row_index, 7, temp_fpr);
-
-    QFont font = tmp2->font();
-
-    // strike out expired keys
-    if (it->IsExpired() || it->IsRevoked()) font.setStrikeOut(true);
-    if (it->IsPrivateKey()) font.setBold(true);
+    check_states.insert(fpr, check_state);
+    key_list_->removeRow(row);
+    buffered_keys_.erase(buffered_keys_.begin() + row);
+  }
 
-    tmp0->setFont(font);
-    temp_usage->setFont(font);
-    temp_fpr->setFont(font);
-    temp_validity->setFont(font);
-    tmp1->setFont(font);
-    tmp2->setFont(font);
-    tmp3->setFont(font);
-    temp_id->setFont(font);
+  // keys new to this table, an updated key may pass the filters now
+  for (const auto& fpr : changes.added + changes.updated) {
+    if (shown.contains(fpr)) continue;
 
-    // move to buffered keys
-    buffered_keys_.emplace_back(std::move(*it));
+    const auto summary_row = summary->IndexOf(fpr);
+    if (summary_row < 0 || !IsKeyShownInTable(*this, *summary, summary_row)) {
+      continue;
+    }
 
-    it++;
-    ++row_index;
+    const auto row = sorted_row_of(*summary, summary_row);
+    key_list_->insertRow(row);
+    SetKeyTableRow(*this, row, summary->GetMetadata(summary_row));
+    key_list_->item(row, 0)->setCheckState(
+        check_states.value(fpr, Qt::Unchecked));
+    buffered_keys_.insert(buffered_keys_.begin() + row,
+                          summary->GetKey(summary_row));
+    shown.insert(fpr);
   }
 
-  if (!checked_key_list->empty()) {
-    for (int i = 0; i < key_list_->rowCount(); i++) {
-      if (std::find(checked_key_list->begin(), checked_key_list->end(),
-                    buffered_keys_[i].GetId()) != checked_key_list->end()) {
-        key_list_->item(i, 0)->setCheckState(Qt::Checked);
-      }
-    }
+  for (int row = 0; row < key_list_->rowCount(); row++) {
+    key_list_->item(row, 0)->setText(QString::number(row));
   }
 }
 
+auto KeyTable::sorted_row_of(const GpgKeySummaryTable& summary,
+                             int summary_row) const -> int {
+  const auto* header = key_list_->horizontalHeader();
+  const auto column = GetKeySummaryColumn(header->sortIndicatorSection());
+  const auto rows = static_cast<int>(buffered_keys_.size());
+  if (column == GpgKeySummaryTable::kListing) return rows;
+
+  // the shown keys are all in the summary, the removed ones are gone
+  const auto sign = header->sortIndicatorOrder() == Qt::AscendingOrder ? 1 : -1;
+  auto it = std::upper_bound(
+      buffered_keys_.begin(), buffered_keys_.end(), summary_row,
+      [&summary, column, sign](int row, const GpgKey& key) {
+        const auto key_row = summary.IndexOf(key.GetFingerprint());
+        if (key_row < 0) return false;
+        return sign * CompareKeyRows(summary, row, key_row, column) < 0;
+      });
+  return static_cast<int>(it - buffered_keys_.begin());
+}
+
 void KeyTable::UncheckALL() const {
   for (int i = 0; i < key_list_->rowCount(); i++) {
     key_list_->item(i, 0)->setCheckState(Qt::Unchecked);
@@ -720,6 +980,14 @@ void KeyTable::SetMenuAbility(KeyMenuAbility::AbilityType ability) {
   this->ability_ = ability;
 }
 
+void KeyTable::update_keyword_matches() {
+  keyword_matches_.clear();
+  if (!(ability_ & KeyMenuAbility::SEARCH_BAR) || keyword_.isEmpty()) return;
+
+  // one lookup in the keyword index instead of matching every key
+  keyword_matches_ = GpgKeyGetter::GetInstance().SearchKeys(keyword_);
+}
+
 void KeyTable::SetFilterKeyword(QString keyword) {
   this->keyword_ = std::move(keyword);
 }
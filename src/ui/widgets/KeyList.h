@@ -28,7 +28,9 @@
 
 #pragma once
 
+#include "core/function/gpg/GpgKeyGetter.h"
 #include "core/model/GpgKey.h"
+#include "core/model/GpgKeyMetadata.h"
 
 class Ui_KeyList;
 
@@ -93,6 +95,7 @@ struct KeyTable {
   KeyIdArgsListPtr checked_key_ids_;     ///<
   KeyMenuAbility::AbilityType ability_;  ///<
   QString keyword_;                      ///<
+  QSet<QString> keyword_matches_;        ///< keys containing the keyword
 
   /**
    * @brief Construct a new Key Table object
@@ -116,9 +119,25 @@ struct KeyTable {
   /**
    * @brief
    *
-   * @param m_keys
+   * @param keys
    */
-  void Refresh(KeyLinkListPtr m_keys = nullptr);
+  void Refresh(KeyListSnapshotPtr keys = nullptr);
+
+  /**
+   * @brief show the stored metadata of the keys until they are listed, the
+   * rows have no keys behind them
+   *
+   * @param metadata_list
+   */
+  void RefreshMetadata(const QList<GpgKeyMetadata>& metadata_list);
+
+  /**
+   * @brief patch only the rows of the changed keys, the keys are taken
+   * from the key cache
+   *
+   * @param changes
+   */
+  void UpdateKeys(const GpgKeyCacheChanges& changes);
 
   /**
    * @brief Get the Checked object
@@ -157,6 +176,24 @@ struct KeyTable {
    *
    */
   void SetFilterKeyword(QString keyword);
+
+ private:
+  /**
+   * @brief look up the keys containing the keyword of the search bar
+   *
+   */
+  void update_keyword_matches();
+
+  /**
+   * @brief the row a key goes to in the order of the header's sort
+   * indicator, after the rows comparing equal
+   *
+   * @param summary the summary of the listing the key is taken from
+   * @param summary_row the row of the key in the summary
+   * @return int
+   */
+  [[nodiscard]] auto sorted_row_of(const GpgKeySummaryTable& summary,
+                                   int summary_row) const -> int;
 };
 
 /**
@@ -354,7 +391,7 @@ class KeyList : public QWidget {
   QTableWidget* m_key_list_{};                                       ///<
   std::vector<KeyTable> m_key_tables_;                               ///<
   QMenu* popup_menu_{};                                              ///<
-  GpgFrontend::KeyLinkListPtr buffered_keys_list_;                   ///<
+  GpgFrontend::KeyListSnapshotPtr buffered_keys_list_;               ///<
   std::function<void(const GpgKey&, QWidget*)> m_action_ = nullptr;  ///<
   KeyMenuAbility::AbilityType menu_ability_ = KeyMenuAbility::ALL;   ///<
 
@@ -373,6 +410,13 @@ class KeyList : public QWidget {
    */
   void slot_refresh_ui();
 
+  /**
+   * @brief update the rows of the keys a targeted refresh touched
+   *
+   * @param changes
+   */
+  void slot_key_database_changed(const GpgKeyCacheChanges& changes);
+
   /**
    * @brief
    *
@@ -39,6 +39,63 @@
 
 namespace GpgFrontend::UI {
 
+namespace {
+
+constexpr size_t kFillTextPieceSize = 1024 * 1024;
+constexpr const char* kFillGenerationProperty = "GFFillGeneration";
+
+/**
+ * @brief start a new fill of the page, the pieces of an earlier one still
+ * pending are dropped
+ *
+ */
+auto NextFillGeneration(QPlainTextEdit* text_page) -> quint64 {
+  const auto generation =
+      text_page->property(kFillGenerationProperty).toULongLong() + 1;
+  text_page->setProperty(kFillGenerationProperty, generation);
+  return generation;
+}
+
+/**
+ * @brief append the UTF-8 text from offset to the page, one piece per event
+ * loop turn, the pieces share one undo step, the view keeps the pooled
+ * storage alive so no unwiped copy of the whole text is made
+ *
+ */
+void InsertTextPieces(const QPointer<QPlainTextEdit>& text_page,
+                      const GFBufferView& text, size_t offset,
+                      quint64 generation) {
+  if (text_page == nullptr) return;
+  if (text_page->property(kFillGenerationProperty).toULongLong() !=
+      generation) {
+    return;
+  }
+
+  // don't split a UTF-8 sequence
+  const auto* data = text.Data();
+  auto end = std::min(offset + kFillTextPieceSize, text.Size());
+  while (end < text.Size() && (static_cast<uchar>(data[end]) & 0xC0) == 0x80) {
+    end++;
+  }
+
+  QTextCursor cursor(text_page->document());
+  cursor.movePosition(QTextCursor::End);
+  cursor.joinPreviousEditBlock();
+  cursor.insertText(QString::fromUtf8(data + offset,
+                                      static_cast<qsizetype>(end - offset)));
+  cursor.endEditBlock();
+
+  if (end >= text.Size()) {
+    text_page->setReadOnly(false);
+    return;
+  }
+  QTimer::singleShot(0, text_page, [text_page, text, end, generation]() {
+    InsertTextPieces(text_page, text, end, generation);
+  });
+}
+
+}  // namespace
+
 TextEdit::TextEdit(QWidget* parent) : QWidget(parent) {
   count_page_ = 0;
   tab_widget_ = new QTabWidget(this);
@@ -408,13 +465,37 @@ void TextEdit::SlotQuote() const {
 }
 
 void TextEdit::SlotFillTextEditWithText(const QString& text) const {
-  QTextCursor cursor(CurTextPage()->GetTextPage()->document());
+  auto* text_page = CurTextPage()->GetTextPage();
+  NextFillGeneration(text_page);
+  text_page->setReadOnly(false);
+
+  QTextCursor cursor(text_page->document());
   cursor.beginEditBlock();
   this->CurTextPage()->GetTextPage()->selectAll();
   this->CurTextPage()->GetTextPage()->insertPlainText(text);
   cursor.endEditBlock();
 }
 
+void TextEdit::SlotFillTextEditWithText(const GFBuffer& buffer) const {
+  if (buffer.Size() <= kFillTextPieceSize) {
+    SlotFillTextEditWithText(QString::fromUtf8(
+        buffer.Data(), static_cast<qsizetype>(buffer.Size())));
+    return;
+  }
+
+  auto* text_page = CurTextPage()->GetTextPage();
+  const auto generation = NextFillGeneration(text_page);
+  text_page->setReadOnly(true);
+
+  QTextCursor cursor(text_page->document());
+  cursor.beginEditBlock();
+  cursor.select(QTextCursor::Document);
+  cursor.removeSelectedText();
+  cursor.endEditBlock();
+
+  InsertTextPieces(text_page, buffer.View(), 0, generation);
+}
+
 void TextEdit::LoadFile(const QString& fileName) {
   QFile file(fileName);
   if (!file.open(QFile::ReadOnly | QFile::Text)) {
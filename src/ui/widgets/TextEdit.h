@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include "core/model/GFBuffer.h"
 #include "ui/dialog/QuitDialog.h"
 #include "ui/widgets/FilePage.h"
 #include "ui/widgets/HelpPage.h"
@@ -116,6 +117,13 @@ class TextEdit : public QWidget {
    */
   void SlotFillTextEditWithText(const QString& text) const;
 
+  /**
+   * @details replace the text of currently active textedit with UTF-8 text,
+   * a large text is decoded and inserted piece by piece between events.
+   * @param buffer to fill on.
+   */
+  void SlotFillTextEditWithText(const GFBuffer& buffer) const;
+
   /**
    * @details Saves the content of the current tab, if it has a filepath
    * otherwise it calls saveAs for the current tab